@@ -0,0 +1,192 @@
+/***************************************************************************
+
+ Resident catalog of initialised propagators, reloaded while in use
+
+***************************************************************************/
+#undef UNICODE
+
+#include <algorithm>
+#include "CatalogManager.h"
+#include "TLEStream.h"
+
+
+int stCatalogSnapshot::Find( int nNORADID ) const
+{
+	std::vector<int>::const_iterator pID = std::lower_bound( vnIDs.begin(), vnIDs.end(), nNORADID );
+
+	if( pID == vnIDs.end() || *pID != nNORADID ) return -1;
+
+	return (int) ( pID - vnIDs.begin() );
+}
+
+
+const cTLE2PosVel *stCatalogSnapshot::GetPropagator( int nNORADID ) const
+{
+	int i = Find( nNORADID );
+
+	return i < 0 ? NULL : vpPropagators[ i ].get();
+}
+
+
+cCatalogManager::cCatalogManager()
+{
+
+}
+
+
+cCatalogManager::~cCatalogManager()
+{
+
+}
+
+
+int cCatalogManager::GetCount( int stCatalogSnapshot::*pnCount ) const
+{
+	std::shared_ptr<const stCatalogSnapshot> pSnapshot = m_pSnapshot.load();
+
+	return pSnapshot != NULL ? ( *pSnapshot ).*pnCount : 0;
+}
+
+
+unsigned long long cCatalogManager::HashLines( const stTLERecord &tRecord )
+{
+	unsigned long long nHash = 14695981039346656037ull;
+
+	for( int i = 0; i < 69; i++ ) nHash = ( nHash ^ (unsigned char) tRecord.pLine1[ i ] ) * 1099511628211ull;
+	for( int i = 0; i < 69; i++ ) nHash = ( nHash ^ (unsigned char) tRecord.pLine2[ i ] ) * 1099511628211ull;
+
+	return nHash;
+}
+
+
+bool cCatalogManager::Reload( const char *szTLEFile, const cTLEFilter *pFilter )
+{
+	if( cTLEStream::IsStreamName( szTLEFile ) )
+	{
+		cTLEStream tStream;
+		if( !tStream.Open( szTLEFile ) ) return false;
+
+		// decompressed into memory, the records are compared once all are read
+		std::vector<char> vText, vBlock;
+		while( tStream.Read( vBlock ) ) vText.insert( vText.end(), vBlock.begin(), vBlock.end() );
+
+		if( !tStream.Close() ) return false;
+
+		return Reload( vText.data(), vText.data() + vText.size(), pFilter );
+	}
+
+	cMappedFile tFile;
+	if( !tFile.Open( szTLEFile ) ) return false;
+
+	return Reload( tFile.GetData(), tFile.GetData() + tFile.GetSize(), pFilter );
+}
+
+/******************************************************************************************
+
+  Parse the text, keep the newest set of each satellite, and walk it along the resident
+  catalog: a satellite with the same line hash keeps its propagator, the others get a
+  new one initialised. The new snapshot replaces the resident one in a single store.
+
+  A truncated or damaged file must not empty the catalog of the readers: the reload is
+  rejected if the parser reports any error or no satellite is left.
+
+*******************************************************************************************/
+
+bool cCatalogManager::Reload( const char *pBegin, const char *pEnd, const cTLEFilter *pFilter )
+{
+	std::lock_guard<std::mutex> tLock( m_tReloadMutex );
+
+	struct stEntry
+	{
+		stSatelliteElements tElements;
+		unsigned long long nHash;
+	};
+
+	std::vector<stEntry> vtEntries;
+
+	cTLEParser tParser;
+	stTLERecord tRecord;
+	stEntry tEntry;
+
+	for( const char *pText = pBegin; ( pText = tParser.NextRecord( pText, pEnd, tRecord ) ) != NULL; )
+	{
+		if( pFilter != NULL && !pFilter->Accept( tRecord ) ) continue;
+		if( !tParser.DecodeRecord( tRecord, tEntry.tElements ) ) return false;
+
+		tEntry.nHash = HashLines( tRecord );
+		vtEntries.push_back( tEntry );
+	}
+
+	if( tParser.GetChecksumErrors() > 0 || tParser.GetFormatErrors() > 0 ) return false;
+
+	std::stable_sort( vtEntries.begin(), vtEntries.end(),
+					  []( const stEntry &a, const stEntry &b )
+					  {
+						  if( a.tElements.nSatelliteID != b.tElements.nSatelliteID )
+						  {
+							  return a.tElements.nSatelliteID < b.tElements.nSatelliteID;
+						  }
+						  return a.tElements.GetRefJD() < b.tElements.GetRefJD();
+					  } );
+
+	std::shared_ptr<const stCatalogSnapshot> pOld = m_pSnapshot.load();
+	std::shared_ptr<stCatalogSnapshot> pNew = std::make_shared<stCatalogSnapshot>();
+
+	pNew->nVersion = pOld != NULL ? pOld->nVersion + 1 : 1;
+	pNew->nAdded = pNew->nChanged = pNew->nRemoved = pNew->nUnchanged = pNew->nFailed = 0;
+
+	int nOld = pOld != NULL ? pOld->GetSatelliteNumber() : 0, j = 0;
+
+	for( size_t i = 0; i < vtEntries.size(); i++ )
+	{
+		// the newest set of the satellite only
+		if( i + 1 < vtEntries.size() &&
+			vtEntries[ i + 1 ].tElements.nSatelliteID == vtEntries[ i ].tElements.nSatelliteID ) continue;
+
+		const stEntry &tNew = vtEntries[ i ];
+		int nID = tNew.tElements.nSatelliteID;
+
+		while( j < nOld && pOld->vnIDs[ j ] < nID )
+		{
+			pNew->nRemoved++;
+			j++;
+		}
+
+		bool bKnown = j < nOld && pOld->vnIDs[ j ] == nID;
+		std::shared_ptr<const cTLE2PosVel> pPropagator;
+
+		if( bKnown && pOld->vnLineHash[ j ] == tNew.nHash )
+		{
+			pPropagator = pOld->vpPropagators[ j ];
+			pNew->nUnchanged++;
+		}
+		else
+		{
+			std::shared_ptr<cTLE2PosVel> pSat = std::make_shared<cTLE2PosVel>();
+
+			if( pSat->SetOrbitalElements( tNew.tElements ) )
+			{
+				pPropagator = pSat;
+				if( bKnown ) pNew->nChanged++;
+				else pNew->nAdded++;
+			}
+			else pNew->nFailed++;
+		}
+
+		if( bKnown ) j++;
+		if( pPropagator == NULL ) continue;
+
+		pNew->vnIDs.push_back( nID );
+		pNew->vtElements.push_back( tNew.tElements );
+		pNew->vnLineHash.push_back( tNew.nHash );
+		pNew->vpPropagators.push_back( pPropagator );
+	}
+
+	pNew->nRemoved += nOld - j;
+
+	if( pNew->GetSatelliteNumber() == 0 ) return false;
+
+	m_pSnapshot.store( pNew );
+
+	return true;
+}
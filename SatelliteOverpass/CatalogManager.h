@@ -0,0 +1,86 @@
+/***************************************************************************
+
+ Resident catalog of initialised propagators, reloaded while in use
+
+ A reload parses the new TLE file and compares it with the resident
+ catalog by NORAD ID and by a hash of line 1 and line 2: only the new and
+ changed satellites get a new propagator, the unchanged ones share theirs
+ with the previous catalog. The new catalog is then published as a whole,
+ the readers keep the snapshot they hold until they ask for the next one,
+ and a snapshot is freed with its last reader (read-copy-update).
+
+ A snapshot and its propagators are never changed once published, so any
+ number of threads may propagate from it, each with its own
+ stSGP4WorkArea.
+
+***************************************************************************/
+#pragma once
+
+#include "TLE2PosVel.h"
+#include "TLEFilter.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/***************************************************************************
+
+ Published catalog, one element set per satellite in increasing NORAD ID
+
+***************************************************************************/
+
+struct stCatalogSnapshot
+{
+	int nVersion;
+
+	std::vector<int> vnIDs;
+	std::vector<stSatelliteElements> vtElements;
+	std::vector<unsigned long long> vnLineHash;
+	std::vector< std::shared_ptr<const cTLE2PosVel> > vpPropagators;
+
+	// counts of the reload which published the snapshot
+	int nAdded, nChanged, nRemoved, nUnchanged, nFailed;
+
+	int GetSatelliteNumber() const { return (int) vnIDs.size(); }
+
+	// index of the satellite, -1 if not found
+	int Find( int nNORADID ) const;
+
+	// propagator of the satellite, NULL if not found
+	const cTLE2PosVel *GetPropagator( int nNORADID ) const;
+};
+
+
+class cCatalogManager
+{
+	std::atomic< std::shared_ptr<const stCatalogSnapshot> > m_pSnapshot;
+	std::mutex m_tReloadMutex;		// one reload at a time
+
+	// count of the current snapshot, 0 before the first reload
+	int GetCount( int stCatalogSnapshot::*pnCount ) const;
+
+public:
+
+	cCatalogManager();
+	~cCatalogManager();
+
+	// parse the file and publish the new catalog, optionally filtered; the newest element
+	// set of a satellite listed more than once is kept. A text with a checksum or format
+	// error, or with no satellite, is rejected and the current catalog stays published
+	bool Reload( const char *szTLEFile, const cTLEFilter *pFilter = NULL );
+	bool Reload( const char *pBegin, const char *pEnd, const cTLEFilter *pFilter = NULL );
+
+	// current catalog, valid for as long as the caller holds it
+	std::shared_ptr<const stCatalogSnapshot> GetSnapshot() const { return m_pSnapshot.load(); }
+
+	// counts of the reload which published the current catalog
+	int GetAddedNumber() const { return GetCount( &stCatalogSnapshot::nAdded ); }
+	int GetChangedNumber() const { return GetCount( &stCatalogSnapshot::nChanged ); }
+	int GetRemovedNumber() const { return GetCount( &stCatalogSnapshot::nRemoved ); }
+	int GetUnchangedNumber() const { return GetCount( &stCatalogSnapshot::nUnchanged ); }
+	int GetFailedNumber() const { return GetCount( &stCatalogSnapshot::nFailed ); }		// initialisation failed, left out
+
+	// FNV-1a hash of line 1 and line 2 of the record
+	static unsigned long long HashLines( const stTLERecord &tRecord );
+};
@@ -0,0 +1,441 @@
+/***************************************************************************
+
+ Piecewise Chebyshev ephemeris of one satellite
+
+***************************************************************************/
+#undef UNICODE
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include "ChebyshevEphemeris.h"
+#include "constant.h"
+
+// file layout version of Save() and Load()
+#define CHEBYSHEV_FILE_VERSION 1
+
+/******************************************************************************************
+
+  Sum of pdfC[ j ] * Tj( dfX ), j = 0 to nDegree, by Clenshaw's recurrence
+
+*******************************************************************************************/
+
+static inline double Clenshaw( const double *pdfC, int nDegree, double dfX )
+{
+	double dfX2 = dfX + dfX;
+	double dfB1 = 0.0, dfB2 = 0.0;
+
+	for( int j = nDegree; j >= 1; j-- )
+	{
+		double dfB0 = dfX2 * dfB1 - dfB2 + pdfC[ j ];
+		dfB2 = dfB1;
+		dfB1 = dfB0;
+	}
+
+	return dfX * dfB1 - dfB2 + pdfC[ 0 ];
+}
+
+
+cChebyshevEphemeris::cChebyshevEphemeris()
+{
+	m_nFrame = EPHEMERIS_ECEF;
+	m_nDegree = 0;
+	m_nNORADID = 0;
+	m_bVelocity = false;
+	m_dfStartJD = m_dfEndJD = 0.0;
+	m_dfMaxPosError = m_dfMaxVelError = 0.0;
+	m_nError = 0;
+}
+
+
+cChebyshevEphemeris::~cChebyshevEphemeris()
+{
+
+}
+
+
+void cChebyshevEphemeris::Clear()
+{
+	m_vdfSegmentJD.clear();
+	m_vdfCoefficients.clear();
+	m_nDegree = 0;
+	m_nNORADID = 0;
+	m_bVelocity = false;
+	m_dfStartJD = m_dfEndJD = 0.0;
+	m_dfMaxPosError = m_dfMaxVelError = 0.0;
+	m_nError = 0;
+}
+
+/******************************************************************************************
+
+  Fit the ephemeris of a satellite between two JDs
+
+  tSat: initialised propagator, velocity is fitted only if it computes velocity
+  nFrame: EPHEMERIS_TEME or EPHEMERIS_ECEF
+  dfSegmentDays: length of the segments before splitting, in day
+  nDegree: degree of the polynomials, 1 to CHEBYSHEV_MAX_DEGREE
+  dfTolerance: largest position error accepted at the check points, in m
+  dfMinSegmentDays: a segment shorter than twice this length is kept even if it
+                    misses the tolerance, the error is then reported by GetFitError()
+
+  return false if the arguments are wrong or SGP4 fails in the span
+
+*******************************************************************************************/
+
+bool cChebyshevEphemeris::Build( const cTLE2PosVel &tSat, double dfStartJD, double dfEndJD, int nFrame,
+								 double dfSegmentDays, int nDegree, double dfTolerance, double dfMinSegmentDays )
+{
+	Clear();
+
+	if( !tSat.IsInitialised() || dfEndJD <= dfStartJD || dfSegmentDays <= 0.0 || dfMinSegmentDays <= 0.0 ||
+		nDegree < 1 || nDegree > CHEBYSHEV_MAX_DEGREE ||
+		( nFrame != EPHEMERIS_TEME && nFrame != EPHEMERIS_ECEF ) )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	double pdfTLE[ 10 ];
+	tSat.GetTLE( pdfTLE );
+
+	m_nFrame = nFrame;
+	m_nDegree = nDegree;
+	m_nNORADID = (int) pdfTLE[ 0 ];
+	m_bVelocity = !tSat.IsComputePositionOnly();
+	m_dfStartJD = dfStartJD;
+	m_dfEndJD = dfEndJD;
+
+	int nCoefficients = 6 * ( nDegree + 1 );
+	std::vector<double> vdfCoefficients( nCoefficients );
+
+	stSGP4WorkArea tWork;
+
+	// intervals still to fit, the next one in time at the back
+	std::vector< std::pair<double, double> > vtPending;
+
+	m_vdfSegmentJD.push_back( dfStartJD );
+
+	for( double dfJD = dfStartJD; dfJD < dfEndJD; dfJD += dfSegmentDays )
+	{
+		double dfNextJD = std::min( dfJD + dfSegmentDays, dfEndJD );
+
+		// a last piece shorter than the minimum is merged into the previous segment
+		if( dfEndJD - dfNextJD < dfMinSegmentDays ) dfNextJD = dfEndJD;
+
+		vtPending.push_back( std::make_pair( dfJD, dfNextJD ) );
+
+		while( !vtPending.empty() )
+		{
+			std::pair<double, double> tInterval = vtPending.back();
+			vtPending.pop_back();
+
+			double dfPosError, dfVelError;
+			if( !FitSegment( tSat, tWork, tInterval.first, tInterval.second, &vdfCoefficients[ 0 ],
+							 dfPosError, dfVelError ) )
+			{
+				Clear();
+				m_nError = 1;
+				return false;
+			}
+
+			double dfMidJD = 0.5 * ( tInterval.first + tInterval.second );
+
+			if( dfPosError > dfTolerance && dfMidJD - tInterval.first >= dfMinSegmentDays )
+			{
+				vtPending.push_back( std::make_pair( dfMidJD, tInterval.second ) );
+				vtPending.push_back( std::make_pair( tInterval.first, dfMidJD ) );
+				continue;
+			}
+
+			m_vdfSegmentJD.push_back( tInterval.second );
+			m_vdfCoefficients.insert( m_vdfCoefficients.end(), vdfCoefficients.begin(), vdfCoefficients.end() );
+
+			m_dfMaxPosError = std::max( m_dfMaxPosError, dfPosError );
+			m_dfMaxVelError = std::max( m_dfMaxVelError, dfVelError );
+		}
+
+		if( dfNextJD >= dfEndJD ) break;
+	}
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Position and velocity from SGP4 in the frame of the ephemeris
+
+*******************************************************************************************/
+
+bool cChebyshevEphemeris::Propagate( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfJD,
+									 double *pdfPos, double *pdfVel ) const
+{
+	pdfVel[ 0 ] = pdfVel[ 1 ] = pdfVel[ 2 ] = 0.0;
+
+	if( m_nFrame == EPHEMERIS_ECEF ) return tSat.ComputeECEFPosVel( dfJD, pdfPos, pdfVel, tWork );
+
+	return tSat.ComputeInertialPosVel( dfJD, pdfPos, pdfVel, tWork );
+}
+
+/******************************************************************************************
+
+  Fit one segment
+
+  The polynomials interpolate SGP4 at the m_nDegree + 1 Chebyshev nodes. The nodes are
+  taken at the JDs actually passed to SGP4, which are rounded to about 40 us, so the
+  coefficients come from solving the interpolation equations rather than from the
+  discrete cosine sums. The error is checked against SGP4 at 2 * ( m_nDegree + 1 ) + 1 
+  equally spaced points, the ends of the segment included.
+
+  pdfCoefficients: 6 * ( m_nDegree + 1 ) values
+
+*******************************************************************************************/
+
+bool cChebyshevEphemeris::FitSegment( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork,
+									  double dfStartJD, double dfEndJD, double *pdfCoefficients,
+									  double &dfPosError, double &dfVelError ) const
+{
+	const int N = CHEBYSHEV_MAX_DEGREE + 1;
+
+	int nNodes = m_nDegree + 1;
+	double dfMidJD = 0.5 * ( dfEndJD + dfStartJD );
+	double dfHalfJD = 0.5 * ( dfEndJD - dfStartJD );
+
+	// interpolation equations, one row per node: T0..Tn at the node, then 6 components
+	double pdfA[ N ][ N + 6 ];
+	double pdfPos[ 3 ], pdfVel[ 3 ];
+
+	for( int k = 0; k < nNodes; k++ )
+	{
+		double dfJD = dfMidJD + dfHalfJD * cos( g_dfPI * ( k + 0.5 ) / nNodes );
+		if( !Propagate( tSat, tWork, dfJD, pdfPos, pdfVel ) ) return false;
+
+		double dfX = ( 2.0 * dfJD - dfStartJD - dfEndJD ) / ( dfEndJD - dfStartJD );
+
+		pdfA[ k ][ 0 ] = 1.0;
+		if( nNodes > 1 ) pdfA[ k ][ 1 ] = dfX;
+		for( int j = 2; j < nNodes; j++ ) pdfA[ k ][ j ] = 2.0 * dfX * pdfA[ k ][ j - 1 ] - pdfA[ k ][ j - 2 ];
+
+		for( int i = 0; i < 3; i++ )
+		{
+			pdfA[ k ][ nNodes + i ] = pdfPos[ i ];
+			pdfA[ k ][ nNodes + i + 3 ] = pdfVel[ i ];
+		}
+	}
+
+	// Gaussian elimination with partial pivoting
+	for( int j = 0; j < nNodes; j++ )
+	{
+		int nPivot = j;
+		for( int k = j + 1; k < nNodes; k++ ) if( fabs( pdfA[ k ][ j ] ) > fabs( pdfA[ nPivot ][ j ] ) ) nPivot = k;
+
+		if( nPivot != j ) for( int m = j; m < nNodes + 6; m++ ) std::swap( pdfA[ j ][ m ], pdfA[ nPivot ][ m ] );
+
+		for( int k = j + 1; k < nNodes; k++ )
+		{
+			double dfFactor = pdfA[ k ][ j ] / pdfA[ j ][ j ];
+			for( int m = j; m < nNodes + 6; m++ ) pdfA[ k ][ m ] -= dfFactor * pdfA[ j ][ m ];
+		}
+	}
+
+	for( int i = 0; i < 6; i++ )
+	{
+		double *pdfC = pdfCoefficients + i * nNodes;
+
+		for( int j = nNodes - 1; j >= 0; j-- )
+		{
+			double dfSum = pdfA[ j ][ nNodes + i ];
+			for( int m = j + 1; m < nNodes; m++ ) dfSum -= pdfA[ j ][ m ] * pdfC[ m ];
+			pdfC[ j ] = dfSum / pdfA[ j ][ j ];
+		}
+	}
+
+	// check points, evaluated with the coefficients just computed
+	dfPosError = dfVelError = 0.0;
+
+	int nChecks = 2 * nNodes;
+	double pdfFitPos[ 3 ], pdfFitVel[ 3 ];
+
+	for( int k = 0; k <= nChecks; k++ )
+	{
+		double dfJD = k == nChecks ? dfEndJD : dfStartJD + ( dfEndJD - dfStartJD ) * k / nChecks;
+		if( !Propagate( tSat, tWork, dfJD, pdfPos, pdfVel ) ) return false;
+
+		double dfX = ( 2.0 * dfJD - dfStartJD - dfEndJD ) / ( dfEndJD - dfStartJD );
+
+		for( int i = 0; i < 3; i++ )
+		{
+			pdfFitPos[ i ] = Clenshaw( pdfCoefficients + i * nNodes, m_nDegree, dfX );
+			pdfFitVel[ i ] = Clenshaw( pdfCoefficients + ( i + 3 ) * nNodes, m_nDegree, dfX );
+		}
+
+		double dfPos = 0.0, dfVel = 0.0;
+		for( int i = 0; i < 3; i++ )
+		{
+			dfPos += ( pdfFitPos[ i ] - pdfPos[ i ] ) * ( pdfFitPos[ i ] - pdfPos[ i ] );
+			dfVel += ( pdfFitVel[ i ] - pdfVel[ i ] ) * ( pdfFitVel[ i ] - pdfVel[ i ] );
+		}
+
+		dfPosError = std::max( dfPosError, sqrt( dfPos ) );
+		if( m_bVelocity ) dfVelError = std::max( dfVelError, sqrt( dfVel ) );
+	}
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Index of the segment containing the JD, -1 if it is outside of the span
+
+*******************************************************************************************/
+
+int cChebyshevEphemeris::FindSegment( double dfJD ) const
+{
+	if( m_vdfSegmentJD.empty() || dfJD < m_dfStartJD || dfJD > m_dfEndJD ) return -1;
+
+	// first segment end which is not before the JD
+	std::vector<double>::const_iterator it = std::lower_bound( m_vdfSegmentJD.begin() + 1, m_vdfSegmentJD.end(), dfJD );
+	if( it == m_vdfSegmentJD.end() ) --it;
+
+	return (int) ( it - m_vdfSegmentJD.begin() ) - 1;
+}
+
+
+void cChebyshevEphemeris::Evaluate( int nSegment, double dfJD, double *pdfPos, double *pdfVel ) const
+{
+	int nNodes = m_nDegree + 1;
+	const double *pdfC = &m_vdfCoefficients[ 6 * nNodes * nSegment ];
+
+	double dfStartJD = m_vdfSegmentJD[ nSegment ], dfEndJD = m_vdfSegmentJD[ nSegment + 1 ];
+	double dfX = ( 2.0 * dfJD - dfStartJD - dfEndJD ) / ( dfEndJD - dfStartJD );
+
+	for( int i = 0; i < 3; i++ ) pdfPos[ i ] = Clenshaw( pdfC + i * nNodes, m_nDegree, dfX );
+
+	if( pdfVel == NULL ) return;
+
+	for( int i = 0; i < 3; i++ ) pdfVel[ i ] = Clenshaw( pdfC + ( i + 3 ) * nNodes, m_nDegree, dfX );
+}
+
+/******************************************************************************************
+
+  Position and velocity at the given JD
+
+  pdfPos: m, pdfVel: m/s, in the frame the ephemeris was built in
+
+  return false if the JD is outside of the span, or the velocity is asked from an
+  ephemeris built without velocity
+
+*******************************************************************************************/
+
+bool cChebyshevEphemeris::ComputePosVel( double dfJD, double *pdfPos, double *pdfVel ) const
+{
+	int nSegment = FindSegment( dfJD );
+
+	if( nSegment < 0 || !m_bVelocity ) return false;
+
+	Evaluate( nSegment, dfJD, pdfPos, pdfVel );
+
+	return true;
+}
+
+
+bool cChebyshevEphemeris::ComputePos( double dfJD, double *pdfPos ) const
+{
+	int nSegment = FindSegment( dfJD );
+
+	if( nSegment < 0 ) return false;
+
+	Evaluate( nSegment, dfJD, pdfPos, NULL );
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Write the ephemeris to a binary file in the byte order of the machine
+
+  "CHEB", version, frame, degree, NORAD ID, velocity flag, number of segments,
+  start and end JD, position and velocity fit errors, segment JDs, coefficients
+
+*******************************************************************************************/
+
+bool cChebyshevEphemeris::Save( const char *szFileName ) const
+{
+	if( !IsBuilt() ) return false;
+
+	FILE *stream = fopen( szFileName, "wb" );
+	if( stream == NULL ) return false;
+
+	int pnHeader[ 6 ];
+	pnHeader[ 0 ] = CHEBYSHEV_FILE_VERSION;
+	pnHeader[ 1 ] = m_nFrame;
+	pnHeader[ 2 ] = m_nDegree;
+	pnHeader[ 3 ] = m_nNORADID;
+	pnHeader[ 4 ] = m_bVelocity ? 1 : 0;
+	pnHeader[ 5 ] = GetSegmentNumber();
+
+	double pdfHeader[ 4 ] = { m_dfStartJD, m_dfEndJD, m_dfMaxPosError, m_dfMaxVelError };
+
+	bool bOK = fwrite( "CHEB", 1, 4, stream ) == 4 &&
+			   fwrite( pnHeader, sizeof( int ), 6, stream ) == 6 &&
+			   fwrite( pdfHeader, sizeof( double ), 4, stream ) == 4 &&
+			   fwrite( &m_vdfSegmentJD[ 0 ], sizeof( double ), m_vdfSegmentJD.size(), stream ) == m_vdfSegmentJD.size() &&
+			   fwrite( &m_vdfCoefficients[ 0 ], sizeof( double ), m_vdfCoefficients.size(), stream ) == m_vdfCoefficients.size();
+
+	if( fclose( stream ) != 0 ) bOK = false;
+
+	return bOK;
+}
+
+
+bool cChebyshevEphemeris::Load( const char *szFileName )
+{
+	Clear();
+
+	FILE *stream = fopen( szFileName, "rb" );
+	if( stream == NULL )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	char szMagic[ 4 ];
+	int pnHeader[ 6 ];
+	double pdfHeader[ 4 ];
+
+	bool bOK = fread( szMagic, 1, 4, stream ) == 4 && memcmp( szMagic, "CHEB", 4 ) == 0 &&
+			   fread( pnHeader, sizeof( int ), 6, stream ) == 6 &&
+			   fread( pdfHeader, sizeof( double ), 4, stream ) == 4 &&
+			   pnHeader[ 0 ] == CHEBYSHEV_FILE_VERSION &&
+			   ( pnHeader[ 1 ] == EPHEMERIS_TEME || pnHeader[ 1 ] == EPHEMERIS_ECEF ) &&
+			   pnHeader[ 2 ] >= 1 && pnHeader[ 2 ] <= CHEBYSHEV_MAX_DEGREE && pnHeader[ 5 ] > 0;
+
+	if( bOK )
+	{
+		m_vdfSegmentJD.resize( pnHeader[ 5 ] + 1 );
+		m_vdfCoefficients.resize( (size_t) 6 * ( pnHeader[ 2 ] + 1 ) * pnHeader[ 5 ] );
+
+		bOK = fread( &m_vdfSegmentJD[ 0 ], sizeof( double ), m_vdfSegmentJD.size(), stream ) == m_vdfSegmentJD.size() &&
+			  fread( &m_vdfCoefficients[ 0 ], sizeof( double ), m_vdfCoefficients.size(), stream ) == m_vdfCoefficients.size();
+	}
+
+	fclose( stream );
+
+	if( !bOK )
+	{
+		Clear();
+		m_nError = 1;
+		return false;
+	}
+
+	m_nFrame = pnHeader[ 1 ];
+	m_nDegree = pnHeader[ 2 ];
+	m_nNORADID = pnHeader[ 3 ];
+	m_bVelocity = pnHeader[ 4 ] != 0;
+	m_dfStartJD = pdfHeader[ 0 ];
+	m_dfEndJD = pdfHeader[ 1 ];
+	m_dfMaxPosError = pdfHeader[ 2 ];
+	m_dfMaxVelError = pdfHeader[ 3 ];
+
+	return true;
+}
@@ -0,0 +1,90 @@
+/***************************************************************************
+
+ Piecewise Chebyshev ephemeris of one satellite
+
+ The SGP4 orbit of a cTLE2PosVel is sampled over a time span and every
+ segment is fitted with Chebyshev polynomials of the position, and of the
+ velocity if the propagator computes it. A segment which misses the position
+ tolerance is halved until it fits, or until it reaches the minimum length.
+
+ Evaluation is a binary search of the segment and a Clenshaw recurrence per
+ component, with no trigonometric function. The ephemeris can be saved to a
+ file, so that one process builds it and others load and query it.
+
+ Reference: Press et al., Numerical Recipes, 5.8 Chebyshev Approximation
+
+***************************************************************************/
+#pragma once
+
+#include "TLE2PosVel.h"
+
+#include <vector>
+
+enum eEphemerisFrame
+{
+	EPHEMERIS_TEME = 0,		// SGP4 inertial frame
+	EPHEMERIS_ECEF = 1
+};
+
+#define CHEBYSHEV_MAX_DEGREE 32
+
+class cChebyshevEphemeris
+{
+	int m_nFrame;
+	int m_nDegree;				// degree of the polynomials, m_nDegree + 1 coefficients
+	int m_nNORADID;
+	bool m_bVelocity;			// velocity coefficients are stored
+
+	double m_dfStartJD, m_dfEndJD;
+
+	// segment i covers [ m_vdfSegmentJD[ i ], m_vdfSegmentJD[ i + 1 ] ]
+	std::vector<double> m_vdfSegmentJD;
+
+	// per segment, 3 position then 3 velocity components, m_nDegree + 1 coefficients each
+	std::vector<double> m_vdfCoefficients;
+
+	// largest difference to SGP4 found at the check points, in m and m/s
+	double m_dfMaxPosError, m_dfMaxVelError;
+
+	int m_nError;
+
+public:
+
+	cChebyshevEphemeris();
+	~cChebyshevEphemeris();
+
+	void Clear();
+
+	// dfSegmentDays: initial segment length, dfTolerance: position tolerance in m,
+	// dfMinSegmentDays: segments are not split below this length
+	bool Build( const cTLE2PosVel &tSat, double dfStartJD, double dfEndJD, int nFrame = EPHEMERIS_ECEF,
+				double dfSegmentDays = 10.0 / 1440.0, int nDegree = 12, double dfTolerance = 0.01,
+				double dfMinSegmentDays = 1.0 / 1440.0 );
+
+	bool ComputePosVel( double dfJD, double *pdfPos, double *pdfVel ) const;
+	bool ComputePos( double dfJD, double *pdfPos ) const;
+
+	bool Save( const char *szFileName ) const;
+	bool Load( const char *szFileName );
+
+	bool IsBuilt() const { return !m_vdfSegmentJD.empty(); }
+	bool HasVelocity() const { return m_bVelocity; }
+	int GetFrame() const { return m_nFrame; }
+	int GetNORADID() const { return m_nNORADID; }
+	int GetSegmentNumber() const { return m_vdfSegmentJD.empty() ? 0 : (int) m_vdfSegmentJD.size() - 1; }
+	void GetTimeSpan( double &dfStartJD, double &dfEndJD ) const { dfStartJD = m_dfStartJD; dfEndJD = m_dfEndJD; }
+	void GetFitError( double &dfMaxPosError, double &dfMaxVelError ) const
+	{
+		dfMaxPosError = m_dfMaxPosError;
+		dfMaxVelError = m_dfMaxVelError;
+	}
+
+private:
+
+	bool Propagate( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfJD,
+					double *pdfPos, double *pdfVel ) const;
+	bool FitSegment( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfStartJD, double dfEndJD,
+					 double *pdfCoefficients, double &dfPosError, double &dfVelError ) const;
+	int FindSegment( double dfJD ) const;
+	void Evaluate( int nSegment, double dfJD, double *pdfPos, double *pdfVel ) const;
+};
@@ -66,6 +66,38 @@ double cGreenwichST::ComputeGST( double dfTJD )
 	return dfRA;
 }
 
+/***************************************************************************************
+
+  Compute GST at an array of times, the equinox equation is ignored.
+
+  Same as ComputeGST( double ) above, written without branches so that the loop
+  is vectorised. Time should be in UT1 system.
+
+***************************************************************************************/
+
+void cGreenwichST::ComputeGST( int nEpochs, const double *pdfTJD, double *pdfGST )
+{
+	for( int i = 0; i < nEpochs; i++ )
+	{
+		double dfJD = trunc( pdfTJD[ i ] );
+		double dfFday = pdfTJD[ i ] - dfJD;
+		double dfShift = dfFday >= 0.5 ? 0.5 : -0.5;
+
+		dfJD += dfShift;
+		dfFday -= dfShift;
+
+		double dfDt = dfJD - g_dfJ2000;
+		double dfRA = 100.4606184 + 0.9856473663 * dfDt + 2.908e-13 * dfDt * dfDt;
+
+		dfRA *= g_dfDEG2RAD;
+
+		double dfR = 1.002737909350795 + 5.9006e-11 / 36525.0 * dfDt;
+		dfRA += dfR * dfFday * g_dfTWOPI;
+
+		pdfGST[ i ] = dfRA - g_dfTWOPI * floor( dfRA / g_dfTWOPI );	// in [0, 2PI)
+	}
+}
+
 /***************************************************************************************
 
   Compute GST at the given time
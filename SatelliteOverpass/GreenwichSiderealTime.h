@@ -16,6 +16,7 @@ public:
 	~cGreenwichST();
 
 	static double ComputeGST( double dfTJD );
+	static void ComputeGST( int nEpochs, const double *pdfTJD, double *pdfGST );
 
 	static BOOL ComputeGST( double dfIntJD, double dfFractionJD, 
 		                    double dfEquinoxEquation,  double &dfGST );
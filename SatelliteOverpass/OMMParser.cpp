@@ -0,0 +1,865 @@
+/***************************************************************************
+
+ CCSDS Orbit Mean-Elements Message (OMM) parser, KVN, XML and CSV
+
+***************************************************************************/
+#undef UNICODE
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "OMMParser.h"
+#include "TLEParser.h"
+#include "TLEStream.h"
+#include "DateTimeZ.h"
+
+// exact powers of 10, an integer of at most 2^53 times or over one of them is correctly
+// rounded
+static const double s_pdfPowerOf10[ 23 ] =
+{
+	1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9, 1.0e10, 1.0e11,
+	1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18, 1.0e19, 1.0e20, 1.0e21, 1.0e22
+};
+
+// keys of the fields, the same in the three formats
+static const struct stOMMKey
+{
+	const char *szKey;
+	int nLength;
+	int nField;
+} s_ptOMMKeys[] =
+{
+	{ "OBJECT_NAME", 11, OMM_OBJECT_NAME },
+	{ "OBJECT_ID", 9, OMM_OBJECT_ID },
+	{ "EPOCH", 5, OMM_EPOCH },
+	{ "MEAN_MOTION", 11, OMM_MEAN_MOTION },
+	{ "ECCENTRICITY", 12, OMM_ECCENTRICITY },
+	{ "INCLINATION", 11, OMM_INCLINATION },
+	{ "RA_OF_ASC_NODE", 14, OMM_RA_OF_ASC_NODE },
+	{ "ARG_OF_PERICENTER", 17, OMM_ARG_OF_PERICENTER },
+	{ "MEAN_ANOMALY", 12, OMM_MEAN_ANOMALY },
+	{ "NORAD_CAT_ID", 12, OMM_NORAD_CAT_ID },
+	{ "BSTAR", 5, OMM_BSTAR },
+	{ "MEAN_MOTION_DOT", 15, OMM_MEAN_MOTION_DOT },
+	{ "MEAN_MOTION_DDOT", 16, OMM_MEAN_MOTION_DDOT }
+};
+
+// fields without which a record is not decoded
+static const int s_nRequiredFields =
+	( 1 << OMM_EPOCH ) | ( 1 << OMM_MEAN_MOTION ) | ( 1 << OMM_ECCENTRICITY ) | ( 1 << OMM_INCLINATION ) |
+	( 1 << OMM_RA_OF_ASC_NODE ) | ( 1 << OMM_ARG_OF_PERICENTER ) | ( 1 << OMM_MEAN_ANOMALY ) |
+	( 1 << OMM_NORAD_CAT_ID );
+
+// marks a record with a malformed value
+#define OMM_MALFORMED ( 1 << 30 )
+
+
+static bool IsBlank( char c )
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+
+static void ClearRecord( stOMMRecord &tRecord )
+{
+	memset( &tRecord, 0, sizeof( tRecord ) );
+	tRecord.pName = NULL;
+	tRecord.pObjectID = NULL;
+}
+
+
+static bool IsComplete( const stOMMRecord &tRecord )
+{
+	return ( tRecord.nFields & ( s_nRequiredFields | OMM_MALFORMED ) ) == s_nRequiredFields;
+}
+
+
+cOMMParser::cOMMParser()
+{
+	ResetCounters();
+	SetFormat( OMM_FORMAT_UNKNOWN );
+
+	m_nDate = 0;
+	m_dfDateJD = 0.0;
+}
+
+
+cOMMParser::~cOMMParser()
+{
+
+}
+
+
+void cOMMParser::ResetCounters()
+{
+	m_nRecords = 0;
+	m_nFormatErrors = 0;
+}
+
+
+void cOMMParser::SetFormat( int nFormat )
+{
+	m_nFormat = nFormat;
+
+	m_nColumns = 0;
+	m_bHeader = false;
+}
+
+/******************************************************************************************
+
+  The format from the first characters of the text: XML starts with a tag, KVN with
+  CCSDS_OMM_VERS or a line KEY = value, CSV with a line of column names
+
+*******************************************************************************************/
+
+int cOMMParser::DetectFormat( const char *pBegin, const char *pEnd )
+{
+	const char *p = pBegin;
+
+	// UTF-8 byte order mark
+	if( pEnd - p >= 3 && (unsigned char) p[ 0 ] == 0xEF && (unsigned char) p[ 1 ] == 0xBB &&
+		(unsigned char) p[ 2 ] == 0xBF ) p += 3;
+
+	while( p < pEnd && IsBlank( *p ) ) p++;
+	if( p == pEnd ) return OMM_FORMAT_UNKNOWN;
+
+	if( *p == '<' ) return OMM_FORMAT_XML;
+
+	const char *pLineEnd = (const char *) memchr( p, '\n', pEnd - p );
+	if( pLineEnd == NULL ) pLineEnd = pEnd;
+
+	if( memchr( p, '=', pLineEnd - p ) != NULL ) return OMM_FORMAT_KVN;
+	if( memchr( p, ',', pLineEnd - p ) != NULL ) return OMM_FORMAT_CSV;
+
+	return OMM_FORMAT_UNKNOWN;
+}
+
+
+int cOMMParser::FindField( const char *pKey, const char *pKeyEnd )
+{
+	int nLength = (int) ( pKeyEnd - pKey );
+
+	for( size_t i = 0; i < sizeof( s_ptOMMKeys ) / sizeof( s_ptOMMKeys[ 0 ] ); i++ )
+	{
+		if( s_ptOMMKeys[ i ].nLength == nLength && memcmp( s_ptOMMKeys[ i ].szKey, pKey, nLength ) == 0 )
+		{
+			return s_ptOMMKeys[ i ].nField;
+		}
+	}
+
+	return -1;
+}
+
+/******************************************************************************************
+
+  Decimal number: up to 19 significant digits gathered in an integer, which is scaled by
+  one exact power of 10 when it is exact itself (at most 2^53) and the power at most 22,
+  the result being then correctly rounded; strtod otherwise
+
+*******************************************************************************************/
+
+bool cOMMParser::DecodeNumber( const char *pText, const char *pEnd, double &dfValue )
+{
+	while( pText < pEnd && IsBlank( *pText ) ) pText++;
+	while( pEnd > pText && IsBlank( pEnd[ -1 ] ) ) pEnd--;
+
+	const char *p = pText;
+
+	bool bNegative = false;
+	if( p < pEnd && ( *p == '-' || *p == '+' ) ) bNegative = *p++ == '-';
+
+	unsigned long long nMantissa = 0;
+	int nSignificant = 0, nExponent = 0, nDigits = 0;
+	bool bPoint = false;
+
+	for( ; p < pEnd; p++ )
+	{
+		if( *p == '.' && !bPoint )
+		{
+			bPoint = true;
+			continue;
+		}
+
+		unsigned int nDigit = (unsigned int) ( *p - '0' );
+		if( nDigit > 9 ) break;
+
+		nDigits++;
+
+		if( nMantissa == 0 && nDigit == 0 )
+		{
+			if( bPoint ) nExponent--;
+			continue;
+		}
+
+		if( nSignificant < 19 )
+		{
+			nMantissa = nMantissa * 10 + nDigit;
+			nSignificant++;
+			if( bPoint ) nExponent--;
+		}
+		else
+		{
+			nSignificant++;
+			if( !bPoint ) nExponent++;
+		}
+	}
+
+	if( nDigits == 0 ) return false;
+
+	if( p < pEnd && ( *p == 'e' || *p == 'E' ) )
+	{
+		p++;
+
+		bool bNegativeExponent = false;
+		if( p < pEnd && ( *p == '-' || *p == '+' ) ) bNegativeExponent = *p++ == '-';
+
+		if( p == pEnd ) return false;
+
+		int nPower = 0;
+		for( ; p < pEnd && *p >= '0' && *p <= '9'; p++ )
+		{
+			if( nPower < 10000 ) nPower = nPower * 10 + ( *p - '0' );
+		}
+
+		nExponent += bNegativeExponent ? -nPower : nPower;
+	}
+
+	if( p != pEnd ) return false;
+
+	if( nSignificant <= 19 && nMantissa <= ( 1ull << 53 ) && nExponent >= -22 && nExponent <= 22 )
+	{
+		dfValue = (double) nMantissa;
+		if( nExponent < 0 ) dfValue /= s_pdfPowerOf10[ -nExponent ];
+		else dfValue *= s_pdfPowerOf10[ nExponent ];
+
+		if( bNegative ) dfValue = -dfValue;
+		return true;
+	}
+
+	char szNumber[ 64 ];
+	if( pEnd - pText >= (int) sizeof( szNumber ) ) return false;
+
+	memcpy( szNumber, pText, pEnd - pText );
+	szNumber[ pEnd - pText ] = '\0';
+	dfValue = strtod( szNumber, NULL );
+
+	return true;
+}
+
+/******************************************************************************************
+
+  YYYY-MM-DDThh:mm:ss.s or YYYY-DDDThh:mm:ss.s, the JD of the date kept for the next
+  records, most of which share it
+
+*******************************************************************************************/
+
+bool cOMMParser::DecodeEpoch( const char *pText, const char *pEnd, double &dfJD )
+{
+	while( pText < pEnd && IsBlank( *pText ) ) pText++;
+	while( pEnd > pText && ( IsBlank( pEnd[ -1 ] ) || pEnd[ -1 ] == 'Z' ) ) pEnd--;
+
+	// year, month and day or day of year, hour and minute, the seconds after them
+	int pnNumbers[ 5 ], pnWidths[ 5 ], nNumbers = 0, nMaxNumbers = 5;
+	const char *p = pText;
+
+	while( nNumbers < nMaxNumbers )
+	{
+		const char *pNumber = p;
+		int n = 0;
+		while( p < pEnd && p - pNumber < 9 && *p >= '0' && *p <= '9' ) n = n * 10 + ( *p++ - '0' );
+
+		if( p == pNumber ) return false;
+
+		pnWidths[ nNumbers ] = (int) ( p - pNumber );
+		pnNumbers[ nNumbers++ ] = n;
+
+		if( nNumbers == 2 && pnWidths[ 1 ] == 3 ) nMaxNumbers = 4;
+
+		if( p == pEnd ) break;
+		if( *p != '-' && *p != 'T' && *p != ' ' && *p != ':' ) return false;
+		p++;
+	}
+
+	bool bDayOfYear = nMaxNumbers == 4;
+	int nDateNumbers = bDayOfYear ? 2 : 3;
+	if( nNumbers < nDateNumbers || pnWidths[ 0 ] != 4 ) return false;
+
+	int nDate = bDayOfYear ? -( pnNumbers[ 0 ] * 1000 + pnNumbers[ 1 ] ) :
+							 pnNumbers[ 0 ] * 10000 + pnNumbers[ 1 ] * 100 + pnNumbers[ 2 ];
+
+	if( nDate != m_nDate )
+	{
+		if( bDayOfYear )
+		{
+			g_DateTimeZ.DateTime2JD( pnNumbers[ 0 ], 1, 0, 0, 0, 0.0, m_dfDateJD );
+			m_dfDateJD += pnNumbers[ 1 ];
+		}
+		else g_DateTimeZ.DateTime2JD( pnNumbers[ 0 ], pnNumbers[ 1 ], pnNumbers[ 2 ], 0, 0, 0.0, m_dfDateJD );
+
+		m_nDate = nDate;
+	}
+
+	int nHour = nNumbers > nDateNumbers ? pnNumbers[ nDateNumbers ] : 0;
+	int nMinute = nNumbers > nDateNumbers + 1 ? pnNumbers[ nDateNumbers + 1 ] : 0;
+
+	double dfSecond = 0.0;
+	if( nNumbers == nMaxNumbers && p < pEnd && !DecodeNumber( p, pEnd, dfSecond ) ) return false;
+
+	dfJD = m_dfDateJD + ( nHour * 3600.0 + nMinute * 60.0 + dfSecond ) / 86400.0;
+
+	return true;
+}
+
+
+bool cOMMParser::SetField( stOMMRecord &tRecord, int nField, const char *pValue, const char *pValueEnd )
+{
+	while( pValue < pValueEnd && IsBlank( *pValue ) ) pValue++;
+	while( pValueEnd > pValue && IsBlank( pValueEnd[ -1 ] ) ) pValueEnd--;
+
+	bool bOK = true;
+
+	switch( nField )
+	{
+	case OMM_OBJECT_NAME:
+		tRecord.pName = pValue;
+		tRecord.nNameLength = (int) ( pValueEnd - pValue );
+		break;
+	case OMM_OBJECT_ID:
+		tRecord.pObjectID = pValue;
+		tRecord.nObjectIDLength = (int) ( pValueEnd - pValue );
+		break;
+	case OMM_EPOCH:
+		bOK = DecodeEpoch( pValue, pValueEnd, tRecord.dfEpochJD );
+		break;
+	case OMM_NORAD_CAT_ID:
+		{
+			int nID = 0;
+			const char *p = pValue;
+			for( ; p < pValueEnd && p - pValue < 9 && *p >= '0' && *p <= '9'; p++ ) nID = nID * 10 + ( *p - '0' );
+
+			bOK = p > pValue && p == pValueEnd;
+			tRecord.nSatelliteID = nID;
+		}
+		break;
+	case OMM_MEAN_MOTION: bOK = DecodeNumber( pValue, pValueEnd, tRecord.dfMeanMotion ); break;
+	case OMM_ECCENTRICITY: bOK = DecodeNumber( pValue, pValueEnd, tRecord.dfEccentricity ); break;
+	case OMM_INCLINATION: bOK = DecodeNumber( pValue, pValueEnd, tRecord.dfInclination ); break;
+	case OMM_RA_OF_ASC_NODE: bOK = DecodeNumber( pValue, pValueEnd, tRecord.dfRAAN ); break;
+	case OMM_ARG_OF_PERICENTER: bOK = DecodeNumber( pValue, pValueEnd, tRecord.dfArgPerigee ); break;
+	case OMM_MEAN_ANOMALY: bOK = DecodeNumber( pValue, pValueEnd, tRecord.dfMeanAnomaly ); break;
+	case OMM_BSTAR: bOK = DecodeNumber( pValue, pValueEnd, tRecord.dfBSTAR ); break;
+	case OMM_MEAN_MOTION_DOT: bOK = DecodeNumber( pValue, pValueEnd, tRecord.dfMeanMotionDot ); break;
+	case OMM_MEAN_MOTION_DDOT: bOK = DecodeNumber( pValue, pValueEnd, tRecord.dfMeanMotionDDot ); break;
+	default: return true;
+	}
+
+	tRecord.nFields |= bOK ? 1 << nField : OMM_MALFORMED;
+
+	return bOK;
+}
+
+
+const char *cOMMParser::NextRecord( const char *pText, const char *pEnd, stOMMRecord &tRecord )
+{
+	if( m_nFormat == OMM_FORMAT_UNKNOWN ) m_nFormat = DetectFormat( pText, pEnd );
+
+	switch( m_nFormat )
+	{
+	case OMM_FORMAT_KVN: return NextKVNRecord( pText, pEnd, tRecord );
+	case OMM_FORMAT_XML: return NextXMLRecord( pText, pEnd, tRecord );
+	case OMM_FORMAT_CSV: return NextCSVRecord( pText, pEnd, tRecord );
+	}
+
+	return NULL;
+}
+
+/******************************************************************************************
+
+  KVN: lines KEY = value, with an optional unit in brackets after the value, COMMENT lines
+  and keys not in the table skipped; a record starts at CCSDS_OMM_VERS and ends before the
+  next one
+
+*******************************************************************************************/
+
+const char *cOMMParser::NextKVNRecord( const char *pText, const char *pEnd, stOMMRecord &tRecord )
+{
+	bool bInRecord = false;
+
+	while( pText < pEnd )
+	{
+		const char *pLineEnd = (const char *) memchr( pText, '\n', pEnd - pText );
+		if( pLineEnd == NULL ) pLineEnd = pEnd;
+		const char *pNext = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+
+		const char *pKey = pText;
+		while( pKey < pLineEnd && IsBlank( *pKey ) ) pKey++;
+
+		const char *pKeyEnd = pKey;
+		while( pKeyEnd < pLineEnd && *pKeyEnd != '=' && !IsBlank( *pKeyEnd ) ) pKeyEnd++;
+
+		if( pKeyEnd - pKey == 14 && memcmp( pKey, "CCSDS_OMM_VERS", 14 ) == 0 )
+		{
+			if( bInRecord )
+			{
+				if( IsComplete( tRecord ) ) return pText;
+
+				m_nFormatErrors++;
+			}
+
+			ClearRecord( tRecord );
+			bInRecord = true;
+		}
+		else if( bInRecord && pKeyEnd > pKey )
+		{
+			int nField = FindField( pKey, pKeyEnd );
+
+			const char *pValue = (const char *) memchr( pKeyEnd, '=', pLineEnd - pKeyEnd );
+
+			if( nField >= 0 && pValue != NULL )
+			{
+				pValue++;
+				while( pValue < pLineEnd && IsBlank( *pValue ) ) pValue++;
+
+				// the unit, if any, follows the value after a blank; the name may have blanks
+				const char *pValueEnd = pLineEnd;
+				if( nField != OMM_OBJECT_NAME )
+				{
+					pValueEnd = pValue;
+					while( pValueEnd < pLineEnd && !IsBlank( *pValueEnd ) && *pValueEnd != '[' ) pValueEnd++;
+				}
+
+				SetField( tRecord, nField, pValue, pValueEnd );
+			}
+		}
+
+		pText = pNext;
+	}
+
+	if( bInRecord )
+	{
+		if( IsComplete( tRecord ) ) return pEnd;
+
+		m_nFormatErrors++;
+	}
+
+	return NULL;
+}
+
+/******************************************************************************************
+
+  XML: the tags found with memchr, the value of a field being the text up to the next
+  tag; a record starts at <omm and ends at </omm>, the other tags of the message (ndm,
+  header, body, segment, metadata, data, meanElements, tleParameters) are only walked
+
+*******************************************************************************************/
+
+const char *cOMMParser::NextXMLRecord( const char *pText, const char *pEnd, stOMMRecord &tRecord )
+{
+	bool bInRecord = false;
+
+	while( pText < pEnd )
+	{
+		const char *pTag = (const char *) memchr( pText, '<', pEnd - pText );
+		if( pTag == NULL ) break;
+
+		const char *pName = pTag + 1;
+
+		// comments, processing instructions and declarations
+		if( pName < pEnd && ( *pName == '?' || *pName == '!' ) )
+		{
+			const char *pClose = pEnd;
+			if( pEnd - pName >= 3 && memcmp( pName, "!--", 3 ) == 0 )
+			{
+				for( const char *p = pName + 3; p + 3 <= pEnd; p++ )
+				{
+					if( p[ 0 ] == '-' && p[ 1 ] == '-' && p[ 2 ] == '>' )
+					{
+						pClose = p + 2;
+						break;
+					}
+				}
+			}
+			else
+			{
+				const char *p = (const char *) memchr( pName, '>', pEnd - pName );
+				if( p != NULL ) pClose = p;
+			}
+
+			pText = pClose < pEnd ? pClose + 1 : pEnd;
+			continue;
+		}
+
+		bool bClosing = pName < pEnd && *pName == '/';
+		if( bClosing ) pName++;
+
+		const char *pNameEnd = pName;
+		while( pNameEnd < pEnd && *pNameEnd != '>' && *pNameEnd != '/' && !IsBlank( *pNameEnd ) ) pNameEnd++;
+
+		const char *pTagEnd = (const char *) memchr( pNameEnd, '>', pEnd - pNameEnd );
+		if( pTagEnd == NULL ) break;
+
+		pText = pTagEnd + 1;
+
+		bool bOMM = pNameEnd - pName == 3 && memcmp( pName, "omm", 3 ) == 0;
+
+		if( bOMM && bClosing )
+		{
+			if( !bInRecord ) continue;
+
+			if( IsComplete( tRecord ) ) return pText;
+
+			m_nFormatErrors++;
+			bInRecord = false;
+		}
+		else if( bOMM )
+		{
+			ClearRecord( tRecord );
+			bInRecord = true;
+		}
+		else if( bInRecord && !bClosing && pTagEnd[ -1 ] != '/' )
+		{
+			int nField = FindField( pName, pNameEnd );
+			if( nField < 0 ) continue;
+
+			const char *pValueEnd = (const char *) memchr( pText, '<', pEnd - pText );
+			if( pValueEnd == NULL ) pValueEnd = pEnd;
+
+			SetField( tRecord, nField, pText, pValueEnd );
+			pText = pValueEnd;
+		}
+	}
+
+	// a record not closed
+	if( bInRecord ) m_nFormatErrors++;
+
+	return NULL;
+}
+
+/******************************************************************************************
+
+  CSV: the first line names the columns, each line after it is a record; a value may be
+  quoted, for a name with a comma
+
+*******************************************************************************************/
+
+const char *cOMMParser::ReadCSVHeader( const char *pText, const char *pEnd )
+{
+	const char *pLineEnd = (const char *) memchr( pText, '\n', pEnd - pText );
+	if( pLineEnd == NULL ) pLineEnd = pEnd;
+
+	// UTF-8 byte order mark
+	if( pLineEnd - pText >= 3 && (unsigned char) pText[ 0 ] == 0xEF && (unsigned char) pText[ 1 ] == 0xBB &&
+		(unsigned char) pText[ 2 ] == 0xBF ) pText += 3;
+
+	m_nColumns = 0;
+
+	for( const char *pColumn = pText; pColumn <= pLineEnd && m_nColumns < OMM_CSV_COLUMNS; )
+	{
+		const char *pColumnEnd = (const char *) memchr( pColumn, ',', pLineEnd - pColumn );
+		if( pColumnEnd == NULL ) pColumnEnd = pLineEnd;
+
+		const char *pKey = pColumn, *pKeyEnd = pColumnEnd;
+		while( pKey < pKeyEnd && ( IsBlank( *pKey ) || *pKey == '"' ) ) pKey++;
+		while( pKeyEnd > pKey && ( IsBlank( pKeyEnd[ -1 ] ) || pKeyEnd[ -1 ] == '"' ) ) pKeyEnd--;
+
+		m_pnColumnField[ m_nColumns++ ] = FindField( pKey, pKeyEnd );
+
+		pColumn = pColumnEnd + 1;
+	}
+
+	m_bHeader = true;
+
+	return pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+}
+
+
+const char *cOMMParser::NextCSVRecord( const char *pText, const char *pEnd, stOMMRecord &tRecord )
+{
+	while( pText < pEnd && !m_bHeader )
+	{
+		while( pText < pEnd && IsBlank( *pText ) ) pText++;
+		if( pText < pEnd ) pText = ReadCSVHeader( pText, pEnd );
+	}
+
+	while( pText < pEnd )
+	{
+		const char *pLineEnd = (const char *) memchr( pText, '\n', pEnd - pText );
+		if( pLineEnd == NULL ) pLineEnd = pEnd;
+		const char *pNext = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+
+		const char *p = pText;
+		while( p < pLineEnd && IsBlank( *p ) ) p++;
+
+		if( p == pLineEnd )
+		{
+			pText = pNext;
+			continue;
+		}
+
+		ClearRecord( tRecord );
+
+		for( int nColumn = 0; pText <= pLineEnd && nColumn < m_nColumns; nColumn++ )
+		{
+			const char *pValue = pText, *pValueEnd;
+
+			if( pValue < pLineEnd && *pValue == '"' )
+			{
+				pValue++;
+				pValueEnd = (const char *) memchr( pValue, '"', pLineEnd - pValue );
+				if( pValueEnd == NULL ) pValueEnd = pLineEnd;
+
+				pText = (const char *) memchr( pValueEnd, ',', pLineEnd - pValueEnd );
+			}
+			else
+			{
+				pValueEnd = (const char *) memchr( pValue, ',', pLineEnd - pValue );
+				pText = pValueEnd;
+				if( pValueEnd == NULL ) pValueEnd = pLineEnd;
+			}
+
+			if( m_pnColumnField[ nColumn ] >= 0 ) SetField( tRecord, m_pnColumnField[ nColumn ], pValue, pValueEnd );
+
+			if( pText == NULL ) break;
+			pText++;
+		}
+
+		pText = pNext;
+
+		if( IsComplete( tRecord ) ) return pText;
+
+		m_nFormatErrors++;
+	}
+
+	return NULL;
+}
+
+/******************************************************************************************
+
+  Elements in the units of cTLEParser::DecodeRecord(), each computed from the same double
+  by the same expression, so that the two give the same record for the same values
+
+*******************************************************************************************/
+
+bool cOMMParser::DecodeRecord( const stOMMRecord &tRecord, stSatelliteElements &stIOE )
+{
+	memset( stIOE.pfElement7to18, 0, sizeof( stIOE.pfElement7to18 ) );
+
+	stIOE.nSatelliteID = tRecord.nSatelliteID;
+	stIOE.nSIC = 0;
+
+	stIOE.SetRefJD( tRecord.dfEpochJD );
+
+	// n dot, n dot dot and BSTAR
+	stIOE.pfElement7to18[ 0 ] = (float) tRecord.dfMeanMotionDot;
+	stIOE.pfElement7to18[ 1 ] = (float) tRecord.dfMeanMotionDDot;
+	stIOE.pfElement7to18[ 2 ] = (float) tRecord.dfBSTAR;
+
+	stIOE.pnElement1to6[ 2 ] = (int)( tRecord.dfInclination * 1.0e5 );
+	stIOE.pnElement1to6[ 3 ] = (int)( tRecord.dfRAAN * 1.0e5 );
+	stIOE.pnElement1to6[ 1 ] = (int) floor( tRecord.dfEccentricity * 1.0e7 + 0.5 );
+	stIOE.pnElement1to6[ 4 ] = (int)( tRecord.dfArgPerigee * 1.0e5 );
+	stIOE.pnElement1to6[ 5 ] = (int)( tRecord.dfMeanAnomaly * 1.0e5 );
+	stIOE.pnElement1to6[ 0 ] = (int)( tRecord.dfMeanMotion * 1.0e8 );
+
+	// orbital period in days
+	stIOE.pfElement7to18[ 11 ] = (float) ( 1.0 / ( stIOE.pnElement1to6[ 0 ] * 1.0e-8 ) );
+
+	stIOE.cElementType = 'T';
+
+	m_nRecords++;
+
+	return stIOE.nSatelliteID > 0 && stIOE.pnElement1to6[ 0 ] > 0;
+}
+
+
+bool cOMMParser::DecodeRecord( const stOMMRecord &tRecord, stSatelliteIOE &stIOE )
+{
+	stSatelliteElements tElements;
+	bool bOK = DecodeRecord( tRecord, tElements );
+
+	stIOE.SetElements( tElements );
+
+	return bOK;
+}
+
+
+void cOMMParser::GetAttributes( const stOMMRecord &tRecord, stSatelliteAttributes &tAttributes )
+{
+	tAttributes.Line1 = tRecord.pName != NULL ? std::string( tRecord.pName, tRecord.nNameLength ) : std::string();
+	tAttributes.Line2.clear();
+	tAttributes.Line3.clear();
+}
+
+
+int cOMMParser::Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteElements> &TLEData )
+{
+	return ParseText( pBegin, pEnd, TLEData );
+}
+
+
+int cOMMParser::Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteIOE> &TLEData )
+{
+	return ParseText( pBegin, pEnd, TLEData );
+}
+
+
+int cOMMParser::Parse( cTLEStream &tStream, std::vector<stSatelliteElements> &TLEData )
+{
+	return ParseStream( tStream, TLEData );
+}
+
+
+int cOMMParser::Parse( cTLEStream &tStream, std::vector<stSatelliteIOE> &TLEData )
+{
+	return ParseStream( tStream, TLEData );
+}
+
+
+template< class T >
+int cOMMParser::ParseText( const char *pBegin, const char *pEnd, std::vector<T> &TLEData )
+{
+	size_t nSize = TLEData.size();
+
+	stOMMRecord tRecord;
+	stSatelliteElements tElements;
+	const char *pText = pBegin;
+
+	while( ( pText = NextRecord( pText, pEnd, tRecord ) ) != NULL )
+	{
+		if( !DecodeRecord( tRecord, tElements ) )
+		{
+			m_nFormatErrors++;
+			continue;
+		}
+
+		TLEData.emplace_back( tElements );
+	}
+
+	return (int) ( TLEData.size() - nSize );
+}
+
+/******************************************************************************************
+
+  Start of the last record which begins in the text, pBegin if there is none: the last
+  CCSDS_OMM_VERS line, <omm tag or CSV line
+
+*******************************************************************************************/
+
+const char *cOMMParser::FindLastRecordStart( const char *pBegin, const char *pEnd ) const
+{
+	if( pEnd - pBegin < 16 ) return pBegin;
+
+	switch( m_nFormat )
+	{
+	case OMM_FORMAT_KVN:
+		for( const char *p = pEnd - 15; p >= pBegin; p-- )
+		{
+			if( p[ 0 ] == '\n' && memcmp( p + 1, "CCSDS_OMM_VERS", 14 ) == 0 ) return p + 1;
+		}
+		break;
+
+	case OMM_FORMAT_XML:
+		for( const char *p = pEnd - 5; p >= pBegin; p-- )
+		{
+			if( p[ 0 ] == '<' && memcmp( p + 1, "omm", 3 ) == 0 && ( p[ 4 ] == '>' || IsBlank( p[ 4 ] ) ) ) return p;
+		}
+		break;
+
+	case OMM_FORMAT_CSV:
+		// the header is read with the first record
+		if( !m_bHeader ) break;
+
+		for( const char *p = pEnd - 1; p >= pBegin; p-- )
+		{
+			if( p[ 0 ] == '\n' ) return p + 1;
+		}
+		break;
+	}
+
+	return pBegin;
+}
+
+/******************************************************************************************
+
+  As cTLEParser::Parse() from a stream: the text is parsed up to the start of its last
+  record, which is kept for the next block
+
+*******************************************************************************************/
+
+template< class T >
+int cOMMParser::ParseStream( cTLEStream &tStream, std::vector<T> &TLEData )
+{
+	size_t nSize = TLEData.size();
+
+	std::vector<char> vText, vBlock;
+
+	while( tStream.Read( vBlock ) )
+	{
+		vText.insert( vText.end(), vBlock.begin(), vBlock.end() );
+
+		const char *pBegin = &vText[ 0 ], *pEnd = pBegin + vText.size();
+
+		if( m_nFormat == OMM_FORMAT_UNKNOWN ) m_nFormat = DetectFormat( pBegin, pEnd );
+
+		// the CSV header read before the first cut
+		if( m_nFormat == OMM_FORMAT_CSV && !m_bHeader && memchr( pBegin, '\n', pEnd - pBegin ) != NULL )
+		{
+			const char *pText = pBegin;
+			while( pText < pEnd && IsBlank( *pText ) ) pText++;
+			if( pText < pEnd ) pText = ReadCSVHeader( pText, pEnd );
+
+			vText.erase( vText.begin(), vText.begin() + ( pText - pBegin ) );
+			if( vText.empty() ) continue;
+
+			pBegin = &vText[ 0 ];
+			pEnd = pBegin + vText.size();
+		}
+
+		const char *pCut = FindLastRecordStart( pBegin, pEnd );
+		if( pCut == pBegin ) continue;
+
+		ParseText( pBegin, pCut, TLEData );
+		vText.erase( vText.begin(), vText.begin() + ( pCut - pBegin ) );
+	}
+
+	if( !vText.empty() ) ParseText( &vText[ 0 ], &vText[ 0 ] + vText.size(), TLEData );
+
+	return (int) ( TLEData.size() - nSize );
+}
+
+
+bool cOMMParser::ReadAll( std::vector<stSatelliteElements> &TLEData, const char *szFileName )
+{
+	return ReadFile( TLEData, szFileName );
+}
+
+
+bool cOMMParser::ReadAll( std::vector<stSatelliteIOE> &TLEData, const char *szFileName )
+{
+	return ReadFile( TLEData, szFileName );
+}
+
+
+template< class T >
+bool cOMMParser::ReadFile( std::vector<T> &TLEData, const char *szFileName )
+{
+	// each file has its own format and CSV header
+	SetFormat( OMM_FORMAT_UNKNOWN );
+
+	if( cTLEStream::IsStreamName( szFileName ) )
+	{
+		cTLEStream tStream;
+		if( !tStream.Open( szFileName ) ) return false;
+
+		ParseStream( tStream, TLEData );
+
+		return tStream.Close();
+	}
+
+	cMappedFile tFile;
+	if( !tFile.Open( szFileName ) ) return false;
+
+	ParseText( tFile.GetData(), tFile.GetData() + tFile.GetSize(), TLEData );
+
+	return true;
+}
@@ -0,0 +1,174 @@
+/***************************************************************************
+
+ CCSDS Orbit Mean-Elements Message (OMM) parser, KVN, XML and CSV
+
+ The messages are decoded in a single pass over the text, mapped or read
+ from a cTLEStream as the TLE catalogs are: the keys are looked up in a
+ fixed table and the values converted in place, the lines and tags found
+ with memchr, without std::string or a document tree. A record is a set of
+ values in a stOMMRecord, decoded into the same elements as
+ cTLEParser::DecodeRecord(), so that an OMM catalog and the TLE catalog of
+ the same element sets give the same propagators.
+
+ Format   record                                        value
+ KVN      from CCSDS_OMM_VERS to the next one           KEY = value [unit]
+ XML      from <omm to </omm>                           <KEY>value</KEY>
+ CSV      a line, the columns named by the first line   KEY,KEY,...
+
+ The catalog number is NORAD_CAT_ID, up to 9 digits, so that the numbers
+ beyond the 5 columns of a TLE are read as they are. The epoch is an
+ ISO 8601 date and time, YYYY-MM-DDThh:mm:ss.s or YYYY-DDDThh:mm:ss.s, in
+ UTC. The mean motion derivatives and BSTAR are those of the TLE, as the
+ mean elements are SGP4 ones.
+
+***************************************************************************/
+#pragma once
+
+#include <windows.h>
+#include "DataStructure.h"
+
+#include <vector>
+#include <stddef.h>
+
+class cTLEStream;
+
+// columns of a CSV line looked at, the others are skipped
+#define OMM_CSV_COLUMNS 64
+
+enum eOMMFormat
+{
+	OMM_FORMAT_UNKNOWN = 0,
+	OMM_FORMAT_KVN = 1,
+	OMM_FORMAT_XML = 2,
+	OMM_FORMAT_CSV = 3
+};
+
+// fields of a record, also bits of stOMMRecord::nFields
+enum eOMMField
+{
+	OMM_OBJECT_NAME = 0,
+	OMM_OBJECT_ID,
+	OMM_EPOCH,
+	OMM_MEAN_MOTION,
+	OMM_ECCENTRICITY,
+	OMM_INCLINATION,
+	OMM_RA_OF_ASC_NODE,
+	OMM_ARG_OF_PERICENTER,
+	OMM_MEAN_ANOMALY,
+	OMM_NORAD_CAT_ID,
+	OMM_BSTAR,
+	OMM_MEAN_MOTION_DOT,
+	OMM_MEAN_MOTION_DDOT,
+	OMM_FIELDS
+};
+
+/***************************************************************************
+
+ Values of an OMM record, the name and the international designator in
+ the text it is parsed from
+
+***************************************************************************/
+
+struct stOMMRecord
+{
+	const char *pName;
+	int nNameLength;
+	const char *pObjectID;
+	int nObjectIDLength;
+
+	int nSatelliteID;
+	double dfEpochJD;
+
+	double dfMeanMotion;		// rev/day
+	double dfEccentricity;
+	double dfInclination;		// deg
+	double dfRAAN;				// deg
+	double dfArgPerigee;		// deg
+	double dfMeanAnomaly;		// deg
+
+	double dfBSTAR;				// 1/earth radii
+	double dfMeanMotionDot;		// rev/day^2
+	double dfMeanMotionDDot;	// rev/day^3
+
+	int nFields;				// bit ( 1 << eOMMField ) of each field found
+};
+
+
+class cOMMParser
+{
+	int m_nRecords;				// records decoded
+	int m_nFormatErrors;		// records skipped for a missing or malformed value
+
+	int m_nFormat;				// eOMMFormat of the text
+
+	// field of each CSV column, -1 if not used, set from the header line
+	int m_pnColumnField[ OMM_CSV_COLUMNS ];
+	int m_nColumns;
+	bool m_bHeader;
+
+	int m_nDate;				// last epoch date as yyyymmdd or yyyyddd, and its JD at 0h
+	double m_dfDateJD;
+
+public:
+
+	cOMMParser();
+	~cOMMParser();
+
+	// format of a message from its first characters
+	static int DetectFormat( const char *pBegin, const char *pEnd );
+
+	// the format of the text to parse, the next record detects it if not set
+	void SetFormat( int nFormat );
+	int GetFormat() const { return m_nFormat; }
+
+	// next record from pText, return the start of the text after it, or NULL if there is
+	// no more record
+	const char *NextRecord( const char *pText, const char *pEnd, stOMMRecord &tRecord );
+
+	// elements of the record, as cTLEParser::DecodeRecord() gives them
+	bool DecodeRecord( const stOMMRecord &tRecord, stSatelliteElements &stIOE );
+	bool DecodeRecord( const stOMMRecord &tRecord, stSatelliteIOE &stIOE );
+
+	// object name as Line1 of the side table, Line2-3 empty
+	static void GetAttributes( const stOMMRecord &tRecord, stSatelliteAttributes &tAttributes );
+
+	// all the records of the text, appended to TLEData
+	int Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteElements> &TLEData );
+	int Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteIOE> &TLEData );
+	int Parse( cTLEStream &tStream, std::vector<stSatelliteElements> &TLEData );
+	int Parse( cTLEStream &tStream, std::vector<stSatelliteIOE> &TLEData );
+
+	// "-", *.gz, *.zst and named pipes read as streams as by cTLEParser::ReadAllTLE()
+	bool ReadAll( std::vector<stSatelliteElements> &TLEData, const char *szFileName );
+	bool ReadAll( std::vector<stSatelliteIOE> &TLEData, const char *szFileName );
+
+	int GetRecordNumber() const { return m_nRecords; }
+	int GetFormatErrors() const { return m_nFormatErrors; }
+	void ResetCounters();
+
+	// a number of the text from pText to pEnd, with or without a fraction and an exponent,
+	// leading and trailing blanks allowed
+	static bool DecodeNumber( const char *pText, const char *pEnd, double &dfValue );
+
+	// ISO 8601 date and time to JD
+	bool DecodeEpoch( const char *pText, const char *pEnd, double &dfJD );
+
+private:
+
+	template< class T >
+	int ParseText( const char *pBegin, const char *pEnd, std::vector<T> &TLEData );
+	template< class T >
+	int ParseStream( cTLEStream &tStream, std::vector<T> &TLEData );
+	template< class T >
+	bool ReadFile( std::vector<T> &TLEData, const char *szFileName );
+
+	const char *NextKVNRecord( const char *pText, const char *pEnd, stOMMRecord &tRecord );
+	const char *NextXMLRecord( const char *pText, const char *pEnd, stOMMRecord &tRecord );
+	const char *NextCSVRecord( const char *pText, const char *pEnd, stOMMRecord &tRecord );
+
+	bool SetField( stOMMRecord &tRecord, int nField, const char *pValue, const char *pValueEnd );
+	const char *ReadCSVHeader( const char *pText, const char *pEnd );
+	const char *FindLastRecordStart( const char *pBegin, const char *pEnd ) const;
+
+	static int FindField( const char *pKey, const char *pKeyEnd );
+};
@@ -0,0 +1,93 @@
+/***************************************************************************
+
+ Passes of a satellite over a station detected from a stream of samples
+
+***************************************************************************/
+#undef UNICODE
+
+#include <string.h>
+#include "PassDetector.h"
+
+
+cPassDetector::cPassDetector()
+{
+	m_nSatID = 0;
+	m_nStationID = 0;
+	m_nTrackingFacility = 0;
+	m_dfElevationMask = 0.0;
+	m_nPasses = 0;
+
+	Reset();
+}
+
+
+cPassDetector::~cPassDetector()
+{
+
+}
+
+
+void cPassDetector::SetIDs( int nSatID, int nStationID, int nTrackingFacility )
+{
+	m_nSatID = nSatID;
+	m_nStationID = nStationID;
+	m_nTrackingFacility = nTrackingFacility;
+}
+
+
+void cPassDetector::Reset()
+{
+	m_bInPass = false;
+	memset( &m_tPass, 0, sizeof( m_tPass ) );
+	m_nPasses = 0;
+}
+
+
+void cPassDetector::AddSample( double dfJD, double dfAz, double dfEl )
+{
+	if( !( dfEl > m_dfElevationMask ) )
+	{
+		AddGap( dfJD );
+		return;
+	}
+
+	stPassPoint tPoint;
+	tPoint.dfJD = dfJD;
+	tPoint.dfAz = dfAz;
+	tPoint.dfEl = dfEl;
+
+	if( !m_bInPass )
+	{
+		memset( &m_tPass, 0, sizeof( m_tPass ) );
+		m_tPass.nSatID = m_nSatID;
+		m_tPass.nStationID = m_nStationID;
+		m_tPass.nTrackingFacility = m_nTrackingFacility;
+		m_tPass.tRise = m_tPass.tTCA = tPoint;
+		m_bInPass = true;
+	}
+
+	m_tPass.tSet = tPoint;
+	if( dfEl > m_tPass.tTCA.dfEl ) m_tPass.tTCA = tPoint;
+}
+
+
+// the pass ends at its last sample, the time of the gap is not needed
+void cPassDetector::AddGap( double /* dfJD */ )
+{
+	if( m_bInPass ) EmitPass();
+}
+
+
+void cPassDetector::Finish()
+{
+	if( m_bInPass ) EmitPass();
+}
+
+
+void cPassDetector::EmitPass()
+{
+	m_bInPass = false;
+	m_nPasses++;
+
+	if( m_fOnPass ) m_fOnPass( m_tPass );
+}
@@ -0,0 +1,62 @@
+/***************************************************************************
+
+ Passes of a satellite over a station detected from a stream of samples
+
+ The samples of one (satellite, station) pair are fed one at a time in
+ increasing time. A pass starts at the first sample above the mask and
+ ends at the last one, as TerminalVisualizer::extractPasses(), and is
+ passed to the callback as soon as the next sample is below the mask. Only
+ the pass in progress is kept, so that the memory does not grow with the
+ length of the time span: a catalog keeps one detector per pair.
+
+ The rise, set and culmination are the samples themselves, to the accuracy
+ of the sampling step; cPassFinder refines them by root finding.
+
+***************************************************************************/
+#pragma once
+
+#include <windows.h>
+#include "DataStructure.h"
+
+#include <functional>
+
+class cPassDetector
+{
+	int m_nSatID, m_nStationID, m_nTrackingFacility;
+	double m_dfElevationMask;		// in radian
+
+	bool m_bInPass;
+	stVisiblePass m_tPass;			// pass in progress, tSet the last sample above the mask
+
+	std::function<void( const stVisiblePass & )> m_fOnPass;
+	int m_nPasses;					// passes emitted since the last Reset()
+
+public:
+
+	cPassDetector();
+	~cPassDetector();
+
+	// copied to the passes emitted
+	void SetIDs( int nSatID, int nStationID, int nTrackingFacility = 0 );
+	void SetElevationMask( double dfElevationMask ) { m_dfElevationMask = dfElevationMask; }
+	void SetCallback( const std::function<void( const stVisiblePass & )> &fOnPass ) { m_fOnPass = fOnPass; }
+
+	// drop the pass in progress
+	void Reset();
+
+	// dfAz and dfEl in radian, above the mask if dfEl > mask
+	void AddSample( double dfJD, double dfAz, double dfEl );
+
+	// an epoch known to be below the mask, or with no state, ends the pass in progress
+	void AddGap( double dfJD );
+
+	// end of the stream, the pass in progress is emitted cut at its last sample
+	void Finish();
+
+	bool IsInPass() const { return m_bInPass; }
+	int GetPassNumber() const { return m_nPasses; }
+
+private:
+
+	void EmitPass();
+};
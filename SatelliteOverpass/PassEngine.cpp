@@ -0,0 +1,417 @@
+/***************************************************************************
+
+ Passes of a catalog of satellites over a network of stations
+
+***************************************************************************/
+#undef UNICODE
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "PassEngine.h"
+#include "constant.h"
+
+// state of a station in a work item
+enum ePassState
+{
+	PASS_BELOW = 0,			// below the mask, or in a pass not of this item
+	PASS_OWNED = 1,			// in a pass which rose in the slice of this item
+	PASS_PREVIOUS = 2		// in a pass which rose before the slice
+};
+
+
+cPassEngine::cPassEngine()
+{
+	m_dfElevationMask = m_dfSinMask = 0.0;
+
+	m_dfSlice = 1.0;
+	m_nStepsPerRevolution = 180;
+	m_dfMinStep = 10.0;
+	m_dfMaxStep = 600.0;
+	m_dfTolerance = 0.01;
+
+	m_nEvaluations = 0;
+	m_nFailures = 0;
+	m_nWorkItems = 0;
+	m_nError = 0;
+}
+
+
+cPassEngine::~cPassEngine()
+{
+
+}
+
+
+void cPassEngine::SetStations( const std::vector<stTrackStation> &vtStations )
+{
+	m_vtSites.resize( vtStations.size() );
+
+	for( size_t i = 0; i < vtStations.size(); i++ )
+	{
+		const stTrackStation &tStation = vtStations[ i ];
+		stSite &tSite = m_vtSites[ i ];
+
+		tSite.nStationID = tStation.nSiteNo;
+		tSite.nTrackingFacility = tStation.nTrackingFacility;
+
+		double pdfSiteECEF[ 3 ] = { tStation.dfECEFX, tStation.dfECEFY, tStation.dfECEFZ };
+		tSite.tTopo.SetStation( tStation.dfLatitude, tStation.dfLongitude, pdfSiteECEF );
+		tSite.tTopo.SetElevationMask( m_dfElevationMask );
+	}
+
+	m_tFanOut.Clear();
+	for( size_t i = 0; i < m_vtSites.size(); i++ ) m_tFanOut.AddStation( m_vtSites[ i ].tTopo );
+
+	m_vvtPasses.assign( m_vtSites.size(), std::vector<stVisiblePass>() );
+}
+
+
+void cPassEngine::SetElevationMask( double dfElevationMask )
+{
+	m_dfElevationMask = dfElevationMask;
+	m_dfSinMask = sin( dfElevationMask );
+
+	for( size_t i = 0; i < m_vtSites.size(); i++ ) m_vtSites[ i ].tTopo.SetElevationMask( dfElevationMask );
+}
+
+/******************************************************************************************
+
+  Run the (satellite, slice) items on the pool and gather the passes by station
+
+  vpSatellites: initialised propagators, NULL entries skipped
+
+  return false if there is no station or the time span is empty
+
+*******************************************************************************************/
+
+bool cPassEngine::Predict( const std::vector<const cTLE2PosVel *> &vpSatellites, double dfStartJD, double dfEndJD )
+{
+	m_nEvaluations = 0;
+	m_nFailures = 0;
+	m_nWorkItems = 0;
+
+	for( size_t i = 0; i < m_vvtPasses.size(); i++ ) m_vvtPasses[ i ].clear();
+
+	if( m_vtSites.empty() || dfEndJD <= dfStartJD || m_dfSlice <= 0.0 )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	int nSlices = std::max( 1, (int) ceil( ( dfEndJD - dfStartJD ) / m_dfSlice - 1.0e-9 ) );
+	int nSatellites = (int) vpSatellites.size();
+
+	// the boundaries computed the same way by the two items which share them
+	auto SliceJD = [&]( int nSlice )
+	{
+		return nSlice >= nSlices ? dfEndJD : dfStartJD + nSlice * m_dfSlice;
+	};
+
+	m_nWorkItems = nSatellites * nSlices;
+	std::vector< std::vector<stVisiblePass> > vvtItemPasses( m_nWorkItems );
+
+	m_tPool.Run( m_nWorkItems, [&]( int nItem, int )
+	{
+		const cTLE2PosVel *pSat = vpSatellites[ nItem / nSlices ];
+		if( pSat == NULL || !pSat->IsInitialised() ) return;
+
+		int nSlice = nItem % nSlices;
+		RunItem( *pSat, SliceJD( nSlice ), SliceJD( nSlice + 1 ), nSlice == 0, dfEndJD, vvtItemPasses[ nItem ] );
+	} );
+
+	// nStationID holds the index of the station in the items
+	for( int nItem = 0; nItem < m_nWorkItems; nItem++ )
+	{
+		for( size_t k = 0; k < vvtItemPasses[ nItem ].size(); k++ )
+		{
+			stVisiblePass &tPass = vvtItemPasses[ nItem ][ k ];
+			int nSite = tPass.nStationID;
+
+			tPass.nStationID = m_vtSites[ nSite ].nStationID;
+			m_vvtPasses[ nSite ].push_back( tPass );
+		}
+	}
+
+	for( size_t i = 0; i < m_vvtPasses.size(); i++ )
+	{
+		std::sort( m_vvtPasses[ i ].begin(), m_vvtPasses[ i ].end(),
+				   []( const stVisiblePass &a, const stVisiblePass &b )
+				   {
+					   if( a.tRise.dfJD != b.tRise.dfJD ) return a.tRise.dfJD < b.tRise.dfJD;
+					   if( a.nSatID != b.nSatID ) return a.nSatID < b.nSatID;
+					   return a.tSet.dfJD < b.tSet.dfJD;
+				   } );
+	}
+
+	return true;
+}
+
+/******************************************************************************************
+
+  One work item: sample the satellite from the start of the slice, evaluate all the
+  stations at each sample, and refine the crossings of the stations whose elevation
+  changed side of the mask. After the end of the slice only the passes of the item are
+  followed, to their set or to dfEndJD.
+
+*******************************************************************************************/
+
+void cPassEngine::RunItem( const cTLE2PosVel &tSat, double dfSliceStartJD, double dfSliceEndJD, bool bFirstSlice,
+						   double dfEndJD, std::vector<stVisiblePass> &vtPasses )
+{
+	stItemContext tItem;
+	tItem.nEvaluations = 0;
+
+	if( !WalkSlice( tSat, tItem, dfSliceStartJD, dfSliceEndJD, bFirstSlice, dfEndJD, vtPasses ) ) m_nFailures++;
+
+	m_nEvaluations += tItem.nEvaluations;
+}
+
+
+bool cPassEngine::WalkSlice( const cTLE2PosVel &tSat, stItemContext &tItem, double dfSliceStartJD,
+							 double dfSliceEndJD, bool bFirstSlice, double dfEndJD, std::vector<stVisiblePass> &vtPasses )
+{
+	int nSites = (int) m_vtSites.size();
+
+	double pdfTLE[ 10 ];
+	tSat.GetTLE( pdfTLE );
+
+	double dfStep = pdfTLE[ 9 ] > 0.0 ? 86400.0 / pdfTLE[ 9 ] / m_nStepsPerRevolution : m_dfMaxStep;
+	dfStep = std::min( std::max( dfStep, m_dfMinStep ), m_dfMaxStep ) / 86400.0;
+
+	std::vector<double> vdfF( nSites ), vdfNextF( nSites ), vdfRiseJD( nSites );
+	std::vector<int> vnState( nSites );
+	double pdfPos[ 3 ];
+
+	double dfJD = dfSliceStartJD;
+	if( !ComputePosition( tSat, tItem, dfJD, pdfPos ) ) return false;
+
+	m_tFanOut.ComputeSinElevation( 1, pdfPos, &vdfF[ 0 ] );
+
+	int nOwned = 0;
+	for( int i = 0; i < nSites; i++ )
+	{
+		vdfF[ i ] -= m_dfSinMask;
+		vnState[ i ] = vdfF[ i ] < 0.0 ? PASS_BELOW : bFirstSlice ? PASS_OWNED : PASS_PREVIOUS;
+		vdfRiseJD[ i ] = dfJD;
+		if( vnState[ i ] == PASS_OWNED ) nOwned++;
+	}
+
+	while( dfJD < dfEndJD && ( dfJD < dfSliceEndJD || nOwned > 0 ) )
+	{
+		double dfNextJD = std::min( dfJD + dfStep, dfJD < dfSliceEndJD ? dfSliceEndJD : dfEndJD );
+
+		if( !ComputePosition( tSat, tItem, dfNextJD, pdfPos ) ) return false;
+
+		m_tFanOut.ComputeSinElevation( 1, pdfPos, &vdfNextF[ 0 ] );
+
+		for( int i = 0; i < nSites; i++ )
+		{
+			vdfNextF[ i ] -= m_dfSinMask;
+
+			bool bAbove = vdfNextF[ i ] >= 0.0;
+			if( bAbove == ( vdfF[ i ] >= 0.0 ) ) continue;
+
+			if( bAbove )
+			{
+				// rises after the end of the slice belong to the next item
+				if( dfJD >= dfSliceEndJD || vnState[ i ] != PASS_BELOW ) continue;
+
+				if( !FindCrossing( tSat, tItem, m_vtSites[ i ], dfJD, vdfF[ i ], dfNextJD, vdfNextF[ i ], vdfRiseJD[ i ] ) )
+					return false;
+
+				vnState[ i ] = PASS_OWNED;
+				nOwned++;
+			}
+			else if( vnState[ i ] == PASS_OWNED )
+			{
+				double dfSetJD;
+				if( !FindCrossing( tSat, tItem, m_vtSites[ i ], dfJD, vdfF[ i ], dfNextJD, vdfNextF[ i ], dfSetJD ) ||
+					!AddPass( tSat, tItem, i, vdfRiseJD[ i ], dfSetJD, vtPasses ) ) return false;
+
+				vnState[ i ] = PASS_BELOW;
+				nOwned--;
+			}
+			else vnState[ i ] = PASS_BELOW;
+		}
+
+		vdfF.swap( vdfNextF );
+		dfJD = dfNextJD;
+	}
+
+	// passes in progress at the end of the time span
+	for( int i = 0; i < nSites && nOwned > 0; i++ )
+	{
+		if( vnState[ i ] != PASS_OWNED ) continue;
+
+		if( !AddPass( tSat, tItem, i, vdfRiseJD[ i ], dfEndJD, vtPasses ) ) return false;
+		nOwned--;
+	}
+
+	return true;
+}
+
+
+bool cPassEngine::ComputePosition( const cTLE2PosVel &tSat, stItemContext &tItem, double dfJD, double *pdfPos )
+{
+	double pdfVel[ 3 ];
+
+	tItem.nEvaluations++;
+
+	return tSat.ComputeECEFPosVel( dfJD, pdfPos, pdfVel, tItem.tWork );
+}
+
+
+double cPassEngine::ComputeSinElevation( const stSite &tSite, const double *pdfPos ) const
+{
+	double dfRange;
+
+	return tSite.tTopo.ComputeSinElevation( pdfPos, dfRange );
+}
+
+/******************************************************************************************
+
+  Time, azimuth and elevation of the satellite, as cPassFinder::ComputePassPoint()
+
+*******************************************************************************************/
+
+bool cPassEngine::ComputePassPoint( const cTLE2PosVel &tSat, stItemContext &tItem, const stSite &tSite,
+									double dfJD, stPassPoint &tPoint )
+{
+	double pdfPos[ 3 ];
+	if( !ComputePosition( tSat, tItem, dfJD, pdfPos ) ) return false;
+
+	double dfRange;
+
+	tPoint.dfJD = dfJD;
+	tSite.tTopo.ComputeAzElRange( pdfPos, tPoint.dfAz, tPoint.dfEl, dfRange );
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Time the elevation of the station crosses the mask between two samples of opposite
+  signs of dfF = sin( elevation ) - sin( mask ), by the Illinois variant of the regula
+  falsi, which halves the value kept at the end not moved twice in a row
+
+*******************************************************************************************/
+
+bool cPassEngine::FindCrossing( const cTLE2PosVel &tSat, stItemContext &tItem, const stSite &tSite,
+								double dfJD0, double dfF0, double dfJD1, double dfF1, double &dfJD )
+{
+	// time from dfJD0 in second, to keep the resolution of the tolerance
+	double dfA = 0.0, dfB = ( dfJD1 - dfJD0 ) * 86400.0;
+	double dfFA = dfF0, dfFB = dfF1;
+	double dfC = dfB, dfLastC = dfA;
+	int nSide = 0;
+
+	for( int nIter = 0; nIter < 100; nIter++ )
+	{
+		if( dfB - dfA <= m_dfTolerance || fabs( dfC - dfLastC ) <= 0.5 * m_dfTolerance ) break;
+
+		dfLastC = dfC;
+		dfC = ( dfA * dfFB - dfB * dfFA ) / ( dfFB - dfFA );
+		if( !( dfC > dfA && dfC < dfB ) ) dfC = 0.5 * ( dfA + dfB );
+
+		double pdfPos[ 3 ];
+		if( !ComputePosition( tSat, tItem, dfJD0 + dfC / 86400.0, pdfPos ) ) return false;
+
+		double dfFC = ComputeSinElevation( tSite, pdfPos ) - m_dfSinMask;
+
+		if( ( dfFC >= 0.0 ) == ( dfFB >= 0.0 ) )
+		{
+			dfB = dfC;
+			dfFB = dfFC;
+			if( nSide == -1 ) dfFA *= 0.5;
+			nSide = -1;
+		}
+		else
+		{
+			dfA = dfC;
+			dfFA = dfFC;
+			if( nSide == 1 ) dfFB *= 0.5;
+			nSide = 1;
+		}
+	}
+
+	dfJD = dfJD0 + dfC / 86400.0;
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Culmination between the rise and the set, by a golden section search of the largest
+  elevation
+
+*******************************************************************************************/
+
+bool cPassEngine::FindTCA( const cTLE2PosVel &tSat, stItemContext &tItem, const stSite &tSite,
+						   double dfRiseJD, double dfSetJD, double &dfJD )
+{
+	const double dfRatio = 0.5 * ( sqrt( 5.0 ) - 1.0 );
+
+	double dfA = 0.0, dfB = ( dfSetJD - dfRiseJD ) * 86400.0;
+	double dfX1 = dfB - dfRatio * ( dfB - dfA ), dfX2 = dfA + dfRatio * ( dfB - dfA );
+	double pdfPos[ 3 ];
+
+	if( !ComputePosition( tSat, tItem, dfRiseJD + dfX1 / 86400.0, pdfPos ) ) return false;
+	double dfF1 = ComputeSinElevation( tSite, pdfPos );
+	if( !ComputePosition( tSat, tItem, dfRiseJD + dfX2 / 86400.0, pdfPos ) ) return false;
+	double dfF2 = ComputeSinElevation( tSite, pdfPos );
+
+	while( dfB - dfA > m_dfTolerance )
+	{
+		if( dfF1 < dfF2 )
+		{
+			dfA = dfX1;
+			dfX1 = dfX2;
+			dfF1 = dfF2;
+			dfX2 = dfA + dfRatio * ( dfB - dfA );
+
+			if( !ComputePosition( tSat, tItem, dfRiseJD + dfX2 / 86400.0, pdfPos ) ) return false;
+			dfF2 = ComputeSinElevation( tSite, pdfPos );
+		}
+		else
+		{
+			dfB = dfX2;
+			dfX2 = dfX1;
+			dfF2 = dfF1;
+			dfX1 = dfB - dfRatio * ( dfB - dfA );
+
+			if( !ComputePosition( tSat, tItem, dfRiseJD + dfX1 / 86400.0, pdfPos ) ) return false;
+			dfF1 = ComputeSinElevation( tSite, pdfPos );
+		}
+	}
+
+	dfJD = dfRiseJD + 0.5 * ( dfA + dfB ) / 86400.0;
+
+	return true;
+}
+
+
+bool cPassEngine::AddPass( const cTLE2PosVel &tSat, stItemContext &tItem, int nSite, double dfRiseJD,
+						   double dfSetJD, std::vector<stVisiblePass> &vtPasses )
+{
+	const stSite &tSite = m_vtSites[ nSite ];
+
+	double pdfTLE[ 10 ];
+	tSat.GetTLE( pdfTLE );
+
+	stVisiblePass tPass;
+	memset( &tPass, 0, sizeof( tPass ) );
+	tPass.nSatID = (int) pdfTLE[ 0 ];
+	tPass.nStationID = nSite;
+	tPass.nTrackingFacility = tSite.nTrackingFacility;
+
+	double dfTCAJD;
+	if( !FindTCA( tSat, tItem, tSite, dfRiseJD, dfSetJD, dfTCAJD ) ||
+		!ComputePassPoint( tSat, tItem, tSite, dfRiseJD, tPass.tRise ) ||
+		!ComputePassPoint( tSat, tItem, tSite, dfTCAJD, tPass.tTCA ) ||
+		!ComputePassPoint( tSat, tItem, tSite, dfSetJD, tPass.tSet ) ) return false;
+
+	vtPasses.push_back( tPass );
+
+	return true;
+}
@@ -0,0 +1,124 @@
+/***************************************************************************
+
+ Passes of a catalog of satellites over a network of stations
+
+ The time span is cut into slices, and each (satellite, slice) pair is a
+ work item of a cWorkStealingPool. An item propagates its satellite once
+ per sample and evaluates the elevation of every station from that state
+ by a cSiteFanOut, so that the propagation is shared by the stations. The
+ samples are taken at a step of a fixed fraction of the orbital period,
+ and the mask crossings found between two samples are refined by the
+ regula falsi and the culmination by a golden section search, for that
+ station only.
+
+ A pass belongs to the slice it rises in: an item goes on past the end of
+ its slice until its passes have set, and skips the passes in progress at
+ the start of its slice, which the previous item has. The boundaries of
+ the slices are samples of both items, so that the two see the same sign
+ of the elevation there. Each item writes its passes to its own list, and
+ the passes of a station are gathered and sorted by rise time, then by
+ satellite, so that the result does not depend on the threads.
+
+ The items of a GEO satellite take fewer samples than those of a LEO one,
+ and deep space satellites propagate slower; the pool balances the cost.
+ Passes shorter than the sampling step may be missed.
+
+***************************************************************************/
+#pragma once
+
+#include "TLE2PosVel.h"
+#include "DataStructure.h"
+#include "SiteFanOut.h"
+#include "TopocentricSite.h"
+#include "WorkStealingPool.h"
+
+#include <atomic>
+#include <vector>
+
+class cPassEngine
+{
+	// station and its horizon frame
+	struct stSite
+	{
+		int nStationID;
+		int nTrackingFacility;
+		cTopocentricSite tTopo;
+	};
+
+	// what a work item keeps to itself
+	struct stItemContext
+	{
+		stSGP4WorkArea tWork;
+		long long nEvaluations;
+	};
+
+	std::vector<stSite> m_vtSites;
+	cSiteFanOut m_tFanOut;			// the same stations, for the samples
+	double m_dfElevationMask, m_dfSinMask;		// in radian
+
+	double m_dfSlice;				// length of a time slice, in day
+	int m_nStepsPerRevolution;		// samples per orbital period
+	double m_dfMinStep, m_dfMaxStep;	// bounds of the sampling step, in second
+	double m_dfTolerance;			// accuracy of the rise, set and TCA times, in second
+
+	cWorkStealingPool m_tPool;
+
+	std::vector< std::vector<stVisiblePass> > m_vvtPasses;		// by station
+
+	std::atomic<long long> m_nEvaluations;		// SGP4 calls of the last Predict()
+	std::atomic<int> m_nFailures;				// items stopped by an SGP4 failure
+	int m_nWorkItems;
+	int m_nError;
+
+public:
+
+	cPassEngine();
+	~cPassEngine();
+
+	// dfLatitude and dfLongitude in radian, dfECEFX/Y/Z in meter, the passes of station i
+	// go to GetPasses( i ) with nStationID = nSiteNo
+	void SetStations( const std::vector<stTrackStation> &vtStations );
+	void SetElevationMask( double dfElevationMask );
+
+	void SetTimeSlice( double dfSlice ) { m_dfSlice = dfSlice; }
+	void SetStepsPerRevolution( int nSteps ) { m_nStepsPerRevolution = nSteps; }
+	void SetStepBounds( double dfMinStep, double dfMaxStep ) { m_dfMinStep = dfMinStep; m_dfMaxStep = dfMaxStep; }
+	void SetTolerance( double dfTolerance ) { m_dfTolerance = dfTolerance; }
+
+	// threads of the pool, 0 for one per core
+	void SetThreadNumber( int nThreads ) { m_tPool.SetThreadNumber( nThreads ); }
+
+	// passes of the initialised satellites over all the stations in [dfStartJD, dfEndJD],
+	// a pass in progress at either end is cut at that end; the passes found by the items
+	// of a satellite before an SGP4 failure are kept
+	bool Predict( const std::vector<const cTLE2PosVel *> &vpSatellites, double dfStartJD, double dfEndJD );
+
+	int GetStationNumber() const { return (int) m_vtSites.size(); }
+
+	// passes over station i in increasing rise time
+	const std::vector<stVisiblePass> &GetPasses( int nStation ) const { return m_vvtPasses[ nStation ]; }
+
+	long long GetEvaluationNumber() const { return m_nEvaluations; }
+	int GetFailureNumber() const { return m_nFailures; }
+	int GetWorkItemNumber() const { return m_nWorkItems; }
+	int GetStolenNumber() const { return m_tPool.GetStolenNumber(); }
+
+private:
+
+	void RunItem( const cTLE2PosVel &tSat, double dfSliceStartJD, double dfSliceEndJD, bool bFirstSlice,
+				  double dfEndJD, std::vector<stVisiblePass> &vtPasses );
+	bool WalkSlice( const cTLE2PosVel &tSat, stItemContext &tItem, double dfSliceStartJD, double dfSliceEndJD,
+					bool bFirstSlice, double dfEndJD, std::vector<stVisiblePass> &vtPasses );
+
+	bool ComputePosition( const cTLE2PosVel &tSat, stItemContext &tItem, double dfJD, double *pdfPos );
+	double ComputeSinElevation( const stSite &tSite, const double *pdfPos ) const;
+	bool ComputePassPoint( const cTLE2PosVel &tSat, stItemContext &tItem, const stSite &tSite, double dfJD,
+						   stPassPoint &tPoint );
+
+	bool FindCrossing( const cTLE2PosVel &tSat, stItemContext &tItem, const stSite &tSite, double dfJD0,
+					   double dfF0, double dfJD1, double dfF1, double &dfJD );
+	bool FindTCA( const cTLE2PosVel &tSat, stItemContext &tItem, const stSite &tSite, double dfRiseJD,
+				  double dfSetJD, double &dfJD );
+	bool AddPass( const cTLE2PosVel &tSat, stItemContext &tItem, int nSite, double dfRiseJD, double dfSetJD,
+				  std::vector<stVisiblePass> &vtPasses );
+};
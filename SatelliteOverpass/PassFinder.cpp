@@ -0,0 +1,506 @@
+/***************************************************************************
+
+ Satellite passes over a station by root finding
+
+***************************************************************************/
+#undef UNICODE
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "PassFinder.h"
+#include "constant.h"
+
+
+cPassFinder::cPassFinder()
+{
+	m_nStationID = 0;
+
+	m_dfTolerance = 0.01;
+	m_dfMinStep = 2.0;
+
+	m_dfMaxSpeed = 0.0;
+	m_dfMaxAccel = 0.0;
+	m_dfMaxAngleRate = 0.0;
+	m_dfMinRange = 0.0;
+	m_dfVisibleAngle = g_dfPI;
+	m_dfInsideAngle = 0.0;
+	m_bPreFilter = true;
+	m_nEvaluations = 0;
+	m_nError = 0;
+}
+
+
+cPassFinder::~cPassFinder()
+{
+
+}
+
+
+void cPassFinder::SetStation( int nStationID, double dfLat, double dfLon, const double *pdfSiteECEF )
+{
+	m_nStationID = nStationID;
+
+	m_tSite.SetStation( dfLat, dfLon, pdfSiteECEF );
+	m_tFilter.SetStation( pdfSiteECEF );
+}
+
+
+// the elevation mask of tSite is kept
+void cPassFinder::SetStation( int nStationID, const cTopocentricSite &tSite )
+{
+	m_nStationID = nStationID;
+
+	m_tSite = tSite;
+	m_tFilter.SetStation( tSite.GetECEF() );
+	m_tFilter.SetElevationMask( tSite.GetElevationMask() );
+}
+
+
+void cPassFinder::SetElevationMask( double dfElevationMask )
+{
+	m_tSite.SetElevationMask( dfElevationMask );
+	m_tFilter.SetElevationMask( dfElevationMask );
+}
+
+/******************************************************************************************
+
+  Find the passes of a satellite over the station
+
+  tSat: initialised propagator computing the velocity too
+  vtPasses: the passes found are appended, nSatID from the TLE, dfBenifit 0 and
+            no sun lit data
+
+  return false if SGP4 fails in the time span, the passes found up to the failure
+  are kept
+
+*******************************************************************************************/
+
+bool cPassFinder::FindPasses( const cTLE2PosVel &tSat, double dfStartJD, double dfEndJD,
+							  std::vector<stVisiblePass> &vtPasses )
+{
+	m_nEvaluations = 0;
+
+	if( !tSat.IsInitialised() || tSat.IsComputePositionOnly() || dfEndJD <= dfStartJD )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	double pdfTLE[ 10 ];
+	tSat.GetTLE( pdfTLE );
+
+	// largest ECEF speed: inertial speed at perigee plus the earth rotation at apogee,
+	// 5% added for the periodic terms the mean perigee and apogee do not include
+	double dfPerigeeHeight, dfApogeeHeight;
+	tSat.GetPerigeeApogeeHeights( dfPerigeeHeight, dfApogeeHeight );
+	double dfRP = g_dfEarthSemiMajor + std::max( dfPerigeeHeight, 0.0 );
+	double dfRA = g_dfEarthSemiMajor + std::max( dfApogeeHeight, 0.0 );
+	m_dfMaxSpeed = 1.05 * ( sqrt( g_dfEarthGM * ( 2.0 / dfRP - 2.0 / ( dfRP + dfRA ) ) ) + 
+							g_dfEarthAngVelocity * dfRA );
+	m_dfMaxAngleRate = m_dfMaxSpeed / ( 0.98 * dfRP );
+
+	// largest ECEF acceleration: gravity 10% above the central term 2% below the perigee,
+	// the Coriolis and the centrifugal terms
+	m_dfMaxAccel = 1.1 * g_dfEarthGM / ( 0.98 * dfRP ) / ( 0.98 * dfRP ) +
+				   2.0 * g_dfEarthAngVelocity * m_dfMaxSpeed + g_dfEarthAngVelocity * g_dfEarthAngVelocity * dfRA;
+
+	// central angle of a satellite at the mask, cos( angle + mask ) = s / r * cos( mask ),
+	// at 1% above the apogee and below the perigee, with 0.01 radian for the difference 
+	// of the geodetic and geocentric verticals
+	const double *pdfSite = m_tSite.GetECEF();
+	double dfSite = sqrt( pdfSite[ 0 ] * pdfSite[ 0 ] + pdfSite[ 1 ] * pdfSite[ 1 ] + pdfSite[ 2 ] * pdfSite[ 2 ] );
+	double dfMask = m_tSite.GetElevationMask();
+	double dfCos = std::min( dfSite * cos( dfMask ) / ( 1.01 * dfRA ), 1.0 );
+	m_dfVisibleAngle = acos( dfCos ) - dfMask + 0.01;
+	dfCos = std::min( dfSite * cos( dfMask ) / ( 0.99 * dfRP ), 1.0 );
+	m_dfInsideAngle = acos( dfCos ) - dfMask - 0.01;
+
+	// the range is never below the height of the satellite over the station, 2% below the perigee
+	m_dfMinRange = 0.98 * dfRP - dfSite;
+
+	// spans the satellite may be above the mask in, from the geometric pre-filter
+	std::vector<double> vdfSpans;
+	if( m_bPreFilter )
+	{
+		int nFilterEvaluations = m_tFilter.GetEvaluationNumber();
+		m_tFilter.GetCandidateSpans( tSat, dfStartJD, dfEndJD, vdfSpans );
+		m_nEvaluations += m_tFilter.GetEvaluationNumber() - nFilterEvaluations;
+	}
+	else
+	{
+		vdfSpans.push_back( dfStartJD );
+		vdfSpans.push_back( dfEndJD );
+	}
+
+	stSGP4WorkArea tWork;
+
+	double dfMinStep = m_dfMinStep / 86400.0;
+	double dfSinMask = m_tSite.GetSinMask();
+
+	double dfJD = dfStartJD, dfSinEl = 0.0, dfRange = 0.0, dfAngle = 0.0, dfRate = 0.0, dfRangeRate = 0.0;
+	double dfRiseJD = dfStartJD;
+	bool bInPass = false;
+
+	for( size_t nSpan = 0; nSpan < vdfSpans.size(); nSpan += 2 )
+	{
+		// the walk goes on from where it is when a pass ran over the end of the last span
+		if( nSpan == 0 || dfJD < vdfSpans[ nSpan ] )
+		{
+			dfJD = vdfSpans[ nSpan ];
+			if( !ComputeSinElevation( tSat, tWork, dfJD, dfSinEl, dfRange, &dfAngle, &dfRate, &dfRangeRate ) ) 
+				return false;
+
+			bInPass = dfSinEl >= dfSinMask;
+			dfRiseJD = dfJD;
+		}
+
+		while( dfJD < vdfSpans[ nSpan + 1 ] || ( bInPass && dfJD < dfEndJD ) )
+		{
+			double dfStep = SafeStep( dfSinEl, dfRate, dfRange, dfRangeRate, dfAngle );
+			double dfNextJD = std::min( dfJD + std::max( dfStep, dfMinStep ), bInPass ? dfEndJD : vdfSpans[ nSpan + 1 ] );
+
+			double dfNextSinEl, dfNextRange, dfNextAngle, dfNextRate, dfNextRangeRate;
+			if( !ComputeSinElevation( tSat, tWork, dfNextJD, dfNextSinEl, dfNextRange, &dfNextAngle, &dfNextRate,
+									  &dfNextRangeRate ) ) return false;
+
+			bool bAbove = dfNextSinEl >= dfSinMask;
+
+			if( bAbove != bInPass )
+			{
+				double dfCrossJD;
+				if( !FindCrossing( tSat, tWork, dfJD, dfSinEl - dfSinMask, dfNextJD, dfNextSinEl - dfSinMask, dfCrossJD ) )
+					return false;
+
+				if( bAbove )
+				{
+					dfRiseJD = dfCrossJD;
+				}
+				else
+				{
+					stVisiblePass tPass;
+					memset( &tPass, 0, sizeof( tPass ) );
+					tPass.nSatID = (int) pdfTLE[ 0 ];
+					tPass.nStationID = m_nStationID;
+
+					double dfTCAJD;
+					if( !FindTCA( tSat, tWork, dfRiseJD, dfCrossJD, dfTCAJD ) ||
+						!ComputePassPoint( tSat, tWork, dfRiseJD, tPass.tRise ) ||
+						!ComputePassPoint( tSat, tWork, dfTCAJD, tPass.tTCA ) ||
+						!ComputePassPoint( tSat, tWork, dfCrossJD, tPass.tSet ) ) return false;
+
+					vtPasses.push_back( tPass );
+				}
+
+				bInPass = bAbove;
+			}
+
+			dfJD = dfNextJD;
+			dfSinEl = dfNextSinEl;
+			dfRange = dfNextRange;
+			dfAngle = dfNextAngle;
+			dfRate = dfNextRate;
+			dfRangeRate = dfNextRangeRate;
+		}
+	}
+
+	// pass in progress at the end of the time span
+	if( bInPass && dfJD >= dfEndJD )
+	{
+		stVisiblePass tPass;
+		memset( &tPass, 0, sizeof( tPass ) );
+		tPass.nSatID = (int) pdfTLE[ 0 ];
+		tPass.nStationID = m_nStationID;
+
+		double dfTCAJD;
+		if( !FindTCA( tSat, tWork, dfRiseJD, dfEndJD, dfTCAJD ) ||
+			!ComputePassPoint( tSat, tWork, dfRiseJD, tPass.tRise ) ||
+			!ComputePassPoint( tSat, tWork, dfTCAJD, tPass.tTCA ) ||
+			!ComputePassPoint( tSat, tWork, dfEndJD, tPass.tSet ) ) return false;
+
+		vtPasses.push_back( tPass );
+	}
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Sine of the elevation and the range of the satellite from the station, the earth
+  central angle between the geodetic vertical of the station and the satellite, the
+  rate of the sine of the elevation in 1/s and the rate of the range in m/s
+
+*******************************************************************************************/
+
+bool cPassFinder::ComputeSinElevation( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfJD,
+									   double &dfSinEl, double &dfRange, double *pdfCentralAngle,
+									   double *pdfSinElRate, double *pdfRangeRate )
+{
+	double pdfPos[ 3 ], pdfVel[ 3 ];
+
+	m_nEvaluations++;
+	if( !tSat.ComputeECEFPosVel( dfJD, pdfPos, pdfVel, tWork ) )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	dfSinEl = m_tSite.ComputeSinElevation( pdfPos, dfRange );
+
+	if( pdfSinElRate != NULL )
+	{
+		double pdfDelta[ 3 ];
+		m_tSite.ComputeDelta( pdfPos, pdfDelta );
+
+		double dfHeightRate = m_tSite.ProjectUp( pdfVel );
+		double dfRangeRate = ( pdfDelta[ 0 ] * pdfVel[ 0 ] + pdfDelta[ 1 ] * pdfVel[ 1 ] + pdfDelta[ 2 ] * pdfVel[ 2 ] ) / dfRange;
+		*pdfSinElRate = ( dfHeightRate - dfSinEl * dfRangeRate ) / dfRange;
+		if( pdfRangeRate != NULL ) *pdfRangeRate = dfRangeRate;
+	}
+
+	if( pdfCentralAngle == NULL ) return true;
+
+	double dfUp = m_tSite.ProjectUp( pdfPos );
+	double dfR = sqrt( pdfPos[ 0 ] * pdfPos[ 0 ] + pdfPos[ 1 ] * pdfPos[ 1 ] + pdfPos[ 2 ] * pdfPos[ 2 ] );
+	*pdfCentralAngle = acos( std::max( -1.0, std::min( dfUp / dfR, 1.0 ) ) );
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Time, azimuth and elevation of the satellite, as cCoorTrans::DeltaXYZ_to_EleAzi()
+
+*******************************************************************************************/
+
+bool cPassFinder::ComputePassPoint( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfJD,
+									stPassPoint &tPoint )
+{
+	double pdfPos[ 3 ], pdfVel[ 3 ];
+
+	m_nEvaluations++;
+	if( !tSat.ComputeECEFPosVel( dfJD, pdfPos, pdfVel, tWork ) )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	double dfRange;
+
+	tPoint.dfJD = dfJD;
+	m_tSite.ComputeAzElRange( pdfPos, tPoint.dfAz, tPoint.dfEl, dfRange );
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Longest step in day the satellite can not cross the mask within
+
+  Out of the band of central angles the mask can be crossed in, the central angle
+  changes by at most the largest angle rate. In the band, two bounds are used:
+
+  - with the range kept above half its value, i.e. dt < range / 2v, the second
+    derivative of sin( E ) = h / range is below M = 2a / range' + 5v^2 / range'^2,
+    range' = range / 2, and the mask is not reached before the root of 
+    |dS| + r * dt - M * dt^2 / 2, r being the rate of sin( E ) away from the mask;
+  - the line of sight turns by at most the integral of v / range, with the range 
+    shrinking at most by v, which is -ln( 1 - v * dt / range ), and the elevation
+    difference is at least the difference of the sines.
+
+  Anywhere, the height over the plane of the mask, g = h - sin( mask ) * range, 
+  crosses zero with the mask. As h'' = a.up and range'' <= a + v^2 / range, its 
+  second derivative is below a * ( 1 + |sin( mask )| ) + |sin( mask )| * v^2 / range'
+  for a range kept above range', and the step is the root of |g| + g' * dt - G * dt^2 / 2
+  as above. Unlike the central angle, it does not need the largest angle rate, so it
+  gives the longer steps when the satellite moves across the line of sight.
+
+  The longest of the steps is taken.
+
+*******************************************************************************************/
+
+double cPassFinder::SafeStep( double dfSinEl, double dfSinElRate, double dfRange, double dfRangeRate,
+							  double dfCentralAngle ) const
+{
+	double dfSinMask = m_tSite.GetSinMask();
+	double dfStep = PlaneStep( dfRange * ( dfSinEl - dfSinMask ), dfRange * dfSinElRate + dfRangeRate * ( dfSinEl - dfSinMask ),
+							   dfRange );
+
+	if( dfCentralAngle > m_dfVisibleAngle ) 
+		return std::max( dfStep, ( dfCentralAngle - m_dfVisibleAngle ) / m_dfMaxAngleRate ) / 86400.0;
+
+	if( dfCentralAngle < m_dfInsideAngle ) 
+		return std::max( dfStep, ( m_dfInsideAngle - dfCentralAngle ) / m_dfMaxAngleRate ) / 86400.0;
+
+	double dfDelta = fabs( dfSinEl - dfSinMask );
+	double dfRate = dfSinEl >= dfSinMask ? dfSinElRate : -dfSinElRate;
+
+	double dfHalfRange = 0.5 * dfRange;
+	double dfM = 2.0 * m_dfMaxAccel / dfHalfRange + 5.0 * m_dfMaxSpeed * m_dfMaxSpeed / dfHalfRange / dfHalfRange;
+	double dfElStep = ( dfRate + sqrt( dfRate * dfRate + 2.0 * dfM * dfDelta ) ) / dfM;
+	dfElStep = std::min( dfElStep, dfHalfRange / m_dfMaxSpeed );
+
+	dfStep = std::max( dfStep, dfElStep );
+	dfStep = std::max( dfStep, ( 1.0 - exp( -dfDelta ) ) * dfRange / m_dfMaxSpeed );
+
+	return dfStep / 86400.0;
+}
+
+/******************************************************************************************
+
+  Step in second the height dfG over the plane of the mask, rate dfGRate, can not
+  cross zero within, the range kept above a quarter, half or three quarters of its
+  value, or the least range of the orbit which needs no limit on the step, the 
+  longest of them taken
+
+*******************************************************************************************/
+
+double cPassFinder::PlaneStep( double dfG, double dfGRate, double dfRange ) const
+{
+	double dfSinMask = fabs( m_tSite.GetSinMask() );
+	double dfRate = dfG >= 0.0 ? dfGRate : -dfGRate;
+	double pdfMinRange[ 4 ] = { 0.25 * dfRange, 0.5 * dfRange, 0.75 * dfRange, m_dfMinRange };
+
+	double dfStep = 0.0;
+	for( int i = 0; i < 4; i++ )
+	{
+		if( pdfMinRange[ i ] <= 0.0 || pdfMinRange[ i ] > dfRange ) continue;
+
+		double dfG2 = m_dfMaxAccel * ( 1.0 + dfSinMask ) + dfSinMask * m_dfMaxSpeed * m_dfMaxSpeed / pdfMinRange[ i ];
+		double dfRangeStep = ( dfRate + sqrt( dfRate * dfRate + 2.0 * dfG2 * fabs( dfG ) ) ) / dfG2;
+		if( i < 3 ) dfRangeStep = std::min( dfRangeStep, ( dfRange - pdfMinRange[ i ] ) / m_dfMaxSpeed );
+
+		dfStep = std::max( dfStep, dfRangeStep );
+	}
+
+	return dfStep;
+}
+
+/******************************************************************************************
+
+  Time the sine of the elevation crosses the mask between two JDs of opposite signs of
+  dfF = sin( elevation ) - sin( mask ), by Brent's method, or, for bRate, the time its
+  rate crosses zero between two JDs of opposite rates
+
+*******************************************************************************************/
+
+bool cPassFinder::FindCrossing( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfJD0, double dfF0,
+								double dfJD1, double dfF1, double &dfJD, bool bRate )
+{
+	// time from dfJD0 in second, to keep the resolution of the tolerance
+	double dfA = 0.0, dfB = ( dfJD1 - dfJD0 ) * 86400.0, dfC = dfB;
+	double dfFA = dfF0, dfFB = dfF1, dfFC = dfFB;
+	double dfD = 0.0, dfE = 0.0;
+
+	for( int nIter = 0; nIter < 100; nIter++ )
+	{
+		if( ( dfFB > 0.0 && dfFC > 0.0 ) || ( dfFB < 0.0 && dfFC < 0.0 ) )
+		{
+			dfC = dfA;
+			dfFC = dfFA;
+			dfE = dfD = dfB - dfA;
+		}
+
+		if( fabs( dfFC ) < fabs( dfFB ) )
+		{
+			dfA = dfB; dfB = dfC; dfC = dfA;
+			dfFA = dfFB; dfFB = dfFC; dfFC = dfFA;
+		}
+
+		double dfTol = 0.5 * m_dfTolerance;
+		double dfXM = 0.5 * ( dfC - dfB );
+
+		if( fabs( dfXM ) <= dfTol || dfFB == 0.0 )
+		{
+			dfJD = dfJD0 + dfB / 86400.0;
+			return true;
+		}
+
+		if( fabs( dfE ) >= dfTol && fabs( dfFA ) > fabs( dfFB ) )
+		{
+			// inverse quadratic interpolation, or secant when only two points
+			double dfP, dfQ, dfR, dfS = dfFB / dfFA;
+
+			if( dfA == dfC )
+			{
+				dfP = 2.0 * dfXM * dfS;
+				dfQ = 1.0 - dfS;
+			}
+			else
+			{
+				dfQ = dfFA / dfFC;
+				dfR = dfFB / dfFC;
+				dfP = dfS * ( 2.0 * dfXM * dfQ * ( dfQ - dfR ) - ( dfB - dfA ) * ( dfR - 1.0 ) );
+				dfQ = ( dfQ - 1.0 ) * ( dfR - 1.0 ) * ( dfS - 1.0 );
+			}
+
+			if( dfP > 0.0 ) dfQ = -dfQ;
+			dfP = fabs( dfP );
+
+			double dfMin1 = 3.0 * dfXM * dfQ - fabs( dfTol * dfQ );
+			double dfMin2 = fabs( dfE * dfQ );
+
+			if( 2.0 * dfP < std::min( dfMin1, dfMin2 ) )
+			{
+				dfE = dfD;
+				dfD = dfP / dfQ;
+			}
+			else
+			{
+				dfD = dfXM;
+				dfE = dfD;
+			}
+		}
+		else
+		{
+			// bisection
+			dfD = dfXM;
+			dfE = dfD;
+		}
+
+		dfA = dfB;
+		dfFA = dfFB;
+
+		if( fabs( dfD ) > dfTol ) dfB += dfD;
+		else dfB += dfXM > 0.0 ? dfTol : -dfTol;
+
+		double dfSinEl, dfRange, dfRate;
+		if( !ComputeSinElevation( tSat, tWork, dfJD0 + dfB / 86400.0, dfSinEl, dfRange, NULL, &dfRate ) ) return false;
+		dfFB = bRate ? dfRate : dfSinEl - m_tSite.GetSinMask();
+	}
+
+	dfJD = dfJD0 + dfB / 86400.0;
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Time of the largest elevation between the rise and the set, where the rate of the 
+  elevation changes from positive to negative, or the rise or set time for a pass cut
+  by the time span
+
+*******************************************************************************************/
+
+bool cPassFinder::FindTCA( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfRiseJD, double dfSetJD,
+						   double &dfJD )
+{
+	double dfSinEl, dfRange, dfRiseRate, dfSetRate;
+
+	if( !ComputeSinElevation( tSat, tWork, dfRiseJD, dfSinEl, dfRange, NULL, &dfRiseRate ) ||
+		!ComputeSinElevation( tSat, tWork, dfSetJD, dfSinEl, dfRange, NULL, &dfSetRate ) ) return false;
+
+	if( dfRiseRate <= 0.0 ) 
+	{
+		dfJD = dfRiseJD;
+		return true;
+	}
+
+	if( dfSetRate >= 0.0 ) 
+	{
+		dfJD = dfSetJD;
+		return true;
+	}
+
+	return FindCrossing( tSat, tWork, dfRiseJD, dfRiseRate, dfSetJD, dfSetRate, dfJD, true );
+}
@@ -0,0 +1,103 @@
+/***************************************************************************
+
+ Satellite passes over a station by root finding
+
+ Instead of sampling the elevation at a fixed step, the time axis is walked
+ with a step which the satellite can not cross the elevation mask within.
+ The earth central angle between the station and the satellite changes by
+ at most v / r per second, v being the largest ECEF speed of the orbit, and
+ the satellite can only cross the mask between the central angles of the
+ mask at the perigee and at the apogee height. Between them, the sine of
+ the elevation moves from its value and rate at the last epoch by at most
+ M * t^2 / 2, M bounding its second derivative from the largest speed and
+ acceleration, and the line of sight turns at most by v / range per second.
+ Anywhere, the height over the plane of the mask can only change at the
+ rate it has and by the largest acceleration. The longest step is taken.
+ The horizon crossings found this way are refined by Brent's method to get
+ the rise and set times, and the culmination (TCA) as the root of the rate of
+ the elevation between them.
+
+ The search is restricted to the time spans cVisibilityFilter can not rule
+ out. Passes shorter than the minimum step may be missed.
+
+ Over two days at a station of latitude 33 deg, the ISS takes 5.6 times
+ fewer SGP4 calls than a 1 minute step (6.2 times without the pre-filter)
+ and a Molniya orbit 10 times. The 10 times asked for low orbits is not
+ met: the bounds must hold for the largest speed and acceleration of the
+ orbit, so a revolution still takes about ten steps, and each pass about
+ a dozen calls for the rise, set and TCA.
+
+ Reference: Press et al., Numerical Recipes, 9.3 Van Wijngaarden-Dekker-Brent
+            Method
+
+***************************************************************************/
+#pragma once
+
+#include "TLE2PosVel.h"
+#include "DataStructure.h"
+#include "TopocentricSite.h"
+#include "VisibilityFilter.h"
+
+#include <vector>
+
+class cPassFinder
+{
+	int m_nStationID;
+	cTopocentricSite m_tSite;		// with the elevation mask
+
+	double m_dfTolerance;		// accuracy of the rise, set and TCA times, in second
+	double m_dfMinStep;			// smallest search step, in second
+
+	double m_dfMaxSpeed;		// largest ECEF speed of the satellite, in m/s
+	double m_dfMaxAccel;		// largest ECEF acceleration, in m/s^2
+	double m_dfMaxAngleRate;	// largest rate of its geocentric direction, in radian/s
+	double m_dfMinRange;		// least range from the station, in m
+	double m_dfVisibleAngle;	// earth central angle from the station beyond which it is
+								// below the mask at any height of the orbit, in radian
+	double m_dfInsideAngle;		// central angle within which it is above the mask at any
+								// height of the orbit, in radian
+
+	cVisibilityFilter m_tFilter;
+	bool m_bPreFilter;			// search only the spans the filter can not rule out
+
+	int m_nEvaluations;			// SGP4 calls made by the last FindPasses(), filter included
+	int m_nError;
+
+public:
+
+	cPassFinder();
+	~cPassFinder();
+
+	// dfLat, dfLon: geodetic latitude and longitude in radian, pdfSiteECEF in meter
+	void SetStation( int nStationID, double dfLat, double dfLon, const double *pdfSiteECEF );
+	void SetStation( int nStationID, const cTopocentricSite &tSite );
+	void SetElevationMask( double dfElevationMask );
+	void SetTolerance( double dfTolerance ) { m_dfTolerance = dfTolerance; }
+	void SetMinStep( double dfMinStep ) { m_dfMinStep = dfMinStep; }
+	void SetPreFilter( bool bState ) { m_bPreFilter = bState; }
+
+	// passes in [dfStartJD, dfEndJD] appended to vtPasses, a pass in progress at either
+	// end is cut at that end
+	bool FindPasses( const cTLE2PosVel &tSat, double dfStartJD, double dfEndJD,
+					 std::vector<stVisiblePass> &vtPasses );
+
+	int GetEvaluationNumber() const { return m_nEvaluations; }
+	const cVisibilityFilter &GetFilter() const { return m_tFilter; }
+
+private:
+
+	bool ComputeSinElevation( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfJD,
+							  double &dfSinEl, double &dfRange, double *pdfCentralAngle = NULL,
+							  double *pdfSinElRate = NULL, double *pdfRangeRate = NULL );
+	bool ComputePassPoint( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfJD, stPassPoint &tPoint );
+
+	double SafeStep( double dfSinEl, double dfSinElRate, double dfRange, double dfRangeRate,
+					 double dfCentralAngle ) const;
+	double PlaneStep( double dfG, double dfGRate, double dfRange ) const;
+
+	// bRate: root of the rate of sin( elevation ) instead of sin( elevation ) - sin( mask )
+	bool FindCrossing( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfJD0, double dfF0,
+					   double dfJD1, double dfF1, double &dfJD, bool bRate = false );
+	bool FindTCA( const cTLE2PosVel &tSat, stSGP4WorkArea &tWork, double dfRiseJD, double dfSetJD,
+				  double &dfJD );
+};
@@ -0,0 +1,795 @@
+/***************************************************************************
+
+ Batched SGP4 propagation of many satellites to a common epoch
+
+ The near-earth part follows cTLE2PosVel::SGP4() line by line. Any change
+ made there must be made here as well.
+
+***************************************************************************/
+#undef UNICODE
+
+#include <math.h>
+#include <cmath>
+#include "SGP4Batch.h"
+#include "GreenwichSiderealTime.h"
+#include "constant.h"
+
+/******************************************************************************************
+
+  angle reduced into (-2PI, 2PI) with the sign of the input, as fmod() does, but in a
+  form which can be vectorised
+
+*******************************************************************************************/
+
+template< class T >
+static inline T ReduceTwoPI( T tAngle )
+{
+	return tAngle - (T) g_dfTWOPI * std::trunc( tAngle / (T) g_dfTWOPI );
+}
+
+
+cSGP4Batch::cSGP4Batch()
+{
+	m_dfEarthGM = 0.0;
+	m_dfJ2 = 0.0;
+	m_df2O3 = 0.0;
+	m_dfEarthRadius = 0.0;
+	m_dfVelocityChange = 0.0;
+
+	m_nSatellites = 0;
+	m_bPosOnly = false;
+	m_nError = 0;
+}
+
+
+cSGP4Batch::~cSGP4Batch()
+{
+
+}
+
+
+void cSGP4Batch::Clear()
+{
+	m_vtNearEarth.clear();
+	m_vpDeepSpace.clear();
+	m_vtDeepSpaceWork.clear();
+	m_vnDeepSpaceIndex.clear();
+	m_nSatellites = 0;
+	m_nError = 0;
+}
+
+/******************************************************************************************
+
+  Add an initialised satellite to the batch
+
+  return the index of the satellite in the output arrays, -1 if the satellite
+  is not initialised
+
+*******************************************************************************************/
+
+int cSGP4Batch::AddSatellite( const cTLE2PosVel &tSat )
+{
+	if( !tSat.m_bInit )
+	{
+		m_nError = 1;
+		return -1;
+	}
+
+	SetConstants( tSat );
+
+	int nIndex = m_nSatellites++;
+
+	if( tSat.m_bDeepSpace )
+	{
+		m_vpDeepSpace.push_back( &tSat );
+		m_vtDeepSpaceWork.push_back( stSGP4WorkArea() );
+		m_vnDeepSpaceIndex.push_back( nIndex );
+		return nIndex;
+	}
+
+	if( m_vtNearEarth.empty() || m_vtNearEarth.back().nLanes == SGP4_BATCH_LANES )
+	{
+		m_vtNearEarth.push_back( stSGP4NearEarthBlock() );
+		stSGP4NearEarthBlock &tBlock = m_vtNearEarth.back();
+		tBlock.nLanes = 0;
+
+		// unused lanes carry the first satellite, so that they compute valid numbers
+		for( int i = 0; i < SGP4_BATCH_LANES; i++ ) FillLane( tBlock, i, tSat, nIndex );
+	}
+
+	stSGP4NearEarthBlock &tBlock = m_vtNearEarth.back();
+	FillLane( tBlock, tBlock.nLanes, tSat, nIndex );
+	tBlock.nLanes++;
+
+	return nIndex;
+}
+
+/******************************************************************************************
+
+  Take the earth constants used by the kernel from a propagator
+
+*******************************************************************************************/
+
+void cSGP4Batch::SetConstants( const cTLE2PosVel &tSat )
+{
+	m_dfEarthGM = tSat.m_dfEarthGM;
+	m_dfJ2 = tSat.m_dfJ2;
+	m_df2O3 = tSat.m_df2O3;
+	m_dfEarthRadius = tSat.m_dfEarthRadius;
+	m_dfVelocityChange = tSat.m_dfVelocityChange;
+}
+
+/******************************************************************************************
+
+  Copy the near-earth coefficients of a satellite into one lane of a block
+
+*******************************************************************************************/
+
+void cSGP4Batch::FillLane( stSGP4NearEarthBlock &tBlock, int nLane, const cTLE2PosVel &tSat, int nIndex )
+{
+	int i = nLane;
+
+	tBlock.pdfRefJD[ i ] = tSat.m_dfRefJD;
+
+	tBlock.pdfEcc0[ i ] = tSat.m_dfEcc0;
+	tBlock.pdfInc0[ i ] = tSat.m_dfInc0;
+	tBlock.pdfRAAN0[ i ] = tSat.m_dfRAAN0;
+	tBlock.pdfPerigee0[ i ] = tSat.m_dfPerigee0;
+	tBlock.pdfMA0[ i ] = tSat.m_dfMA0;
+	tBlock.pdfMM0[ i ] = tSat.m_dfMM0;
+	tBlock.pdfBSTAR[ i ] = tSat.m_dfBSTAR;
+	tBlock.pdfSinI0[ i ] = tSat.m_dfSinI0;
+	tBlock.pdfCosI0[ i ] = tSat.m_dfCosI0;
+	tBlock.pdfSMTerm[ i ] = pow( tSat.m_dfEarthGM / tSat.m_dfMM0, tSat.m_df2O3 );
+
+	tBlock.pdfMMDot[ i ] = tSat.m_dfMMDot;
+	tBlock.pdfPerigeeDot[ i ] = tSat.m_dfPerigeeDot;
+	tBlock.pdfRAANDot[ i ] = tSat.m_dfRAANDot;
+
+	tBlock.pdfRAANDot2Drag[ i ] = tSat.m_dfRAANDot2Drag;
+	tBlock.pdfCC1[ i ] = tSat.m_dfCC1;
+	tBlock.pdfCC4[ i ] = tSat.m_dfCC4;
+	tBlock.pdfT2Coe[ i ] = tSat.m_dfT2Coe;
+
+	tBlock.pdfAYCOF[ i ] = tSat.m_dfAYCOF;
+	tBlock.pdfXLCOF[ i ] = tSat.m_dfXLCOF;
+	tBlock.pdfCon41[ i ] = tSat.m_dfCon41;
+	tBlock.pdfX1MTH2[ i ] = tSat.m_dfX1MTH2;
+	tBlock.pdfX7THM1[ i ] = tSat.m_dfX7THM1;
+
+	tBlock.pnIndex[ i ] = nIndex;
+
+	// perigee height < 220km, the higher order drag terms are not used
+	if( tSat.m_bOrbitLowHigh )
+	{
+		tBlock.pdfPerigeeDotDrag[ i ] = 0.0;
+		tBlock.pdfMMDotDrag[ i ] = 0.0;
+		tBlock.pdfCC5[ i ] = 0.0;
+		tBlock.pdfEta[ i ] = 0.0;
+		tBlock.pdfDeltaMA0[ i ] = 1.0;
+		tBlock.pdfSinMAO[ i ] = 0.0;
+		tBlock.pdfD2[ i ] = tBlock.pdfD3[ i ] = tBlock.pdfD4[ i ] = 0.0;
+		tBlock.pdfT3Coe[ i ] = tBlock.pdfT4Coe[ i ] = tBlock.pdfT5Coe[ i ] = 0.0;
+		return;
+	}
+
+	tBlock.pdfPerigeeDotDrag[ i ] = tSat.m_dfPerigeeDotDrag;
+	tBlock.pdfMMDotDrag[ i ] = tSat.m_dfMMDotDrag;
+	tBlock.pdfCC5[ i ] = tSat.m_dfCC5;
+	tBlock.pdfEta[ i ] = tSat.m_dfEta;
+	tBlock.pdfDeltaMA0[ i ] = tSat.m_dfDeltaMA0;
+	tBlock.pdfSinMAO[ i ] = tSat.m_dfSinMAO;
+	tBlock.pdfD2[ i ] = tSat.m_dfD2;
+	tBlock.pdfD3[ i ] = tSat.m_dfD3;
+	tBlock.pdfD4[ i ] = tSat.m_dfD4;
+	tBlock.pdfT3Coe[ i ] = tSat.m_dfT3Coe;
+	tBlock.pdfT4Coe[ i ] = tSat.m_dfT4Coe;
+	tBlock.pdfT5Coe[ i ] = tSat.m_dfT5Coe;
+}
+
+/******************************************************************************************
+
+  Compute the inertial (TEME) position and velocity of all satellites at the given JD
+
+  pdfPos: satellite positions in meter, 3 values per satellite
+  pdfVel: satellite velocities in meter/s, 3 values per satellite, not used when
+          only positions are computed
+  pbValid: true if the satellite is propagated successfully, may be NULL
+
+  return false if any satellite fails
+
+*******************************************************************************************/
+
+bool cSGP4Batch::ComputeInertialPosVel( double dfJD, double *pdfPos, double *pdfVel, bool *pbValid )
+{
+	if( dfJD < 0.0 || pdfPos == NULL || ( !m_bPosOnly && pdfVel == NULL ) )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	bool bAllValid = true;
+
+	double pdfT[ SGP4_BATCH_LANES ];
+	double pdfP[ 3 * SGP4_BATCH_LANES ], pdfV[ 3 * SGP4_BATCH_LANES ];
+	bool pbOK[ SGP4_BATCH_LANES ];
+
+	for( size_t n = 0; n < m_vtNearEarth.size(); n++ )
+	{
+		const stSGP4NearEarthBlock &tBlock = m_vtNearEarth[ n ];
+
+		for( int i = 0; i < SGP4_BATCH_LANES; i++ ) pdfT[ i ] = ( dfJD - tBlock.pdfRefJD[ i ] ) * 1440.0;
+
+		PropagateNearEarthBlock( tBlock, pdfT, pdfP, pdfV, pbOK );
+
+		// scatter the lanes back to the order of the satellites
+		for( int i = 0; i < tBlock.nLanes; i++ )
+		{
+			int nIndex = tBlock.pnIndex[ i ];
+
+			for( int k = 0; k < 3; k++ )
+			{
+				pdfPos[ 3 * nIndex + k ] = pdfP[ k * SGP4_BATCH_LANES + i ];
+				if( !m_bPosOnly ) pdfVel[ 3 * nIndex + k ] = pdfV[ k * SGP4_BATCH_LANES + i ];
+			}
+
+			if( pbValid != NULL ) pbValid[ nIndex ] = pbOK[ i ];
+			if( !pbOK[ i ] ) bAllValid = false;
+		}
+	}
+
+	double pdfDummy[ 3 ];
+
+	for( size_t n = 0; n < m_vpDeepSpace.size(); n++ )
+	{
+		int nIndex = m_vnDeepSpaceIndex[ n ];
+		double *pdfSatVel = m_bPosOnly ? pdfDummy : pdfVel + 3 * nIndex;
+
+		bool bOK = m_vpDeepSpace[ n ]->ComputeInertialPosVel( dfJD, pdfPos + 3 * nIndex, pdfSatVel,
+															  m_vtDeepSpaceWork[ n ] );
+
+		if( pbValid != NULL ) pbValid[ nIndex ] = bOK;
+		if( !bOK ) bAllValid = false;
+	}
+
+	if( !bAllValid ) m_nError = 1;
+
+	return bAllValid;
+}
+
+/******************************************************************************************
+
+  Compute the ECEF position and velocity of all satellites at the given JD
+
+  The Greenwich sidereal time is computed once for the whole batch.
+
+*******************************************************************************************/
+
+bool cSGP4Batch::ComputeECEFPosVel( double dfJD, double *pdfPos, double *pdfVel, bool *pbValid )
+{
+	bool bAllValid = ComputeInertialPosVel( dfJD, pdfPos, pdfVel, pbValid );
+
+	if( pdfPos == NULL || ( !m_bPosOnly && pdfVel == NULL ) ) return false;
+
+	double dfGST = cGreenwichST::ComputeGST( dfJD );
+	double dfSin = sin( dfGST ), dfCos = cos( dfGST );
+
+	for( int n = 0; n < m_nSatellites; n++ )
+	{
+		double *pdfP = pdfPos + 3 * n;
+		double dfX =  pdfP[ 0 ] * dfCos + pdfP[ 1 ] * dfSin;
+		double dfY = -pdfP[ 0 ] * dfSin + pdfP[ 1 ] * dfCos;
+		pdfP[ 0 ] = dfX;
+		pdfP[ 1 ] = dfY;
+
+		if( m_bPosOnly ) continue;
+
+		double *pdfV = pdfVel + 3 * n;
+		double dfVX =  pdfV[ 0 ] * dfCos + pdfV[ 1 ] * dfSin + dfY * g_dfEarthAngVelocity;
+		double dfVY = -pdfV[ 0 ] * dfSin + pdfV[ 1 ] * dfCos - dfX * g_dfEarthAngVelocity;
+		pdfV[ 0 ] = dfVX;
+		pdfV[ 1 ] = dfVY;
+	}
+
+	return bAllValid;
+}
+
+/******************************************************************************************
+
+  Compute the inertial (TEME) position and velocity of one satellite at an array of JDs
+
+  pdfJD: epochs, in time order for the best efficiency of the deep space integrator
+  pdfPos: satellite positions in meter, 3 values per epoch
+  pdfVel: satellite velocities in meter/s, 3 values per epoch, not used when only
+          positions are computed
+  pbValid: true if the satellite is propagated successfully at the epoch, may be NULL
+
+  The batch's own satellites are not used. A near-earth satellite is copied into all
+  lanes of one block and the lanes take consecutive epochs.
+
+*******************************************************************************************/
+
+bool cSGP4Batch::ComputeInertialPosVelSeries( const cTLE2PosVel &tSat, int nEpochs, const double *pdfJD,
+											  double *pdfPos, double *pdfVel, bool *pbValid )
+{
+	// an empty series is a successful no-op, its epoch array may be NULL
+	if( !tSat.m_bInit || nEpochs < 0 || ( nEpochs > 0 && pdfJD == NULL ) || pdfPos == NULL || 
+		( !m_bPosOnly && pdfVel == NULL ) )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	bool bAllValid = true;
+
+	if( tSat.m_bDeepSpace )
+	{
+		stSGP4WorkArea tWork;
+		double pdfDummy[ 3 ];
+
+		for( int n = 0; n < nEpochs; n++ )
+		{
+			double *pdfSatVel = m_bPosOnly ? pdfDummy : pdfVel + 3 * n;
+			bool bOK = pdfJD[ n ] >= 0.0 &&
+					   tSat.ComputeInertialPosVel( pdfJD[ n ], pdfPos + 3 * n, pdfSatVel, tWork );
+
+			if( pbValid != NULL ) pbValid[ n ] = bOK;
+			if( !bOK ) bAllValid = false;
+		}
+
+		if( !bAllValid ) m_nError = 1;
+
+		return bAllValid;
+	}
+
+	SetConstants( tSat );
+
+	stSGP4NearEarthBlock tBlock;
+	for( int i = 0; i < SGP4_BATCH_LANES; i++ ) FillLane( tBlock, i, tSat, 0 );
+
+	double dfRefJD = tSat.m_dfRefJD;
+	double pdfT[ SGP4_BATCH_LANES ];
+	double pdfP[ 3 * SGP4_BATCH_LANES ], pdfV[ 3 * SGP4_BATCH_LANES ];
+	bool pbOK[ SGP4_BATCH_LANES ];
+
+	for( int n0 = 0; n0 < nEpochs; n0 += SGP4_BATCH_LANES )
+	{
+		int nLanes = nEpochs - n0 < SGP4_BATCH_LANES ? nEpochs - n0 : SGP4_BATCH_LANES;
+
+		// the lanes after the last epoch repeat it
+		for( int i = 0; i < SGP4_BATCH_LANES; i++ ) 
+			pdfT[ i ] = ( pdfJD[ n0 + ( i < nLanes ? i : nLanes - 1 ) ] - dfRefJD ) * 1440.0;
+
+		PropagateNearEarthBlock( tBlock, pdfT, pdfP, pdfV, pbOK );
+
+		for( int i = 0; i < nLanes; i++ )
+		{
+			int n = n0 + i;
+
+			for( int k = 0; k < 3; k++ )
+			{
+				pdfPos[ 3 * n + k ] = pdfP[ k * SGP4_BATCH_LANES + i ];
+				if( !m_bPosOnly ) pdfVel[ 3 * n + k ] = pdfV[ k * SGP4_BATCH_LANES + i ];
+			}
+
+			bool bOK = pbOK[ i ] && pdfJD[ n ] >= 0.0;
+			if( pbValid != NULL ) pbValid[ n ] = bOK;
+			if( !bOK ) bAllValid = false;
+		}
+	}
+
+	if( !bAllValid ) m_nError = 1;
+
+	return bAllValid;
+}
+
+/******************************************************************************************
+
+  Compute the ECEF position and velocity of one satellite at an array of JDs
+
+  The GST of all epochs is computed in one pass before the rotation.
+
+*******************************************************************************************/
+
+bool cSGP4Batch::ComputeECEFPosVelSeries( const cTLE2PosVel &tSat, int nEpochs, const double *pdfJD,
+										  double *pdfPos, double *pdfVel, bool *pbValid )
+{
+	if( nEpochs == 0 ) m_tGrid.Clear();
+	else if( !m_tGrid.SetEpochs( nEpochs, pdfJD ) )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	return ComputeECEFPosVelSeries( tSat, m_tGrid, pdfPos, pdfVel, pbValid );
+}
+
+/******************************************************************************************
+
+  Compute the ECEF position and velocity of one satellite at all epochs of a time grid,
+  with the earth rotation of the grid
+
+*******************************************************************************************/
+
+bool cSGP4Batch::ComputeECEFPosVelSeries( const cTLE2PosVel &tSat, const cTimeGrid &tGrid,
+										  double *pdfPos, double *pdfVel, bool *pbValid )
+{
+	int nEpochs = tGrid.GetEpochNumber();
+
+	bool bAllValid = ComputeInertialPosVelSeries( tSat, nEpochs, tGrid.GetJD(), pdfPos, pdfVel, pbValid );
+
+	if( nEpochs <= 0 || pdfPos == NULL || ( !m_bPosOnly && pdfVel == NULL ) ) 
+		return bAllValid;
+
+	for( int n = 0; n < nEpochs; n++ )
+		tGrid.FromInertialToECEF( n, pdfPos + 3 * n, m_bPosOnly ? NULL : pdfVel + 3 * n );
+
+	return bAllValid;
+}
+
+/******************************************************************************************
+
+  Compute the ECEF position and velocity of all satellites at epoch nEpoch of a time grid
+
+*******************************************************************************************/
+
+bool cSGP4Batch::ComputeECEFPosVel( const cTimeGrid &tGrid, int nEpoch, double *pdfPos, double *pdfVel, 
+									bool *pbValid )
+{
+	if( nEpoch < 0 || nEpoch >= tGrid.GetEpochNumber() )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	bool bAllValid = ComputeInertialPosVel( tGrid.GetJD( nEpoch ), pdfPos, pdfVel, pbValid );
+
+	if( pdfPos == NULL || ( !m_bPosOnly && pdfVel == NULL ) ) return false;
+
+	for( int n = 0; n < m_nSatellites; n++ )
+		tGrid.FromInertialToECEF( nEpoch, pdfPos + 3 * n, m_bPosOnly ? NULL : pdfVel + 3 * n );
+
+	return bAllValid;
+}
+
+/******************************************************************************************
+
+  Near-earth SGP4 for one block of satellites
+
+  pdfT: time since epoch of each lane, in minute
+  pdfPos, pdfVel: output by component, pdfPos[ k * SGP4_BATCH_LANES + lane ]
+  pbValid: false for the lanes which fail
+
+*******************************************************************************************/
+
+void cSGP4Batch::PropagateNearEarthBlock( const stSGP4NearEarthBlock &tBlock, const double *pdfT,
+										  double *pdfPos, double *pdfVel, bool *pbValid ) const
+{
+	stSGP4Lanes< double, SGP4_BATCH_LANES > tLanes;
+
+	SecularTerms( tBlock, pdfT, m_dfEarthGM, tLanes, 0 );
+	PeriodicTerms( tLanes, m_dfJ2, m_dfEarthGM, m_dfEarthRadius, m_dfVelocityChange, m_bPosOnly, pdfPos, pdfVel );
+
+	for( int i = 0; i < SGP4_BATCH_LANES; i++ ) pbValid[ i ] = tLanes.pbValid[ i ];
+}
+
+/******************************************************************************************
+
+  Compute the reduced precision ECEF position of all satellites at the given JD
+
+  pfPos: satellite positions in meter, 3 values per satellite
+  pbValid: true if the satellite is propagated successfully, may be NULL
+
+  The secular terms, which grow with time, are computed in double. The periodic terms,
+  the Kepler equation and the rotation to ECEF are computed in float over two blocks 
+  at a time. Deep space satellites are computed in double and rounded.
+
+  Position error against the double path: below 20 m at any time span. Measured on
+  66 random samples of 1000 near-earth orbits each (66000 orbits) of 300 to 2000 km
+  perigee height, eccentricity up to 0.2, any inclination and BSTAR up to 5e-4, over
+  the half day before 1, 3 and 7 days from the epoch: the largest error was 18.9 m,
+  the largest of a sample 14.5 to 18.9 m, with no trend between the three spans.
+
+  The error comes from the float resolution of the angles near 2PI (5e-7 rad, 4 m
+  at 8000 km) in the Kepler equation and the argument of latitude, it does not grow
+  with the time span since the secular terms are in double. It is meant for 
+  screening, candidates within 20 m of a threshold should be recomputed with 
+  ComputeECEFPosVel().
+
+*******************************************************************************************/
+
+bool cSGP4Batch::ComputeECEFPositionFloat( double dfJD, float *pfPos, bool *pbValid )
+{
+	if( dfJD < 0.0 || pfPos == NULL )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	const int L = 2 * SGP4_BATCH_LANES;
+
+	bool bAllValid = true;
+
+	double dfGST = cGreenwichST::ComputeGST( dfJD );
+	float fSin = (float) sin( dfGST ), fCos = (float) cos( dfGST );
+
+	stSGP4Lanes< float, L > tLanes;
+	double pdfT[ SGP4_BATCH_LANES ];
+	float pfP[ 3 * L ];
+
+	for( size_t n = 0; n < m_vtNearEarth.size(); n += 2 )
+	{
+		// the second half repeats the first block when the number of blocks is odd
+		const stSGP4NearEarthBlock *ptBlock[ 2 ];
+		ptBlock[ 0 ] = &m_vtNearEarth[ n ];
+		ptBlock[ 1 ] = n + 1 < m_vtNearEarth.size() ? &m_vtNearEarth[ n + 1 ] : ptBlock[ 0 ];
+
+		for( int m = 0; m < 2; m++ )
+		{
+			for( int i = 0; i < SGP4_BATCH_LANES; i++ ) pdfT[ i ] = ( dfJD - ptBlock[ m ]->pdfRefJD[ i ] ) * 1440.0;
+			SecularTerms( *ptBlock[ m ], pdfT, m_dfEarthGM, tLanes, m * SGP4_BATCH_LANES );
+		}
+
+		PeriodicTerms( tLanes, (float) m_dfJ2, (float) m_dfEarthGM, (float) m_dfEarthRadius, 
+					   (float) m_dfVelocityChange, true, pfP, (float*) NULL );
+
+		int nBlocks = n + 1 < m_vtNearEarth.size() ? 2 : 1;
+
+		for( int m = 0; m < nBlocks; m++ )
+		{
+			for( int i = 0; i < ptBlock[ m ]->nLanes; i++ )
+			{
+				int nLane = m * SGP4_BATCH_LANES + i;
+				int nIndex = ptBlock[ m ]->pnIndex[ i ];
+
+				float fX = pfP[ nLane ], fY = pfP[ nLane + L ];
+				pfPos[ 3 * nIndex ]     =  fX * fCos + fY * fSin;
+				pfPos[ 3 * nIndex + 1 ] = -fX * fSin + fY * fCos;
+				pfPos[ 3 * nIndex + 2 ] = pfP[ nLane + 2 * L ];
+
+				if( pbValid != NULL ) pbValid[ nIndex ] = tLanes.pbValid[ nLane ];
+				if( !tLanes.pbValid[ nLane ] ) bAllValid = false;
+			}
+		}
+	}
+
+	double pdfPos[ 3 ], pdfVel[ 3 ];
+
+	for( size_t n = 0; n < m_vpDeepSpace.size(); n++ )
+	{
+		int nIndex = m_vnDeepSpaceIndex[ n ];
+
+		bool bOK = m_vpDeepSpace[ n ]->ComputeECEFPosVel( dfJD, pdfPos, pdfVel, m_vtDeepSpaceWork[ n ] );
+		for( int k = 0; k < 3; k++ ) pfPos[ 3 * nIndex + k ] = (float) pdfPos[ k ];
+
+		if( pbValid != NULL ) pbValid[ nIndex ] = bOK;
+		if( !bOK ) bAllValid = false;
+	}
+
+	if( !bAllValid ) m_nError = 1;
+
+	return bAllValid;
+}
+
+/******************************************************************************************
+
+  Secular gravity and drag terms of one block, always computed in double since the 
+  angles grow with time
+
+  tLanes: mean elements at the given time, the angles reduced into (-2PI, 2PI), stored 
+          from lane nOffset on and rounded to T
+
+*******************************************************************************************/
+
+template< class T, int L >
+void cSGP4Batch::SecularTerms( const stSGP4NearEarthBlock &tBlock, const double *pdfT, double dfEarthGM,
+							   stSGP4Lanes< T, L > &tLanes, int nOffset )
+{
+	const stSGP4NearEarthBlock &B = tBlock;
+
+	for( int i = 0; i < SGP4_BATCH_LANES; i++ )
+	{
+		int j = nOffset + i;
+
+		double dfT = pdfT[ i ];
+		double dfT2 = dfT * dfT;
+		double dfT3 = dfT2 * dfT;
+		double dfT4 = dfT3 * dfT;
+
+		double dfMAS = B.pdfMA0[ i ] + B.pdfMMDot[ i ] * dfT;
+		double dfPerigeeS = B.pdfPerigee0[ i ] + B.pdfPerigeeDot[ i ] * dfT;
+		double dfRAANS = B.pdfRAAN0[ i ] + B.pdfRAANDot[ i ] * dfT;
+
+		double dfDeltaMA = 1.0 + B.pdfEta[ i ] * cos( dfMAS );
+		dfDeltaMA = B.pdfMMDotDrag[ i ] * ( dfDeltaMA * dfDeltaMA * dfDeltaMA - B.pdfDeltaMA0[ i ] );
+		double dfTemp = B.pdfPerigeeDotDrag[ i ] * dfT + dfDeltaMA;
+
+		double dfMAM = dfMAS + dfTemp;
+		double dfPerigeeM = dfPerigeeS - dfTemp;
+		double dfRAANM = dfRAANS + B.pdfRAANDot2Drag[ i ] * dfT2;
+
+		double dfTempA = 1.0 - B.pdfCC1[ i ] * dfT - B.pdfD2[ i ] * dfT2 - B.pdfD3[ i ] * dfT3 - B.pdfD4[ i ] * dfT4;
+		double dfTempE = B.pdfBSTAR[ i ] * B.pdfCC4[ i ] * dfT +
+						 B.pdfBSTAR[ i ] * B.pdfCC5[ i ] * ( sin( dfMAM ) - B.pdfSinMAO[ i ] );
+		double dfTempL = B.pdfT2Coe[ i ] * dfT2 + B.pdfT3Coe[ i ] * dfT3 + dfT4 * ( B.pdfT4Coe[ i ] + dfT * B.pdfT5Coe[ i ] );
+
+		double dfSMM = B.pdfSMTerm[ i ] * dfTempA * dfTempA;
+
+		double dfEccM = B.pdfEcc0[ i ] - dfTempE;
+		tLanes.pbValid[ j ] = ( dfEccM < 1.0 && dfEccM >= -1.0e-3 );
+		dfEccM = dfEccM < 0.0 ? 1.e-6 : dfEccM;
+
+		dfMAM += B.pdfMM0[ i ] * dfTempL;
+
+		double dfXLM = ReduceTwoPI( dfMAM + dfPerigeeM + dfRAANM );
+		dfRAANM = ReduceTwoPI( dfRAANM );
+		dfPerigeeM = ReduceTwoPI( dfPerigeeM );
+
+		tLanes.ptSMM[ j ] = (T) dfSMM;
+		tLanes.ptMMM[ j ] = (T) ( dfEarthGM / ( dfSMM * sqrt( dfSMM ) ) );
+		tLanes.ptEcc[ j ] = (T) dfEccM;
+		tLanes.ptPerigee[ j ] = (T) dfPerigeeM;
+		tLanes.ptRAAN[ j ] = (T) dfRAANM;
+		// argument of latitude without the long period term, kept small for float
+		tLanes.ptMAPerigee[ j ] = (T) ReduceTwoPI( ReduceTwoPI( dfXLM - dfPerigeeM - dfRAANM ) + dfPerigeeM );
+
+		tLanes.ptInc[ j ] = (T) B.pdfInc0[ i ];
+		tLanes.ptSinI[ j ] = (T) B.pdfSinI0[ i ];
+		tLanes.ptCosI[ j ] = (T) B.pdfCosI0[ i ];
+		tLanes.ptAYCOF[ j ] = (T) B.pdfAYCOF[ i ];
+		tLanes.ptXLCOF[ j ] = (T) B.pdfXLCOF[ i ];
+		tLanes.ptCon41[ j ] = (T) B.pdfCon41[ i ];
+		tLanes.ptX1MTH2[ j ] = (T) B.pdfX1MTH2[ i ];
+		tLanes.ptX7THM1[ j ] = (T) B.pdfX7THM1[ i ];
+	}
+}
+
+/******************************************************************************************
+
+  Long period periodics, Kepler's equation, short period periodics, position and 
+  velocity of L lanes in precision T
+
+  ptPos, ptVel: output by component, ptPos[ k * L + lane ], ptVel not used when only
+                positions are computed
+
+  Each loop runs over all lanes without branches, see the comments of 
+  cTLE2PosVel::SGP4() for the equations.
+
+*******************************************************************************************/
+
+template< class T, int L >
+void cSGP4Batch::PeriodicTerms( stSGP4Lanes< T, L > &tLanes, T tJ2, T tEarthGM, T tEarthRadius, 
+								T tVelocityChange, bool bPosOnly, T *ptPos, T *ptVel )
+{
+	using std::sin;
+	using std::cos;
+	using std::sqrt;
+	using std::atan2;
+	using std::fabs;
+
+	const stSGP4Lanes< T, L > &M = tLanes;
+
+	// Newton iterations stop at a few units of the last place of T
+	const T tKeplerTolerance = sizeof( T ) == sizeof( double ) ? (T) 1.0e-12 : (T) 1.0e-6;
+
+	T ptAXNL[ L ], ptAYNL[ L ], ptU[ L ];
+
+	// long period periodics
+	for( int i = 0; i < L; i++ )
+	{
+		T tEcc = M.ptEcc[ i ];
+		T tAXNL = tEcc * cos( M.ptPerigee[ i ] );
+		T tTemp = (T) 1.0 / ( M.ptSMM[ i ] * ( (T) 1.0 - tEcc * tEcc ) );
+		T tAYNL = tEcc * sin( M.ptPerigee[ i ] ) + tTemp * M.ptAYCOF[ i ];
+
+		ptAXNL[ i ] = tAXNL;
+		ptAYNL[ i ] = tAYNL;
+		ptU[ i ] = ReduceTwoPI( M.ptMAPerigee[ i ] + tTemp * M.ptXLCOF[ i ] * tAXNL );
+	}
+
+	// Kepler's equation, lane-masked Newton iteration
+	T ptE01[ L ], ptSinE01[ L ], ptCosE01[ L ];
+	bool pbActive[ L ];
+
+	for( int i = 0; i < L; i++ )
+	{
+		ptE01[ i ] = ptU[ i ];
+		ptSinE01[ i ] = ptCosE01[ i ] = (T) 0.0;
+		pbActive[ i ] = true;
+	}
+
+	for( int nIters = 0; nIters < 10; nIters++ )
+	{
+		bool bAnyActive = false;
+
+		for( int i = 0; i < L; i++ )
+		{
+			T tSinE = sin( ptE01[ i ] );
+			T tCosE = cos( ptE01[ i ] );
+			T tTEM5 = (T) 1.0 - tCosE * ptAXNL[ i ] - tSinE * ptAYNL[ i ];
+			tTEM5 = ( ptU[ i ] - ptAYNL[ i ] * tCosE + ptAXNL[ i ] * tSinE - ptE01[ i ] ) / tTEM5;
+
+			// converged lanes keep the values of their last iteration
+			bool bActive = pbActive[ i ];
+			ptSinE01[ i ] = bActive ? tSinE : ptSinE01[ i ];
+			ptCosE01[ i ] = bActive ? tCosE : ptCosE01[ i ];
+			ptE01[ i ] = bActive ? ptE01[ i ] + tTEM5 : ptE01[ i ];
+			pbActive[ i ] = bActive && fabs( tTEM5 ) > tKeplerTolerance;
+
+			bAnyActive |= pbActive[ i ];
+		}
+
+		if( !bAnyActive ) break;
+	}
+
+	// short period periodics, orientation, position and velocity
+	for( int i = 0; i < L; i++ )
+	{
+		T tAXNL = ptAXNL[ i ], tAYNL = ptAYNL[ i ];
+		T tSinE01 = ptSinE01[ i ], tCosE01 = ptCosE01[ i ];
+		T tSMM = M.ptSMM[ i ];
+
+		T teCosE = tAXNL * tCosE01 + tAYNL * tSinE01;
+		T teSinE = tAXNL * tSinE01 - tAYNL * tCosE01;
+		T tEL2 = tAXNL * tAXNL + tAYNL * tAYNL;
+		T tPL = tSMM * ( (T) 1.0 - tEL2 );
+
+		tLanes.pbValid[ i ] = tLanes.pbValid[ i ] && tPL >= (T) 0.0;
+		tPL = tPL < (T) 0.0 ? (T) 1.0 : tPL;
+
+		T tRL = tSMM * ( (T) 1.0 - teCosE );
+		T tBETAL = sqrt( (T) 1.0 - tEL2 );
+		T tTemp = teSinE / ( (T) 1.0 + tBETAL );
+		T tSinU = tSMM / tRL * ( tSinE01 - tAYNL - tAXNL * tTemp );
+		T tCosU = tSMM / tRL * ( tCosE01 - tAXNL + tAYNL * tTemp );
+		T tSU = atan2( tSinU, tCosU );
+		T tSin2U = ( tCosU + tCosU ) * tSinU;
+		T tCos2U = (T) 1.0 - (T) 2.0 * tSinU * tSinU;
+		tTemp = (T) 1.0 / tPL;
+		T tTEMP1 = (T) 0.5 * tJ2 * tTemp;
+		T tTEMP2 = tTEMP1 * tTemp;
+
+		T tCosIP = M.ptCosI[ i ], tSinIP = M.ptSinI[ i ];
+		T tCon41 = M.ptCon41[ i ], tX1MTH2 = M.ptX1MTH2[ i ];
+
+		T tRT = tRL * ( (T) 1.0 - (T) 1.5 * tTEMP2 * tBETAL * tCon41 ) +
+				(T) 0.5 * tTEMP1 * tX1MTH2 * tCos2U;
+		tSU = tSU - (T) 0.25 * tTEMP2 * M.ptX7THM1[ i ] * tSin2U;
+		T tRAANT = M.ptRAAN[ i ] + (T) 1.5 * tTEMP2 * tCosIP * tSin2U;
+		T tIncT = M.ptInc[ i ] + (T) 1.5 * tTEMP2 * tCosIP * tSinIP * tCos2U;
+
+		T tSinSU = sin( tSU );
+		T tCosSU = cos( tSU );
+		T tSinNode = sin( tRAANT );
+		T tCosNode = cos( tRAANT );
+		T tSinI = sin( tIncT );
+		T tCosI = cos( tIncT );
+
+		T tMx = - tSinNode * tCosI;
+		T tMy =   tCosNode * tCosI;
+
+		T tUX = tMx * tSinSU + tCosNode * tCosSU;
+		T tUY = tMy * tSinSU + tSinNode * tCosSU;
+		T tUZ = tSinI * tSinSU;
+
+		ptPos[ i ]         = tRT * tUX * tEarthRadius;
+		ptPos[ i + L ]     = tRT * tUY * tEarthRadius;
+		ptPos[ i + 2 * L ] = tRT * tUZ * tEarthRadius;
+
+		if( bPosOnly ) continue;
+
+		T tRDotL = sqrt( tSMM ) * teSinE / tRL;
+		T tRVDotL = sqrt( tPL ) / tRL;
+		T tMMM = M.ptMMM[ i ];
+		T tRDot = tRDotL - tMMM * tTEMP1 * tX1MTH2 * tSin2U / tEarthGM;
+		T tRVDot = tRVDotL + tMMM * tTEMP1 * ( tX1MTH2 * tCos2U + (T) 1.5 * tCon41 ) / tEarthGM;
+
+		T tVX = tMx * tCosSU - tCosNode * tSinSU;
+		T tVY = tMy * tCosSU - tSinNode * tSinSU;
+		T tVZ = tSinI * tCosSU;
+
+		ptVel[ i ]         = ( tRDot * tUX + tRVDot * tVX ) * tVelocityChange;
+		ptVel[ i + L ]     = ( tRDot * tUY + tRVDot * tVY ) * tVelocityChange;
+		ptVel[ i + 2 * L ] = ( tRDot * tUZ + tRVDot * tVZ ) * tVelocityChange;
+	}
+}
@@ -0,0 +1,164 @@
+/***************************************************************************
+
+ Batched SGP4 propagation of many satellites to a common epoch
+
+ The near-earth SGP4 coefficients of the catalog are stored as structure of
+ arrays, in blocks of SGP4_BATCH_LANES satellites. Every step of the
+ algorithm is written as a loop over the lanes of a block with no branches
+ in it, so that the compiler can map the lanes to AVX2/AVX-512 registers. The
+ Kepler equation is solved with a lane mask: a lane stops updating once it
+ has converged, as the scalar do...while loop does.
+
+ Whether the lane loops are vectorised depends on the compiler having vector
+ versions of sin, cos, sqrt and atan2. SGP4Batch.cpp is built with
+ /arch:AVX2 /Qvec-report:2 in Release|x64, so the build log lists each loop
+ with the reason when it is not vectorised. GCC 12 at -O3 -mavx2 vectorises
+ only the loops without math calls (-fopt-info-vec-missed gives "control
+ flow in loop" for the others, from the errno handling of libm); it needs
+ -ffast-math to use libmvec. The loops then run scalar, and the gain comes
+ from the structure of arrays and the coefficients shared by the block.
+
+ Deep space satellites use the scalar cTLE2PosVel path.
+
+ The same kernel also propagates one satellite over an array of epochs,
+ with the lanes spanning time instead of satellites.
+
+ For screening, ComputeECEFPositionFloat() runs the periodic part of the
+ kernel in float over 16 lanes, see SGP4Batch.cpp for its error envelope.
+
+ Reference: SGP4 Algorithm, TLE2PosVel.cpp
+
+***************************************************************************/
+#pragma once
+
+#include "TLE2PosVel.h"
+#include "TimeGrid.h"
+
+#include <vector>
+
+// number of satellites propagated together, 8 doubles fill one AVX-512
+// register or two AVX2 registers
+#define SGP4_BATCH_LANES 8
+
+/***************************************************************************
+
+ Near-earth SGP4 coefficients of one block of satellites
+
+ Lanes of satellites below 220 km perigee have the higher order drag terms
+ set to zero, so that both kinds share one branch free kernel. Unused lanes
+ of the last block are copies of lane 0.
+
+***************************************************************************/
+
+struct stSGP4NearEarthBlock
+{
+	double pdfRefJD[ SGP4_BATCH_LANES ];
+
+	// mean elements at epoch
+	double pdfEcc0[ SGP4_BATCH_LANES ], pdfInc0[ SGP4_BATCH_LANES ], pdfRAAN0[ SGP4_BATCH_LANES ],
+		   pdfPerigee0[ SGP4_BATCH_LANES ], pdfMA0[ SGP4_BATCH_LANES ], pdfMM0[ SGP4_BATCH_LANES ];
+	double pdfBSTAR[ SGP4_BATCH_LANES ];
+	double pdfSinI0[ SGP4_BATCH_LANES ], pdfCosI0[ SGP4_BATCH_LANES ];
+	double pdfSMTerm[ SGP4_BATCH_LANES ];		// (GM/n0)^(2/3)
+
+	// secular rates
+	double pdfMMDot[ SGP4_BATCH_LANES ], pdfPerigeeDot[ SGP4_BATCH_LANES ], pdfRAANDot[ SGP4_BATCH_LANES ];
+
+	// drag terms
+	double pdfRAANDot2Drag[ SGP4_BATCH_LANES ], pdfPerigeeDotDrag[ SGP4_BATCH_LANES ], pdfMMDotDrag[ SGP4_BATCH_LANES ];
+	double pdfCC1[ SGP4_BATCH_LANES ], pdfCC4[ SGP4_BATCH_LANES ], pdfCC5[ SGP4_BATCH_LANES ];
+	double pdfEta[ SGP4_BATCH_LANES ], pdfDeltaMA0[ SGP4_BATCH_LANES ], pdfSinMAO[ SGP4_BATCH_LANES ];
+	double pdfD2[ SGP4_BATCH_LANES ], pdfD3[ SGP4_BATCH_LANES ], pdfD4[ SGP4_BATCH_LANES ];
+	double pdfT2Coe[ SGP4_BATCH_LANES ], pdfT3Coe[ SGP4_BATCH_LANES ], pdfT4Coe[ SGP4_BATCH_LANES ], pdfT5Coe[ SGP4_BATCH_LANES ];
+
+	// long and short period terms
+	double pdfAYCOF[ SGP4_BATCH_LANES ], pdfXLCOF[ SGP4_BATCH_LANES ];
+	double pdfCon41[ SGP4_BATCH_LANES ], pdfX1MTH2[ SGP4_BATCH_LANES ], pdfX7THM1[ SGP4_BATCH_LANES ];
+
+	int pnIndex[ SGP4_BATCH_LANES ];	// index of the satellite in the batch
+	int nLanes;							// number of lanes in use
+};
+
+/***************************************************************************
+
+ Mean elements and periodic coefficients of L lanes at the propagation time,
+ in the precision T of the periodic part of the kernel
+
+***************************************************************************/
+
+template< class T, int L >
+struct stSGP4Lanes
+{
+	T ptSMM[ L ], ptMMM[ L ], ptEcc[ L ], ptPerigee[ L ], ptRAAN[ L ], ptMAPerigee[ L ];
+	T ptInc[ L ], ptSinI[ L ], ptCosI[ L ];
+	T ptAYCOF[ L ], ptXLCOF[ L ], ptCon41[ L ], ptX1MTH2[ L ], ptX7THM1[ L ];
+	bool pbValid[ L ];
+};
+
+class cSGP4Batch
+{
+	// WGS-72 constants, taken from cTLE2PosVel
+	double m_dfEarthGM, m_dfJ2, m_df2O3, m_dfEarthRadius, m_dfVelocityChange;
+
+	std::vector<stSGP4NearEarthBlock> m_vtNearEarth;
+
+	// deep space satellites, propagated by the scalar path
+	std::vector<const cTLE2PosVel*> m_vpDeepSpace;
+	std::vector<stSGP4WorkArea> m_vtDeepSpaceWork;
+	std::vector<int> m_vnDeepSpaceIndex;
+
+	int m_nSatellites;
+	bool m_bPosOnly;
+
+	// earth rotation at the epochs of a time series
+	cTimeGrid m_tGrid;
+
+	int m_nError;
+
+public:
+
+	cSGP4Batch();
+	~cSGP4Batch();
+
+	void Clear();
+
+	// deep space propagators are referenced, not copied, and must outlive the batch
+	int AddSatellite( const cTLE2PosVel &tSat );
+
+	int GetSatelliteNumber() const { return m_nSatellites; }
+	int GetDeepSpaceNumber() const { return (int) m_vpDeepSpace.size(); }
+	void SetComputePositionOnly( bool bState ) { m_bPosOnly = bState; }
+
+	// pdfPos/pdfVel hold 3 values per satellite in the order of AddSatellite(),
+	// pbValid (optional) flags the satellites propagated successfully
+	bool ComputeInertialPosVel( double dfJD, double *pdfPos, double *pdfVel, bool *pbValid = NULL );
+	bool ComputeECEFPosVel( double dfJD, double *pdfPos, double *pdfVel, bool *pbValid = NULL );
+	bool ComputeECEFPosVel( const cTimeGrid &tGrid, int nEpoch, double *pdfPos, double *pdfVel, 
+							bool *pbValid = NULL );
+
+	// reduced precision positions for screening, 3 values per satellite in meter
+	bool ComputeECEFPositionFloat( double dfJD, float *pfPos, bool *pbValid = NULL );
+
+	// one satellite at nEpochs epochs, 3 values per epoch in pdfPos/pdfVel
+	bool ComputeInertialPosVelSeries( const cTLE2PosVel &tSat, int nEpochs, const double *pdfJD,
+									  double *pdfPos, double *pdfVel, bool *pbValid = NULL );
+	bool ComputeECEFPosVelSeries( const cTLE2PosVel &tSat, int nEpochs, const double *pdfJD,
+								  double *pdfPos, double *pdfVel, bool *pbValid = NULL );
+	bool ComputeECEFPosVelSeries( const cTLE2PosVel &tSat, const cTimeGrid &tGrid,
+								  double *pdfPos, double *pdfVel, bool *pbValid = NULL );
+
+private:
+
+	void SetConstants( const cTLE2PosVel &tSat );
+	void FillLane( stSGP4NearEarthBlock &tBlock, int nLane, const cTLE2PosVel &tSat, int nIndex );
+
+	void PropagateNearEarthBlock( const stSGP4NearEarthBlock &tBlock, const double *pdfT,
+								  double *pdfPos, double *pdfVel, bool *pbValid ) const;
+
+	template< class T, int L >
+	static void SecularTerms( const stSGP4NearEarthBlock &tBlock, const double *pdfT, double dfEarthGM,
+							  stSGP4Lanes< T, L > &tLanes, int nOffset );
+	template< class T, int L >
+	static void PeriodicTerms( stSGP4Lanes< T, L > &tLanes, T tJ2, T tEarthGM, T tEarthRadius,
+							   T tVelocityChange, bool bPosOnly, T *ptPos, T *ptVel );
+};
@@ -24,16 +24,25 @@
 #include <vector>
 #include <array>
 #include <chrono>
-#include <optional>
+#include <cmath>
+#include <memory>
 #include <filesystem>
 #include <format>
 #include <numbers>
+#include <functional>
+#include <algorithm>
 
 #include <windows.h>
 #include "ModernConstants.h"
 #include "CoordinateSystem.h"
 #include "DataStructure.h"
 #include "TLE2PosVel.h"
+#include "SGP4Batch.h"
+#include "TimeGrid.h"
+#include "TopocentricSite.h"
+#include "PassDetector.h"
+#include "PassFinder.h"
+#include "VisibilityFilter.h"
 #include "include/Visualization/TerminalVisualizer.h"
 #include "DateTimeZ.h"
 
@@ -90,6 +99,30 @@ public:
         double azimuth;
     };
 
+    /**
+     * @struct SampleArrays
+     * @brief 预报循环的数值结果，按历元存放的结构数组
+     *
+     * 只保存儒略日、方位角、仰角和距离，日历时间在输出时才由儒略日换算。
+     */
+    struct SampleArrays
+    {
+        std::vector<double> julianDate;
+        std::vector<double> azimuth;    // 弧度
+        std::vector<double> elevation;  // 弧度
+        std::vector<double> distance;   // 米
+
+        void resize(size_t count)
+        {
+            julianDate.resize(count);
+            azimuth.resize(count);
+            elevation.resize(count);
+            distance.resize(count);
+        }
+
+        size_t size() const noexcept { return julianDate.size(); }
+    };
+
     /**
      * @struct PredictionConfig
      * @brief 预报配置结构
@@ -102,8 +135,22 @@ public:
         double elevationMask;    // 高度角掩码 (弧度)
         std::string tleFilePath;
         std::string outputFilePath;
+        std::string passFilePath;
+        bool keepSamples = true;  // 保存逐点结果；长时段预报设为false，只通过过顶事件输出，内存不随时段增长
     };
 
+    /**
+     * @brief 过顶事件的订阅者，逐点采样检测到的过顶结束、由求根细化后调用
+     *
+     * 参数为过顶记录（儒略日、弧度）和换算为相对预报起点的过顶摘要。
+     */
+    using PassListener = std::function<void(const stVisiblePass&, const PassSummary&)>;
+
+    /**
+     * @brief 一次处理的历元数，外推和逐点结果的内存不随预报时段增长
+     */
+    static constexpr size_t EPOCH_BLOCK_SIZE = 86400;
+
     /**
      * @brief 默认配置
      */
@@ -115,7 +162,9 @@ public:
             1.0 / 1440.0,          // 1分钟
             0.0,                   // 0度
             "",                    // tleFilePath (自动设置)
-            ""                     // outputFilePath (自动设置)
+            "",                    // outputFilePath (自动设置)
+            "",                    // passFilePath (自动设置)
+            true                   // 保存逐点结果
         };
     }
 
@@ -127,7 +176,6 @@ public:
     SatellitePassPredictor(const SitePosition& site, PredictionConfig config)
         : site_(site)
         , config_(std::move(config))
-        , coordinateConverter_()
     {
         // 自动设置路径
         if (config_.tleFilePath.empty()) {
@@ -136,6 +184,9 @@ public:
         if (config_.outputFilePath.empty()) {
             config_.outputFilePath = (fs::current_path() / "output" / "25262_Result.txt").string();
         }
+        if (config_.passFilePath.empty()) {
+            config_.passFilePath = (fs::current_path() / "output" / "25262_Passes_Modern.txt").string();
+        }
     }
 
     /**
@@ -146,6 +197,7 @@ public:
     {
         std::vector<ObservationResult> results;
         allSkyPoints_.clear();
+        failedPropagations_ = 0;
 
         cTLE2PosVel tleProcessor;
         std::vector<stSatelliteIOE> ioes;
@@ -199,36 +251,77 @@ public:
 
         const double firstJD = startJD;
 
-        for (double tJD = startJD; tJD < endJD; tJD += config_.timeStep) {
-            std::array<double, 3> satPos{}, satVel{};
-            if (!tleProcessor.ComputeECEFPosVel(tJD, satPos.data(), satVel.data())) {
-                continue;
+        // 测站的地平坐标系只计算一次
+        const double siteXYZ[3] = {siteECEF.x, siteECEF.y, siteECEF.z};
+        topocentricSite_.SetStation(site_.latitude, site_.longitude, siteXYZ);
+        topocentricSite_.SetElevationMask(config_.elevationMask);
+
+        // 几何预筛选：卫星不可能高于仰角掩码的历元不做外推
+        cVisibilityFilter visibilityFilter;
+        visibilityFilter.SetStation(siteXYZ);
+        visibilityFilter.SetElevationMask(config_.elevationMask);
+
+        // 过顶的升起、落下和最高点由求根得到，不受时间步长限制
+        cPassFinder passFinder;
+        passFinder.SetStation(0, topocentricSite_);
+        passFinder.SetElevationMask(config_.elevationMask);
+
+        // 逐点采样的过顶检测，过顶结束即求根细化并通知订阅者，只保存进行中的过顶
+        cPassDetector passDetector;
+        passDetector.SetIDs(ioes[0].nSatelliteID, 0);
+        passDetector.SetElevationMask(config_.elevationMask);
+        passDetector.SetCallback([&](const stVisiblePass& sampled) {
+            for (const auto& pass : refinePass(passFinder, tleProcessor, sampled, startJD, endJD)) {
+                const PassSummary summary = toPassSummary(pass, firstJD);
+                for (const auto& listener : passListeners_) {
+                    listener(pass, summary);
+                }
             }
+        });
 
-            auto observation = calculateObservation(tJD, satPos, siteECEF);
-            if (!observation) continue;
-
-            double timeHours = (tJD - firstJD) * 24.0;
-            SkyPoint sp{observation->azimuth * RAD2DEG,
-                        observation->elevation * RAD2DEG,
-                        timeHours};
-            allSkyPoints_.push_back(sp);
+        // 历元分块外推，每块内SIMD通道按时间展开
+        const size_t epochCount = static_cast<size_t>(std::ceil((endJD - startJD) / config_.timeStep)) + 1;
+        if (config_.keepSamples) {
+            allSkyPoints_.reserve(epochCount);
+        }
 
-            if (observation->elevation > config_.elevationMask) {
-                results.push_back(*observation);
+        std::vector<double> epochs;
+        epochs.reserve(std::min(epochCount, EPOCH_BLOCK_SIZE));
+        double tJD = startJD;
+        while (tJD < endJD) {
+            epochs.clear();
+            for (; tJD < endJD && epochs.size() < EPOCH_BLOCK_SIZE; tJD += config_.timeStep) {
+                epochs.push_back(tJD);
             }
+            processEpochBlock(tleProcessor, visibilityFilter, epochs, firstJD, passDetector, results);
         }
+        passDetector.Finish();
+        savedPropagations_ = visibilityFilter.GetSavedPropagations() - visibilityFilter.GetEvaluationNumber();
 
         std::cout << Color::BRIGHT_GREEN << Color::BOLD
                   << "  Prediction complete. "
                   << Color::BRIGHT_YELLOW << allSkyPoints_.size() << " points computed, "
-                  << Color::BRIGHT_GREEN << results.size() << " visible points."
+                  << Color::BRIGHT_GREEN << results.size() << " visible points, "
+                  << Color::BRIGHT_YELLOW << savedPropagations_ << " propagations saved by the pre-filter."
                   << Color::RESET << "\n\n";
 
+        if (failedPropagations_ > 0) {
+            visualizer.printWarning(std::format("{} epochs could not be propagated and were treated as gaps.",
+                                                failedPropagations_));
+        }
+
         return results;
     }
 
+    /**
+     * @brief 订阅逐点采样检测到的过顶，在runPrediction()中按时间顺序通知
+     */
+    void addPassListener(PassListener listener) { passListeners_.push_back(std::move(listener)); }
+
+    const PredictionConfig& getConfig() const { return config_; }
     const std::vector<SkyPoint>& getSkyPoints() const { return allSkyPoints_; }
+    int getSavedPropagations() const { return savedPropagations_; }
+    int getFailedPropagations() const { return failedPropagations_; }
 
     /**
      * @brief 保存结果到文件
@@ -268,29 +361,138 @@ public:
 private:
     SitePosition site_;
     PredictionConfig config_;
-    CoordinateConverter coordinateConverter_;
+    cTopocentricSite topocentricSite_;
+    SampleArrays samples_;  // 当前历元块的数值结果，缓冲区在块之间复用
+    std::vector<PassListener> passListeners_;
     std::vector<SkyPoint> allSkyPoints_;
+    int savedPropagations_ = 0;  // 预筛选节省的外推次数，已扣除筛选本身的外推
+    int failedPropagations_ = 0;  // 外推失败、作为间隙处理的历元数
 
     /**
-     * @brief 计算单个观测点
+     * @brief 处理一块历元：预筛选、外推、计算方位角仰角，逐点送入过顶检测
+     *
+     * 被预筛选排除或外推失败的历元作为仰角掩码以下处理，结束进行中的过顶。
      */
-    std::optional<ObservationResult> calculateObservation(
-        double jd,
-        const std::array<double, 3>& satPos,
-        const CartesianPosition& siteECEF) const
+    void processEpochBlock(const cTLE2PosVel& tleProcessor,
+                           cVisibilityFilter& visibilityFilter,
+                           const std::vector<double>& epochs,
+                           double firstJD,
+                           cPassDetector& passDetector,
+                           std::vector<ObservationResult>& results)
     {
-        // 计算卫星相对于测站的向量
-        std::array<double, 3> deltaXYZ = {
-            satPos[0] - siteECEF.x,
-            satPos[1] - siteECEF.y,
-            satPos[2] - siteECEF.z
-        };
+        std::unique_ptr<bool[]> candidate(new bool[epochs.size()]());
+        const int candidateCount = visibilityFilter.SelectEpochs(
+            tleProcessor, static_cast<int>(epochs.size()), epochs.data(), candidate.get());
+
+        std::vector<double> candidateEpochs;
+        candidateEpochs.reserve(static_cast<size_t>(std::max(candidateCount, 0)));
+        for (size_t n = 0; n < epochs.size(); ++n) {
+            if (candidate[n]) {
+                candidateEpochs.push_back(epochs[n]);
+            }
+        }
+
+        // 仰角/方位角只需要位置；没有候选历元的块不外推，全部历元作为间隙
+        std::vector<double> positions(3 * candidateEpochs.size());
+        std::unique_ptr<bool[]> valid(new bool[candidateEpochs.size()]());
+        cTimeGrid grid;
+        if (candidateCount > 0 &&
+            grid.SetEpochs(static_cast<int>(candidateEpochs.size()), candidateEpochs.data())) {
+            cSGP4Batch propagator;
+            propagator.SetComputePositionOnly(true);
+            if (!propagator.ComputeECEFPosVelSeries(tleProcessor, grid, positions.data(), nullptr, valid.get())) {
+                // valid标出外推失败的历元（如卫星已衰减），调用整体失败时保持初始的false
+                failedPropagations_ += static_cast<int>(
+                    std::count(valid.get(), valid.get() + candidateEpochs.size(), false));
+            }
+        }
+
+        // 数值核心：每个有效历元只计算 (儒略日, 方位角, 仰角, 距离)，数组按候选历元数预分配
+        samples_.resize(candidateEpochs.size());
+        size_t sampleCount = 0;
+        size_t candidateIndex = 0;
+        for (size_t n = 0; n < epochs.size(); ++n) {
+            if (!candidate[n] || !valid[candidateIndex++]) {
+                passDetector.AddGap(epochs[n]);
+                continue;
+            }
+
+            const size_t c = candidateIndex - 1;
+            samples_.julianDate[sampleCount] = candidateEpochs[c];
+            topocentricSite_.ComputeAzElRange(&positions[3 * c],
+                                              samples_.azimuth[sampleCount],
+                                              samples_.elevation[sampleCount],
+                                              samples_.distance[sampleCount]);
+            passDetector.AddSample(samples_.julianDate[sampleCount],
+                                   samples_.azimuth[sampleCount],
+                                   samples_.elevation[sampleCount]);
+            ++sampleCount;
+        }
+        samples_.resize(sampleCount);
+
+        if (!config_.keepSamples) {
+            return;
+        }
+
+        for (size_t k = 0; k < sampleCount; ++k) {
+            allSkyPoints_.push_back({samples_.azimuth[k] * RAD2DEG,
+                                     samples_.elevation[k] * RAD2DEG,
+                                     (samples_.julianDate[k] - firstJD) * 24.0});
+        }
+
+        // 只有输出的可见历元才换算日历时间
+        for (size_t k = 0; k < sampleCount; ++k) {
+            if (samples_.elevation[k] > config_.elevationMask) {
+                results.push_back(calculateObservation(k));
+            }
+        }
+    }
 
-        // 计算方位角和仰角
-        GeodeticPosition siteGeodetic(site_.latitude, site_.longitude, site_.height);
-        const auto spherical = coordinateConverter_.toSpherical(deltaXYZ, siteGeodetic);
+    /**
+     * @brief 由求根细化逐点采样检测到的过顶
+     *
+     * 在采样得到的升起之前、落下之后各一个时间步长内求根，不超出预报时段；
+     * 时段内外推失败等求根不成功时保留采样得到的过顶。
+     */
+    std::vector<stVisiblePass> refinePass(cPassFinder& passFinder,
+                                          const cTLE2PosVel& tleProcessor,
+                                          const stVisiblePass& sampled,
+                                          double startJD,
+                                          double endJD) const
+    {
+        const double fromJD = std::max(sampled.tRise.dfJD - config_.timeStep, startJD);
+        const double toJD = std::min(sampled.tSet.dfJD + config_.timeStep, endJD);
+
+        std::vector<stVisiblePass> refined;
+        if (!passFinder.FindPasses(tleProcessor, fromJD, toJD, refined) || refined.empty()) {
+            return {sampled};
+        }
+        return refined;
+    }
+
+    /**
+     * @brief 过顶记录转换为可视化的过顶摘要，时间从预报起点起算
+     */
+    static PassSummary toPassSummary(const stVisiblePass& pass, double firstJD)
+    {
+        PassSummary summary;
+        summary.maxElevation = pass.tTCA.dfEl * RAD2DEG;
+        summary.startAzimuth = pass.tRise.dfAz * RAD2DEG;
+        summary.endAzimuth = pass.tSet.dfAz * RAD2DEG;
+        summary.startTimeHours = (pass.tRise.dfJD - firstJD) * 24.0;
+        summary.endTimeHours = (pass.tSet.dfJD - firstJD) * 24.0;
+        summary.durationMinutes = (pass.tSet.dfJD - pass.tRise.dfJD) * 1440.0;
+        summary.isValid = true;
+        return summary;
+    }
+
+    /**
+     * @brief 由数值结果的第row行生成观测记录，换算日历时间
+     */
+    ObservationResult calculateObservation(size_t row) const
+    {
+        const double jd = samples_.julianDate[row];
 
-        // 转换时间
         int year, month, day, hour, minute;
         double second;
         DateTimeZ jdConverter;
@@ -298,8 +500,8 @@ private:
 
         return ObservationResult{
             jd, year, month, day, hour, minute, second,
-            spherical.elevation,
-            spherical.azimuth
+            samples_.elevation[row],
+            samples_.azimuth[row]
         };
     }
 };
@@ -322,6 +524,45 @@ void printResultsTraditional(const std::vector<SatellitePassPredictor::Observati
     }
 }
 
+/**
+ * @class PassFileWriter
+ * @brief 过顶列表文件，订阅过顶事件，过顶结束即写出一行
+ *
+ * 每行为NORAD编号和升起、最高点、落下的时间UTC、高度角和方位角，
+ * 与传统主程序的过顶列表格式相同。
+ */
+class PassFileWriter
+{
+public:
+    explicit PassFileWriter(const std::string& filepath)
+        : outFile_(filepath)
+    {
+    }
+
+    bool isOpen() const { return outFile_.is_open(); }
+    size_t getPassCount() const noexcept { return passCount_; }
+
+    void write(const stVisiblePass& pass)
+    {
+        outFile_ << std::format("{:6d}", pass.nSatID);
+        for (const stPassPoint* point : {&pass.tRise, &pass.tTCA, &pass.tSet}) {
+            int year, month, day, hour, minute;
+            double second;
+            DateTimeZ jdConverter;
+            jdConverter.JD2DateTime(point->dfJD, year, month, day, hour, minute, second);
+            outFile_ << std::format("  {:4d} {:02d} {:02d} {:02d} {:02d} {:06.3f} 高度角 {:8.4f} 方位角 {:9.4f}",
+                                    year, month, day, hour, minute, second,
+                                    point->dfEl * RAD2DEG, point->dfAz * RAD2DEG);
+        }
+        outFile_ << "\n";
+        ++passCount_;
+    }
+
+private:
+    std::ofstream outFile_;
+    size_t passCount_ = 0;
+};
+
 /**
  * @class SiteInfoBuilder
  * @brief 测站信息构建器
@@ -360,8 +601,11 @@ public:
 
 /**
  * @brief 主函数
+ *
+ * 默认保存逐点结果，绘制天空图和仰角时间线并输出逐点观测文件；长时段预报用
+ * 参数 --no-samples 只通过过顶事件输出。过顶列表和摘要表都来自求根细化的过顶。
  */
-int main()
+int main(int argc, char* argv[])
 {
     TerminalVisualizer viz;
 
@@ -372,14 +616,36 @@ int main()
 
         auto site = SiteInfoBuilder::getDefaultSite();
         auto config = SatellitePassPredictor::getDefaultConfig();
-
-        viz.printInfo("TLE File", config.tleFilePath);
-        viz.printInfo("Output File", config.outputFilePath);
-        viz.printInfo("Time Step", std::format("{:.1f} sec", config.timeStep * 86400.0));
-        viz.printInfo("Elevation Mask", std::format("{:.1f} deg", config.elevationMask * RAD2DEG));
-        viz.printInfo("Duration", std::format("{:.1f} days", config.endJD));
+        for (int i = 1; i < argc; ++i) {
+            if (std::string(argv[i]) == "--no-samples") {
+                config.keepSamples = false;
+            }
+        }
 
         SatellitePassPredictor predictor(site, config);
+        const auto& settings = predictor.getConfig();
+
+        viz.printInfo("TLE File", settings.tleFilePath);
+        viz.printInfo("Output File", settings.outputFilePath);
+        viz.printInfo("Pass File", settings.passFilePath);
+        viz.printInfo("Time Step", std::format("{:.1f} sec", settings.timeStep * 86400.0));
+        viz.printInfo("Elevation Mask", std::format("{:.1f} deg", settings.elevationMask * RAD2DEG));
+        viz.printInfo("Duration", std::format("{:.1f} days", settings.endJD));
+        viz.printInfo("Sky Plot", settings.keepSamples ? "enabled" : "disabled (--no-samples)");
+
+        // 过顶列表文件和摘要表都订阅过顶事件
+        PassFileWriter passWriter(settings.passFilePath);
+        if (passWriter.isOpen()) {
+            predictor.addPassListener([&passWriter](const stVisiblePass& pass, const PassSummary&) {
+                passWriter.write(pass);
+            });
+        }
+
+        std::vector<PassSummary> passes;
+        predictor.addPassListener([&passes](const stVisiblePass&, const PassSummary& summary) {
+            passes.push_back(summary);
+        });
+
         auto results = predictor.runPrediction(viz);
 
         const auto& skyPoints = predictor.getSkyPoints();
@@ -392,38 +658,47 @@ int main()
             viz.drawElevationTimeline(skyPoints, 70, 18);
         }
 
-        auto passes = TerminalVisualizer::extractPasses(skyPoints, 5.0);
-
         if (!passes.empty()) {
             viz.printPassSummary(passes);
         }
 
         viz.printHeader("Results");
 
+        if (passWriter.isOpen()) {
+            viz.printSuccess("Saved " + std::to_string(passWriter.getPassCount()) +
+                             " passes to: " + settings.passFilePath);
+        } else {
+            viz.printError("Cannot open output file: " + settings.passFilePath);
+        }
+
         if (!results.empty()) {
-            if (predictor.saveResults(results, config.outputFilePath)) {
+            if (predictor.saveResults(results, settings.outputFilePath)) {
                 viz.printSuccess("Saved " + std::to_string(results.size()) +
-                                 " visible observations to: " + config.outputFilePath);
+                                 " visible observations to: " + settings.outputFilePath);
             } else {
-                viz.printError("Cannot open output file: " + config.outputFilePath);
+                viz.printError("Cannot open output file: " + settings.outputFilePath);
             }
+        }
 
+        if (!passes.empty()) {
             viz.printSubSeparator('-', 72);
             viz.printInfo("Visible Passes Found", static_cast<double>(passes.size()), 0);
 
-            if (!passes.empty()) {
-                viz.printInfo("Max Pass Elevation", passes[0].maxElevation, 1);
-            }
+            const auto highest = std::max_element(passes.begin(), passes.end(),
+                [](const PassSummary& a, const PassSummary& b) { return a.maxElevation < b.maxElevation; });
+            viz.printInfo("Max Pass Elevation", highest->maxElevation, 1);
 
             std::cout << "\n";
+        } else {
+            viz.printWarning("No visible passes found in the prediction window.");
+        }
 
+        if (!results.empty()) {
             viz.printSeparator('-', 72);
             std::cout << Color::DIM
                       << "  Detailed observation data (traditional format):"
                       << Color::RESET << "\n\n";
             printResultsTraditional(results);
-        } else {
-            viz.printWarning("No visible passes found in the prediction window.");
         }
 
         std::cout << "\n";
@@ -435,4 +710,4 @@ int main()
         viz.printError(std::string("Exception: ") + e.what());
         return 1;
     }
-}
\ No newline at end of file
+}
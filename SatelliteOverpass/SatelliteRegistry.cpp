@@ -0,0 +1,168 @@
+/***************************************************************************
+
+ Set of satellite catalog numbers
+
+***************************************************************************/
+#undef UNICODE
+
+#include "SatelliteRegistry.h"
+
+// Alpha-5 letters, their index + 10 is the leading value
+static const char s_szAlpha5[] = "ABCDEFGHJKLMNPQRSTUVWXYZ";
+
+
+cSatelliteRegistry::cSatelliteRegistry()
+{
+	m_nTableCount = 0;
+	m_nCount = 0;
+}
+
+
+cSatelliteRegistry::~cSatelliteRegistry()
+{
+
+}
+
+
+bool cSatelliteRegistry::Insert( int nID )
+{
+	if( nID <= 0 ) return false;
+
+	if( nID < SATELLITE_REGISTRY_DENSE )
+	{
+		size_t nWord = (size_t) nID >> 5;
+		unsigned int nBit = 1u << ( nID & 31 );
+
+		if( nWord >= m_vnBits.size() ) m_vnBits.resize( nWord + 1, 0 );
+		if( m_vnBits[ nWord ] & nBit ) return false;
+
+		m_vnBits[ nWord ] |= nBit;
+		m_nCount++;
+
+		return true;
+	}
+
+	// keep the load of the table at most one half
+	if( 2 * ( m_nTableCount + 1 ) > (int) m_vnTable.size() ) GrowTable();
+
+	size_t nMask = m_vnTable.size() - 1;
+	for( size_t i = Hash( nID ) & nMask; ; i = ( i + 1 ) & nMask )
+	{
+		if( m_vnTable[ i ] == nID ) return false;
+		if( m_vnTable[ i ] == 0 )
+		{
+			m_vnTable[ i ] = nID;
+			m_nTableCount++;
+			m_nCount++;
+
+			return true;
+		}
+	}
+}
+
+
+bool cSatelliteRegistry::Contains( int nID ) const
+{
+	if( nID <= 0 ) return false;
+
+	if( nID < SATELLITE_REGISTRY_DENSE )
+	{
+		size_t nWord = (size_t) nID >> 5;
+
+		return nWord < m_vnBits.size() && ( m_vnBits[ nWord ] >> ( nID & 31 ) & 1 ) != 0;
+	}
+
+	if( m_vnTable.empty() ) return false;
+
+	size_t nMask = m_vnTable.size() - 1;
+	for( size_t i = Hash( nID ) & nMask; m_vnTable[ i ] != 0; i = ( i + 1 ) & nMask )
+	{
+		if( m_vnTable[ i ] == nID ) return true;
+	}
+
+	return false;
+}
+
+
+void cSatelliteRegistry::Clear()
+{
+	m_vnBits.clear();
+	m_vnTable.clear();
+	m_nTableCount = 0;
+	m_nCount = 0;
+}
+
+
+unsigned int cSatelliteRegistry::Hash( int nID )
+{
+	// Fibonacci hashing, the high bits are the best mixed
+	unsigned int nHash = (unsigned int) nID * 2654435769u;
+
+	return nHash ^ ( nHash >> 16 );
+}
+
+
+void cSatelliteRegistry::GrowTable()
+{
+	std::vector<int> vnOld;
+	vnOld.swap( m_vnTable );
+
+	m_vnTable.assign( vnOld.empty() ? 16 : 2 * vnOld.size(), 0 );
+
+	size_t nMask = m_vnTable.size() - 1;
+	for( size_t k = 0; k < vnOld.size(); k++ )
+	{
+		if( vnOld[ k ] == 0 ) continue;
+
+		size_t i = Hash( vnOld[ k ] ) & nMask;
+		while( m_vnTable[ i ] != 0 ) i = ( i + 1 ) & nMask;
+		m_vnTable[ i ] = vnOld[ k ];
+	}
+}
+
+/******************************************************************************************
+
+  Catalog number of columns 2-6 of a TLE line, as atoi() of the field for the numeric ones
+
+*******************************************************************************************/
+
+int cSatelliteRegistry::DecodeCatalogNumber( const char *pField )
+{
+	int nValue = 0, i = 0;
+
+	if( pField[ 0 ] >= 'A' && pField[ 0 ] <= 'Z' )
+	{
+		const char *pLetter = s_szAlpha5;
+		while( *pLetter != '\0' && *pLetter != pField[ 0 ] ) pLetter++;
+		if( *pLetter == '\0' ) return 0;
+
+		nValue = (int) ( pLetter - s_szAlpha5 ) + 10;
+		i = 1;
+	}
+	else
+	{
+		while( i < 5 && pField[ i ] == ' ' ) i++;
+	}
+
+	for( ; i < 5; i++ )
+	{
+		unsigned int nDigit = (unsigned int) ( pField[ i ] - '0' );
+		if( nDigit >= 10 ) break;
+		nValue = nValue * 10 + (int) nDigit;
+	}
+
+	return nValue;
+}
+
+
+bool cSatelliteRegistry::EncodeCatalogNumber( int nID, char *pField )
+{
+	if( nID < 0 || nID > 339999 ) return false;
+
+	int nLead = nID / 10000;
+	pField[ 0 ] = nLead < 10 ? (char) ( '0' + nLead ) : s_szAlpha5[ nLead - 10 ];
+
+	for( int i = 4, n = nID % 10000; i >= 1; i--, n /= 10 ) pField[ i ] = (char) ( '0' + n % 10 );
+
+	return true;
+}
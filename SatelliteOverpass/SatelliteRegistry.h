@@ -0,0 +1,52 @@
+/***************************************************************************
+
+ Set of satellite catalog numbers
+
+ The catalog numbers below SATELLITE_REGISTRY_DENSE, which include all the
+ five column numbers and the Alpha-5 ones, are kept in a bitmap sized to
+ the largest number inserted. Larger numbers, such as the 9 digit ones of
+ the OMM format, go to an open addressing hash table. One registry can be
+ shared by any number of propagators and readers; it is not synchronised,
+ so it must not be changed while another thread reads it.
+
+ Alpha-5 numbers replace the first digit of the 5 column field by a
+ letter, I and O excluded: A0000 is 100000, Z9999 is 339999.
+
+***************************************************************************/
+#pragma once
+
+#include <vector>
+#include <stddef.h>
+
+#define SATELLITE_REGISTRY_DENSE ( 1 << 20 )
+
+class cSatelliteRegistry
+{
+	std::vector<unsigned int> m_vnBits;		// bit n for catalog number n
+	std::vector<int> m_vnTable;				// catalog numbers from SATELLITE_REGISTRY_DENSE, 0 if empty
+	int m_nTableCount;
+	int m_nCount;
+
+public:
+
+	cSatelliteRegistry();
+	~cSatelliteRegistry();
+
+	// false if the number is not positive or already in the registry
+	bool Insert( int nID );
+	bool Contains( int nID ) const;
+	void Clear();
+
+	int GetCount() const { return m_nCount; }
+
+	// catalog number of the 5 column field, Alpha-5 included, 0 if it is not a number
+	static int DecodeCatalogNumber( const char *pField );
+
+	// 5 column field of the catalog number, in Alpha-5 above 99999, false if out of range
+	static bool EncodeCatalogNumber( int nID, char *pField );
+
+private:
+
+	static unsigned int Hash( int nID );
+	void GrowTable();
+};
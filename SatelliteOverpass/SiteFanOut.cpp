@@ -0,0 +1,168 @@
+/***************************************************************************
+
+ Topocentric coordinates of one satellite state seen from many stations
+
+***************************************************************************/
+#undef UNICODE
+
+#include <math.h>
+#include "SiteFanOut.h"
+#include "constant.h"
+
+
+cSiteFanOut::cSiteFanOut()
+{
+	m_nStations = 0;
+}
+
+
+cSiteFanOut::~cSiteFanOut()
+{
+
+}
+
+
+void cSiteFanOut::Clear()
+{
+	m_vtBlocks.clear();
+	m_nStations = 0;
+}
+
+/******************************************************************************************
+
+  Append a station to the last block, or to a new block whose lanes are all set to it
+
+*******************************************************************************************/
+
+void cSiteFanOut::AddStation( const cTopocentricSite &tSite )
+{
+	int nLane = m_nStations % SITE_FANOUT_LANES;
+	if( nLane == 0 ) m_vtBlocks.push_back( stSiteBlock() );
+
+	stSiteBlock &tBlock = m_vtBlocks.back();
+
+	const double *pdfECEF = tSite.GetECEF();
+	const double *pdfEast = tSite.GetEast(), *pdfNorth = tSite.GetNorth(), *pdfUp = tSite.GetUp();
+
+	int nFirst = nLane, nLast = nLane == 0 ? SITE_FANOUT_LANES : nLane + 1;
+
+	for( int i = nFirst; i < nLast; i++ )
+	{
+		tBlock.pdfX[ i ] = pdfECEF[ 0 ];
+		tBlock.pdfY[ i ] = pdfECEF[ 1 ];
+		tBlock.pdfZ[ i ] = pdfECEF[ 2 ];
+
+		tBlock.pdfEastX[ i ] = pdfEast[ 0 ];
+		tBlock.pdfEastY[ i ] = pdfEast[ 1 ];
+
+		tBlock.pdfNorthX[ i ] = pdfNorth[ 0 ];
+		tBlock.pdfNorthY[ i ] = pdfNorth[ 1 ];
+		tBlock.pdfNorthZ[ i ] = pdfNorth[ 2 ];
+
+		tBlock.pdfUpX[ i ] = pdfUp[ 0 ];
+		tBlock.pdfUpY[ i ] = pdfUp[ 1 ];
+		tBlock.pdfUpZ[ i ] = pdfUp[ 2 ];
+	}
+
+	tBlock.nLanes = nLane + 1;
+	m_nStations++;
+}
+
+
+void cSiteFanOut::AddStation( double dfLatitude, double dfLongitude, const double *pdfSiteECEF )
+{
+	cTopocentricSite tSite;
+	tSite.SetStation( dfLatitude, dfLongitude, pdfSiteECEF );
+
+	AddStation( tSite );
+}
+
+
+void cSiteFanOut::SetStations( const std::vector<stTrackStation> &vtStations )
+{
+	Clear();
+
+	for( size_t i = 0; i < vtStations.size(); i++ )
+	{
+		const stTrackStation &tStation = vtStations[ i ];
+		double pdfSiteECEF[ 3 ] = { tStation.dfECEFX, tStation.dfECEFY, tStation.dfECEFZ };
+
+		AddStation( tStation.dfLatitude, tStation.dfLongitude, pdfSiteECEF );
+	}
+}
+
+/******************************************************************************************
+
+  Local east, north, up components and range of one satellite position for the lanes of
+  a block, no branch in the loop
+
+*******************************************************************************************/
+
+void cSiteFanOut::ComputeBlock( const stSiteBlock &tBlock, const double *pdfPos, double *pdfEast,
+								double *pdfNorth, double *pdfUp, double *pdfRange )
+{
+	const double dfX = pdfPos[ 0 ], dfY = pdfPos[ 1 ], dfZ = pdfPos[ 2 ];
+
+	for( int i = 0; i < SITE_FANOUT_LANES; i++ )
+	{
+		double dX = dfX - tBlock.pdfX[ i ];
+		double dY = dfY - tBlock.pdfY[ i ];
+		double dZ = dfZ - tBlock.pdfZ[ i ];
+
+		pdfEast[ i ] = tBlock.pdfEastX[ i ] * dX + tBlock.pdfEastY[ i ] * dY;
+		pdfNorth[ i ] = tBlock.pdfNorthX[ i ] * dX + tBlock.pdfNorthY[ i ] * dY + tBlock.pdfNorthZ[ i ] * dZ;
+		pdfUp[ i ] = tBlock.pdfUpX[ i ] * dX + tBlock.pdfUpY[ i ] * dY + tBlock.pdfUpZ[ i ] * dZ;
+		pdfRange[ i ] = sqrt( dX * dX + dY * dY + dZ * dZ );
+	}
+}
+
+
+void cSiteFanOut::ComputeSinElevation( int nStates, const double *pdfPos, double *pdfSinEl ) const
+{
+	double pdfEast[ SITE_FANOUT_LANES ], pdfNorth[ SITE_FANOUT_LANES ], pdfUp[ SITE_FANOUT_LANES ];
+	double pdfRange[ SITE_FANOUT_LANES ], pdfSin[ SITE_FANOUT_LANES ];
+
+	for( int n = 0; n < nStates; n++ )
+	{
+		double *pdfOut = pdfSinEl + (size_t) n * m_nStations;
+
+		for( size_t b = 0; b < m_vtBlocks.size(); b++ )
+		{
+			const stSiteBlock &tBlock = m_vtBlocks[ b ];
+
+			ComputeBlock( tBlock, pdfPos + 3 * n, pdfEast, pdfNorth, pdfUp, pdfRange );
+			for( int i = 0; i < SITE_FANOUT_LANES; i++ ) pdfSin[ i ] = pdfUp[ i ] / pdfRange[ i ];
+
+			for( int i = 0; i < tBlock.nLanes; i++ ) pdfOut[ b * SITE_FANOUT_LANES + i ] = pdfSin[ i ];
+		}
+	}
+}
+
+
+void cSiteFanOut::ComputeAzElRange( int nStates, const double *pdfPos, double *pdfAz, double *pdfEl,
+									double *pdfRange ) const
+{
+	double pdfEast[ SITE_FANOUT_LANES ], pdfNorth[ SITE_FANOUT_LANES ], pdfUp[ SITE_FANOUT_LANES ];
+	double pdfLaneRange[ SITE_FANOUT_LANES ];
+
+	for( int n = 0; n < nStates; n++ )
+	{
+		size_t nOut = (size_t) n * m_nStations;
+
+		for( size_t b = 0; b < m_vtBlocks.size(); b++ )
+		{
+			const stSiteBlock &tBlock = m_vtBlocks[ b ];
+
+			ComputeBlock( tBlock, pdfPos + 3 * n, pdfEast, pdfNorth, pdfUp, pdfLaneRange );
+
+			for( int i = 0; i < tBlock.nLanes; i++, nOut++ )
+			{
+				double dfAz = atan2( pdfEast[ i ], pdfNorth[ i ] );
+
+				pdfAz[ nOut ] = dfAz < 0.0 ? dfAz + g_dfTWOPI : dfAz;
+				pdfEl[ nOut ] = asin( pdfUp[ i ] / pdfLaneRange[ i ] );
+				if( pdfRange != NULL ) pdfRange[ nOut ] = pdfLaneRange[ i ];
+			}
+		}
+	}
+}
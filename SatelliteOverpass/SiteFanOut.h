@@ -0,0 +1,84 @@
+/***************************************************************************
+
+ Topocentric coordinates of one satellite state seen from many stations
+
+ The stations are stored as structure of arrays, in blocks of
+ SITE_FANOUT_LANES stations, each with its ECEF origin and the rows of its
+ ECEF to east, north, up rotation taken from its cTopocentricSite. A
+ satellite position is propagated once and fanned out to all the stations:
+ the local east, north, up components and the range of a block are a loop
+ over the lanes with no branches in it, which the compiler maps to
+ AVX2/AVX-512 registers, so that the cost of the propagation does not grow
+ with the number of stations.
+
+ The elevation test against a mask only needs the sine of the elevation,
+ up / range, and no inverse trigonometric function. The azimuth and the
+ elevation themselves are computed from the lane results afterwards, by
+ the scalar atan2 and asin of the C library.
+
+***************************************************************************/
+#pragma once
+
+#include <windows.h>
+#include "DataStructure.h"
+#include "TopocentricSite.h"
+
+#include <vector>
+
+// number of stations evaluated together, as SGP4_BATCH_LANES
+#define SITE_FANOUT_LANES 8
+
+/***************************************************************************
+
+ One block of stations, unused lanes of the last block are copies of lane 0
+
+***************************************************************************/
+
+struct stSiteBlock
+{
+	double pdfX[ SITE_FANOUT_LANES ], pdfY[ SITE_FANOUT_LANES ], pdfZ[ SITE_FANOUT_LANES ];
+
+	// rows of the ECEF to local rotation
+	double pdfEastX[ SITE_FANOUT_LANES ], pdfEastY[ SITE_FANOUT_LANES ];
+	double pdfNorthX[ SITE_FANOUT_LANES ], pdfNorthY[ SITE_FANOUT_LANES ], pdfNorthZ[ SITE_FANOUT_LANES ];
+	double pdfUpX[ SITE_FANOUT_LANES ], pdfUpY[ SITE_FANOUT_LANES ], pdfUpZ[ SITE_FANOUT_LANES ];
+
+	int nLanes;		// number of lanes in use
+};
+
+
+class cSiteFanOut
+{
+	std::vector<stSiteBlock> m_vtBlocks;
+	int m_nStations;
+
+public:
+
+	cSiteFanOut();
+	~cSiteFanOut();
+
+	void Clear();
+
+	void AddStation( const cTopocentricSite &tSite );
+	// dfLatitude and dfLongitude in radian, pdfSiteECEF in meter
+	void AddStation( double dfLatitude, double dfLongitude, const double *pdfSiteECEF );
+	void SetStations( const std::vector<stTrackStation> &vtStations );
+
+	int GetStationNumber() const { return m_nStations; }
+
+	// pdfPos: nStates satellite ECEF positions in meter, 3 values per state
+	// outputs: GetStationNumber() values per state, station i of state n at n * GetStationNumber() + i
+
+	// sine of the elevation
+	void ComputeSinElevation( int nStates, const double *pdfPos, double *pdfSinEl ) const;
+
+	// azimuth in [0, 2pi) from the north to the east and elevation in radian, range in meter,
+	// pdfRange may be NULL
+	void ComputeAzElRange( int nStates, const double *pdfPos, double *pdfAz, double *pdfEl,
+						   double *pdfRange ) const;
+
+private:
+
+	static void ComputeBlock( const stSiteBlock &tBlock, const double *pdfPos, double *pdfEast,
+							  double *pdfNorth, double *pdfUp, double *pdfRange );
+};
@@ -29,6 +29,9 @@
 #include <math.h>
 #include "TLE2PosVel.h"
 #include "GreenwichSiderealTime.h"
+#include "TimeGrid.h"
+#include "SatelliteRegistry.h"
+#include "TLEStream.h"
 #include "DateTimeZ.h"
 #include "constant.h"
 
@@ -36,6 +39,10 @@
 cTLE2PosVel::cTLE2PosVel()
 {
 	m_bInit = FALSE;
+	m_bPosOnly = false;
+	m_bDeepSpace = FALSE;
+	m_bOrbitLowHigh = FALSE;
+	SelectSGP4Kernel();
 
 	m_dfEarthRadius = 6378135.0; 
 	m_dfMeanEarthRadius = 6371.0;
@@ -76,6 +83,8 @@ cTLE2PosVel::cTLE2PosVel()
 	m_dfZNL = 1.5835218e-04;
 	m_dfZEL = .05490;                                                                          
 
+	m_dfResonanceInterval = 1440.0;	// one checkpoint per day
+
 	m_nCounter=0;
 }
 
@@ -87,14 +96,23 @@ cTLE2PosVel::~cTLE2PosVel()
 
 /******************************************************************************************
 
-  Read the TLE of the given satellite ID from the given file
-
-  each set of TLE is given in 3 lines
+  Open a TLE file to be read line by line: "-", *.gz, *.zst and named pipes through the
+  stream, any other name as a file, which must exist. The readers return tStream.Close(),
+  so that a damaged file or a missing decompressor fails the read rather than ending it
+  early
 
 *******************************************************************************************/
 
-bool cTLE2PosVel::ReadTLE( int nNORADID, char *szFileName )
+static bool OpenTLEInput( const char *szFileName, cTLEStream &tStream, ifstream &tFile, istream &in )
 {
+	if( cTLEStream::IsStreamName( szFileName ) )
+	{
+		if( !tStream.Open( szFileName ) ) return false;
+
+		in.rdbuf( &tStream );
+		return true;
+	}
+
 	// check whether the given file exists
 	WIN32_FIND_DATA FindFileData;
 
@@ -104,8 +122,29 @@ bool cTLE2PosVel::ReadTLE( int nNORADID, char *szFileName )
 
 	FindClose( hFile );
 
+	tFile.open( szFileName );
+	in.rdbuf( tFile.rdbuf() );
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Read the TLE of the given satellite ID from the given file
+
+  each set of TLE is given in 3 lines
+
+*******************************************************************************************/
+
+bool cTLE2PosVel::ReadTLE( int nNORADID, char *szFileName )
+{
+	cTLEStream tStream;
+	ifstream tFile;
+	istream in( NULL );
+
+	if( !OpenTLEInput( szFileName, tStream, tFile, in ) ) return false;
+
 	string line;
-	ifstream in( szFileName );
 
 	stSatelliteIOE tIOE;
 
@@ -121,7 +160,7 @@ bool cTLE2PosVel::ReadTLE( int nNORADID, char *szFileName )
 			{
 				if( !ReadTLELine2( line, tIOE ) ) return false;
 				if( !SetOrbitalElements( tIOE ) ) return false;
-				return true;
+				return tStream.Close();
 			}
 		}
 	}
@@ -135,7 +174,16 @@ bool cTLE2PosVel::ReadTLE( int nNORADID, char *szFileName )
 
 *******************************************************************************************/
 
-bool cTLE2PosVel::SetOrbitalElements( stSatelliteIOE stIOE )
+bool cTLE2PosVel::SetOrbitalElements( const stSatelliteIOE &stIOE )
+{
+	stSatelliteElements tElements;
+	stIOE.GetElements( tElements );
+
+	return SetOrbitalElements( tElements );
+}
+
+
+bool cTLE2PosVel::SetOrbitalElements( const stSatelliteElements &stIOE )
 {
 	if( stIOE.nSatelliteID <= 0 ) {
 		m_nError = 1;
@@ -143,7 +191,9 @@ bool cTLE2PosVel::SetOrbitalElements( stSatelliteIOE stIOE )
 	}
 
 	m_bInit = false;
+	m_tWork.Reset();
 
+	m_pdfTLE[ 0 ] = (double) stIOE.nSatelliteID;
 	m_pdfTLE[ 3 ] = m_dfBSTAR = stIOE.pfElement7to18[ 2 ];
 	m_dfRefJD = stIOE.GetRefJD();
 
@@ -173,6 +223,7 @@ bool cTLE2PosVel::SetOrbitalElements( stSatelliteIOE stIOE )
 
 	if( !Initialise() ) return false;
 
+	SelectSGP4Kernel();
 	m_bInit = TRUE;
 
 	return true;
@@ -195,6 +246,7 @@ bool cTLE2PosVel::SetOrbitalElements( stSatelliteIOE stIOE )
 bool cTLE2PosVel::SetOrbitalElements( double *pdfTLE )
 {
 	m_bInit = FALSE;
+	m_tWork.Reset();
 
 	for( int i = 0; i < 10; i++ ) m_pdfTLE[ i ] = pdfTLE[ i ];
 
@@ -220,6 +272,7 @@ bool cTLE2PosVel::SetOrbitalElements( double *pdfTLE )
 
 	if( !Initialise() ) return false;
 
+	SelectSGP4Kernel();
 	m_bInit = TRUE;
 
 	return true;
@@ -252,7 +305,7 @@ bool cTLE2PosVel::GetOrbitalElements( double *pdfTLE )
 
 ******************************************************************************/
 
-void cTLE2PosVel::GetOrbitalElementsRefJD( double &dfRefJD )
+void cTLE2PosVel::GetOrbitalElementsRefJD( double &dfRefJD ) const
 {
 	dfRefJD = m_dfRefJD;
 }
@@ -271,11 +324,37 @@ bool cTLE2PosVel::ComputeInertialPosVel( double dfJD, double *pdfPos, double *pd
 {
 	if( !m_bInit ) return false;
 
-	if( !SGP4( dfJD, pdfPos, pdfVel ) ) return false;
+	if( !SGP4( dfJD, pdfPos, pdfVel, m_tWork ) ) 
+	{
+		m_nError = m_tWork.nError;
+		return false;
+	}
 
 	return true;
 }
 
+/******************************************************************************************
+
+  Reentrant version of ComputeInertialPosVel(). The propagator is not modified, all the
+  per-call quantities, including the deep space resonance integrator, are kept in tWork.
+  One initialised propagator can therefore be shared by many threads, each of which
+  owns its own work area.
+
+  dfJD: given time in JD
+  pdfPos: computed satellite inertial position, in meter
+  pdfVel: computed satellite inertial velocity, in meter/s
+  tWork: caller-owned work area, reused between calls of the same satellite
+
+*******************************************************************************************/
+
+bool cTLE2PosVel::ComputeInertialPosVel( double dfJD, double *pdfPos, double *pdfVel, 
+										 stSGP4WorkArea &tWork ) const
+{
+	if( !m_bInit ) return false;
+
+	return SGP4( dfJD, pdfPos, pdfVel, tWork );
+}
+
 /******************************************************************************************
 
   Compute the satellite inertial positiona nd velocity at the reference epoch of the TLE
@@ -295,7 +374,11 @@ bool cTLE2PosVel::ComputeInertialPosVel( double &dfIntJDUTCGivenEpoch, double &d
 
 	g_DateTimeZ.ReConstruct( dfIntJDUTCGivenEpoch, dfFraJDUTCGivenEpoch );
 
-	if( !SGP4( m_dfRefJD, pdfPos, pdfVel ) ) return false;
+	if( !SGP4( m_dfRefJD, pdfPos, pdfVel, m_tWork ) ) 
+	{
+		m_nError = m_tWork.nError;
+		return false;
+	}
 
 	return true;
 }
@@ -331,6 +414,51 @@ bool cTLE2PosVel::ComputeECEFPosVel( double dfJD, double *pdfPos, double *pdfVel
 	return true;
 }
 
+/******************************************************************************************
+
+  Reentrant version of ComputeECEFPosVel(), see ComputeInertialPosVel() above
+
+*******************************************************************************************/
+
+bool cTLE2PosVel::ComputeECEFPosVel( double dfJD, double *pdfPos, double *pdfVel, 
+									 stSGP4WorkArea &tWork ) const
+{
+	if( !m_bInit ) return false;
+
+	if( dfJD < 0.0 || pdfPos == nullptr || pdfVel == nullptr ) {
+		tWork.nError = 1;
+		return false;
+	}
+
+	if( !SGP4( dfJD, pdfPos, pdfVel, tWork ) ) return false;
+	FromInertialToEFEC( dfJD, pdfPos, pdfVel );	
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Reentrant ECEF position and velocity at epoch nEpoch of a time grid, the GST and its
+  sine and cosine are taken from the grid
+
+*******************************************************************************************/
+
+bool cTLE2PosVel::ComputeECEFPosVel( const cTimeGrid &tGrid, int nEpoch, double *pdfPos, double *pdfVel,
+									 stSGP4WorkArea &tWork ) const
+{
+	if( !m_bInit ) return false;
+
+	if( nEpoch < 0 || nEpoch >= tGrid.GetEpochNumber() || pdfPos == nullptr || pdfVel == nullptr ) {
+		tWork.nError = 1;
+		return false;
+	}
+
+	if( !SGP4( tGrid.GetJD( nEpoch ), pdfPos, pdfVel, tWork ) ) return false;
+	tGrid.FromInertialToECEF( nEpoch, pdfPos, m_bPosOnly ? NULL : pdfVel );
+
+	return true;
+}
+
 
 /******************************************************************************************
 
@@ -505,9 +633,16 @@ FOURTY:
 
   Implementation of the SGP4 algorithm
 
+  nRegime: SGP4_NEAR_EARTH, SGP4_LOW_PERIGEE or SGP4_DEEP_SPACE
+  bPosOnly: true if the velocity is not computed
+
+  Each variant contains only the code of its regime. The variant used is chosen by
+  SelectSGP4Kernel() when the orbital elements or the position-only state are set.
+
 *******************************************************************************************/
 
-bool cTLE2PosVel::SGP4( double dfJD, double *pdfPos, double *pdfVel )
+template< int nRegime, bool bPosOnly >
+bool cTLE2PosVel::SGP4Kernel( double dfJD, double *pdfPos, double *pdfVel, stSGP4WorkArea &tWork ) const
 {
 	double dfT = ( dfJD - m_dfRefJD ) * 1440.0;	// in minute
     double dfT2 = dfT * dfT;                                                                
@@ -517,9 +652,9 @@ bool cTLE2PosVel::SGP4( double dfJD, double *pdfPos, double *pdfVel )
     double dfPerifeeS = m_dfPerigee0 + m_dfPerigeeDot * dfT;	// Eq (23) of SGP4 Algorithm
     double dfRAANS = m_dfRAAN0 + m_dfRAANDot * dfT;				// Eq (24) of SGP4 Algorithm
 	
-    m_dfPerigeeM = dfPerifeeS;
-	m_dfMAM = dfMAS;                                        
-    m_dfRAANM = dfRAANS + m_dfRAANDot2Drag * dfT2;				// Eq (29) of SGP4 Algorithm
+    tWork.dfPerigeeM = dfPerifeeS;
+	tWork.dfMAM = dfMAS;                                        
+    tWork.dfRAANM = dfRAANS + m_dfRAANDot2Drag * dfT2;				// Eq (29) of SGP4 Algorithm
 	                                    
 	// secular drag terms
     double dfTempA = 1.0 - m_dfCC1 * dfT;			// first two terms in the bracket of Eq (31) of SGP4 Algorithm
@@ -528,7 +663,7 @@ bool cTLE2PosVel::SGP4( double dfJD, double *pdfPos, double *pdfVel )
 
 	double dfTemp;
 
-	if( !m_bOrbitLowHigh )
+	if constexpr( nRegime == SGP4_NEAR_EARTH )
 	{
 		// ( perigee height > 220km )                                       
 		double dfT3 = dfT2 * dfT;                                                               
@@ -537,64 +672,64 @@ bool cTLE2PosVel::SGP4( double dfJD, double *pdfPos, double *pdfVel )
 		double dfDeltaMA = m_dfMMDotDrag * 
 			               ( pow( 1.0 + m_dfEta * cos( dfMAS ),  3.0 ) - m_dfDeltaMA0 );
 		dfTemp = dfDeltaPerigee + dfDeltaMA;
-		m_dfMAM = dfMAS + dfTemp;				// Eq (27) of SGP4 Algorithm
-		m_dfPerigeeM = dfPerifeeS - dfTemp;		// Eq (28) of SGP4 Algorithm
+		tWork.dfMAM = dfMAS + dfTemp;				// Eq (27) of SGP4 Algorithm
+		tWork.dfPerigeeM = dfPerifeeS - dfTemp;		// Eq (28) of SGP4 Algorithm
 		dfTempA = dfTempA - m_dfD2 * dfT2 - m_dfD3 * dfT3 - m_dfD4 * dfT4;				// Ref. Eq (31) of SGP4 Algorithm
-		dfTempE = dfTempE + m_dfBSTAR * m_dfCC5 * ( sin( m_dfMAM ) - m_dfSinMAO );		// Ref. Eq (30) of SGP4 Algorithm
+		dfTempE = dfTempE + m_dfBSTAR * m_dfCC5 * ( sin( tWork.dfMAM ) - m_dfSinMAO );		// Ref. Eq (30) of SGP4 Algorithm
 		dfTempL = dfTempL + m_dfT3Coe * dfT3 + dfT4 *( m_dfT4Coe + dfT * m_dfT5Coe );	// Ref. Eq (31) of SGP4 Algorithm                             
 	}
 
 	// Secular Deep Space Effect
-	m_dfEccM = m_dfEcc0;
-	m_dfIncM = m_dfInc0;
-	m_dfMMM = m_dfMM0;
+	tWork.dfEccM = m_dfEcc0;
+	tWork.dfIncM = m_dfInc0;
+	tWork.dfMMM = m_dfMM0;
 		                                                      
-    if( m_bDeepSpace )
+    if constexpr( nRegime == SGP4_DEEP_SPACE )
 	{
-		m_dfTC = dfT;
-		if( !DeepSpaceSecularEffect() ) return false;            
+		tWork.dfTC = dfT;
+		if( !DeepSpaceSecularEffect( tWork ) ) return false;            
 	}                                                               
 
-    m_dfSMM = pow( m_dfEarthGM / m_dfMMM, m_df2O3 ) * pow( dfTempA, 2.0 );	// Eq (31) of SGP4 Algorithm
-	m_dfMMM = m_dfEarthGM / pow( m_dfSMM, 1.5 );
-	m_dfEccM = m_dfEccM - dfTempE;											// Eq (30) of SGP4 Algorithm
-	if( m_dfEccM >= 1.0 || m_dfEccM < -1.0e-3 ) 	
+    tWork.dfSMM = pow( m_dfEarthGM / tWork.dfMMM, m_df2O3 ) * pow( dfTempA, 2.0 );	// Eq (31) of SGP4 Algorithm
+	tWork.dfMMM = m_dfEarthGM / pow( tWork.dfSMM, 1.5 );
+	tWork.dfEccM = tWork.dfEccM - dfTempE;											// Eq (30) of SGP4 Algorithm
+	if( tWork.dfEccM >= 1.0 || tWork.dfEccM < -1.0e-3 ) 	
 	{
-		m_nError = 1;
+		tWork.nError = 1;
 		return false;
 	}
                                             
-	if ( m_dfEccM < 0.0 ) m_dfEccM = 1.e-6;	
-    m_dfMAM += m_dfMM0 * dfTempL;	
-	double dfXLM = m_dfMAM + m_dfPerigeeM + m_dfRAANM;						// Eq (32) of SGP4 Algorithm
-	double dfEMSQ = m_dfEccM * m_dfEccM;
+	if ( tWork.dfEccM < 0.0 ) tWork.dfEccM = 1.e-6;	
+    tWork.dfMAM += m_dfMM0 * dfTempL;	
+	double dfXLM = tWork.dfMAM + tWork.dfPerigeeM + tWork.dfRAANM;						// Eq (32) of SGP4 Algorithm
+	double dfEMSQ = tWork.dfEccM * tWork.dfEccM;
     dfTemp = 1.0 - dfEMSQ;                            
     double dfRTEMSQ = sqrt( dfTemp );
-	m_dfRAANM = fmod( m_dfRAANM, g_dfTWOPI );
-	m_dfPerigeeM = fmod( m_dfPerigeeM, g_dfTWOPI );
+	tWork.dfRAANM = fmod( tWork.dfRAANM, g_dfTWOPI );
+	tWork.dfPerigeeM = fmod( tWork.dfPerigeeM, g_dfTWOPI );
 	dfXLM = fmod( dfXLM, g_dfTWOPI );
-	m_dfMAM = fmod( dfXLM - m_dfPerigeeM - m_dfRAANM, g_dfTWOPI );
+	tWork.dfMAM = fmod( dfXLM - tWork.dfPerigeeM - tWork.dfRAANM, g_dfTWOPI );
                                                                            
 	// COMPUTE EXTRA MEAN QUANTITIES                                                                          
-	double dfSinIM = sin( m_dfIncM );
-	double dfCosIM = cos( m_dfIncM );
-	double dfSinPerigeeM = sin( m_dfPerigeeM );
-	double dfCosPerigeeM = cos( m_dfPerigeeM );
+	double dfSinIM = sin( tWork.dfIncM );
+	double dfCosIM = cos( tWork.dfIncM );
+	double dfSinPerigeeM = sin( tWork.dfPerigeeM );
+	double dfCosPerigeeM = cos( tWork.dfPerigeeM );
 	
 	
 	// ADD LUNAR-SOLAR PERIODICS                                                                                                                       
-	double dfMMP = m_dfMMM;
-	double dfEccP = m_dfEccM;
-	double dfIncP = m_dfIncM;
-	double dfPerigeeP = m_dfPerigeeM;
-	double dfRAANP = m_dfRAANM;
-	double dfMAP = m_dfMAM;
+	double dfMMP = tWork.dfMMM;
+	double dfEccP = tWork.dfEccM;
+	double dfIncP = tWork.dfIncM;
+	double dfPerigeeP = tWork.dfPerigeeM;
+	double dfRAANP = tWork.dfRAANM;
+	double dfMAP = tWork.dfMAM;
 	double dfSinIP = dfSinIM;
 	double dfCosIP = dfCosIM;
 	
-	if( m_bDeepSpace ) 
+	if constexpr( nRegime == SGP4_DEEP_SPACE ) 
 	{
-		if( !DeepSpacePeriodicEffect( dfEccP, dfIncP, dfRAANP, dfPerigeeP, dfMAP ) ) return false;
+		if( !DeepSpacePeriodicEffect( tWork, dfEccP, dfIncP, dfRAANP, dfPerigeeP, dfMAP ) ) return false;
 		if( dfIncP < 0.0 ) 
 		{
 			dfIncP = - dfIncP;
@@ -605,24 +740,29 @@ bool cTLE2PosVel::SGP4( double dfJD, double *pdfPos, double *pdfVel )
 
 	if( dfEccP < 0.0 || dfEccP > 1.0 ) 
 	{
-		m_nError = 1;
+		tWork.nError = 1;
 		return false;
 	}
                                                                            
 	// LONG PERIOD PERIODICS                                                                          
-	if( m_bDeepSpace ) 
+	// the deep space coefficients depend on the perturbed inclination, so they are
+	// kept local to this call instead of overwriting the epoch values
+	double dfAYCOF = m_dfAYCOF, dfXLCOF = m_dfXLCOF;
+	double dfCon41 = m_dfCon41, dfX1MTH2 = m_dfX1MTH2, dfX7THM1 = m_dfX7THM1;
+
+	if constexpr( nRegime == SGP4_DEEP_SPACE ) 
 	{
 		dfSinIP = sin( dfIncP );
 		dfCosIP = cos( dfIncP );                                               
-		m_dfAYCOF = -.5 * m_dfJ3OJ2 * dfSinIP;			// Eq (37) of SGP4 Algorithm
-		m_dfXLCOF = -.25 * m_dfJ3OJ2 * dfSinIP * ( 3.0 + 5.0 * dfCosIP ) / 
-			        ( 1.0 + dfCosIP );					// Eq (36) of SGP4 Algorithm
+		dfAYCOF = -.5 * m_dfJ3OJ2 * dfSinIP;			// Eq (37) of SGP4 Algorithm
+		dfXLCOF = -.25 * m_dfJ3OJ2 * dfSinIP * ( 3.0 + 5.0 * dfCosIP ) / 
+			      ( 1.0 + dfCosIP );					// Eq (36) of SGP4 Algorithm
 	}
 
 	double dfAXNL = dfEccP * cos( dfPerigeeP );									// Eq (35) of SGP4 Algorithm
-	dfTemp = 1.0 / ( m_dfSMM * ( 1.0 - dfEccP * dfEccP ) );
-	double dfAYNL = dfEccP * sin( dfPerigeeP ) + dfTemp * m_dfAYCOF;			// Eq (39) of SGP4 Algorithm
-	double dfXL = dfMAP + dfPerigeeP + dfRAANP + dfTemp * m_dfXLCOF * dfAXNL;	// Eq (38) of SGP4 Algorithm
+	dfTemp = 1.0 / ( tWork.dfSMM * ( 1.0 - dfEccP * dfEccP ) );
+	double dfAYNL = dfEccP * sin( dfPerigeeP ) + dfTemp * dfAYCOF;			// Eq (39) of SGP4 Algorithm
+	double dfXL = dfMAP + dfPerigeeP + dfRAANP + dfTemp * dfXLCOF * dfAXNL;	// Eq (38) of SGP4 Algorithm
 	
 	// SOLVE KEPLER'S EQUATION, Eqs (40)-(43) of SGP4 Algorthm	                                                                           
     double dfU = fmod( dfXL - dfRAANP, g_dfTWOPI );
@@ -644,21 +784,19 @@ bool cTLE2PosVel::SGP4( double dfJD, double *pdfPos, double *pdfVel )
 	double dfeCosE = dfAXNL * dfCosE01 + dfAYNL * dfSinE01;		// Eq (44) of SGP4 Algorithm
 	double dfeSinE = dfAXNL * dfSinE01 - dfAYNL * dfCosE01;		// Eq (45) of SGP4 Algorithm
 	double dfEL2 = dfAXNL * dfAXNL + dfAYNL * dfAYNL;			// Eq (46) of SGP4 Algorithm
-	double dfPL = m_dfSMM * ( 1.0 - dfEL2 );					// Eq (47) of SGP4 Algorithm
+	double dfPL = tWork.dfSMM * ( 1.0 - dfEL2 );					// Eq (47) of SGP4 Algorithm
 	
 	if( dfPL < 0.0 ) 
 	{
-		m_nError = 1;
+		tWork.nError = 1;
 		return false;
 	}
 		
-	double dfRL = m_dfSMM * ( 1.0 - dfeCosE );				// Eq (48) of SGP4 Algorithm
-    double dfRDotL = sqrt( m_dfSMM ) * dfeSinE / dfRL;		// Eq (49) of SGP4 Algorithm
-	double dfRVDotL = sqrt( dfPL ) / dfRL;					// Eq (50) of SGP4 Algorithm
+	double dfRL = tWork.dfSMM * ( 1.0 - dfeCosE );				// Eq (48) of SGP4 Algorithm
 	double dfBETAL = sqrt( 1.0 - dfEL2 );					// sqrt root part of Eqs (51) and (52) of SGP4 Algorithm
 	dfTemp = dfeSinE / ( 1.0 + dfBETAL );					// Eqs (51) and (52) of SGP4 Algorithm
-	double dfSinU = m_dfSMM / dfRL * ( dfSinE01 - dfAYNL - dfAXNL * dfTemp );	// Eq (52) of SGP4 Algorithm                                    
-    double dfCosU = m_dfSMM / dfRL * ( dfCosE01 - dfAXNL + dfAYNL * dfTemp );	// Eq (51) of SGP4 Algorithm
+	double dfSinU = tWork.dfSMM / dfRL * ( dfSinE01 - dfAYNL - dfAXNL * dfTemp );	// Eq (52) of SGP4 Algorithm                                    
+    double dfCosU = tWork.dfSMM / dfRL * ( dfCosE01 - dfAXNL + dfAYNL * dfTemp );	// Eq (51) of SGP4 Algorithm
 	double dfSU = atan2( dfSinU, dfCosU );			// Eq (53) of SGP4 Algorithm
 	double dfSin2U = ( dfCosU + dfCosU ) * dfSinU;
 	double dfCos2U = 1.0 - 2.0 * dfSinU * dfSinU;
@@ -667,24 +805,19 @@ bool cTLE2PosVel::SGP4( double dfJD, double *pdfPos, double *pdfVel )
 	double dfTEMP2 = dfTEMP1 * dfTemp;				// Eq (55) of SGP4 Algorithm
                                                                            
 	// UPDATE FOR SHORT PERIOD PERIODICS                                                                          
-	if( m_bDeepSpace ) 
+	if constexpr( nRegime == SGP4_DEEP_SPACE ) 
 	{
-		double m_dfCosI2 = dfCosIP * dfCosIP;
-		m_dfCon41 = 3.0 * m_dfCosI2 - 1.0;
-		m_dfX1MTH2 = 1.0 - m_dfCosI2;
-		m_dfX7THM1 = 7.0 * m_dfCosI2 - 1.0;
+		double dfCosI2 = dfCosIP * dfCosIP;
+		dfCon41 = 3.0 * dfCosI2 - 1.0;
+		dfX1MTH2 = 1.0 - dfCosI2;
+		dfX7THM1 = 7.0 * dfCosI2 - 1.0;
 	}
 
-	double dfRT = dfRL * ( 1.0 - 1.5 * dfTEMP2 * dfBETAL * m_dfCon41 ) +		// Eq (60) of SGP4 Algorithm
-		          0.5 * dfTEMP1 * m_dfX1MTH2 * dfCos2U;							// Eq (54) of SGP4 Algorithm
-	dfSU = dfSU - .25 * dfTEMP2 * m_dfX7THM1 * dfSin2U;							// Eqs (55) and (61)of SGP4 Algorithm
+	double dfRT = dfRL * ( 1.0 - 1.5 * dfTEMP2 * dfBETAL * dfCon41 ) +		// Eq (60) of SGP4 Algorithm
+		          0.5 * dfTEMP1 * dfX1MTH2 * dfCos2U;							// Eq (54) of SGP4 Algorithm
+	dfSU = dfSU - .25 * dfTEMP2 * dfX7THM1 * dfSin2U;							// Eqs (55) and (61)of SGP4 Algorithm
 	double dfRAANT = dfRAANP + 1.5 * dfTEMP2 * dfCosIP * dfSin2U;				// Eqs (56) and (62)of SGP4 Algorithm
 	double dfIncT = dfIncP + 1.5 * dfTEMP2 * dfCosIP * dfSinIP * dfCos2U;		// Eqs (57) and (63)of SGP4 Algorithm
-	double dfRDot = dfRDotL - 
-		            m_dfMMM * dfTEMP1 * m_dfX1MTH2 * dfSin2U / m_dfEarthGM;		// Eqs (58) and (64)of SGP4 Algorithm
-	double dfRVDot = dfRVDotL + 
-		             m_dfMMM * dfTEMP1 * 
-					 ( m_dfX1MTH2 * dfCos2U + 1.5 * m_dfCon41 ) / m_dfEarthGM;	// Eqs (59) and (65)of SGP4 Algorithm
                                                                           
 	// ORIENTATION VECTORS	                                                             
 	double dfSinSU = sin( dfSU );
@@ -709,7 +842,15 @@ bool cTLE2PosVel::SGP4( double dfJD, double *pdfPos, double *pdfVel )
 	pdfPos[ 1 ] = dfRT * dfUY * m_dfEarthRadius; 
 	pdfPos[ 2 ] = dfRT * dfUZ * m_dfEarthRadius; 
 
-	if( m_bPosOnly ) return true;
+	if constexpr( bPosOnly ) return true;
+
+    double dfRDotL = sqrt( tWork.dfSMM ) * dfeSinE / dfRL;		// Eq (49) of SGP4 Algorithm
+	double dfRVDotL = sqrt( dfPL ) / dfRL;					// Eq (50) of SGP4 Algorithm
+	double dfRDot = dfRDotL - 
+		            tWork.dfMMM * dfTEMP1 * dfX1MTH2 * dfSin2U / m_dfEarthGM;		// Eqs (58) and (64)of SGP4 Algorithm
+	double dfRVDot = dfRVDotL + 
+		             tWork.dfMMM * dfTEMP1 * 
+					 ( dfX1MTH2 * dfCos2U + 1.5 * dfCon41 ) / m_dfEarthGM;	// Eqs (59) and (65)of SGP4 Algorithm
 
 	// Eq (67) of SGP4 Algorithm
     double dfVX = dfMx *  dfCosSU - dfCosNode * dfSinSU;
@@ -724,6 +865,38 @@ bool cTLE2PosVel::SGP4( double dfJD, double *pdfPos, double *pdfVel )
 	return true;
 }
 
+/******************************************************************************************
+
+  Choose the SGP4 variant for the regime of the orbit and the position-only state
+
+*******************************************************************************************/
+
+void cTLE2PosVel::SelectSGP4Kernel()
+{
+	if( m_bDeepSpace )
+	{
+		if( m_bPosOnly ) m_pfnSGP4 = &cTLE2PosVel::SGP4Kernel< SGP4_DEEP_SPACE, true >;
+		else m_pfnSGP4 = &cTLE2PosVel::SGP4Kernel< SGP4_DEEP_SPACE, false >;
+	}
+	else if( m_bOrbitLowHigh )
+	{
+		if( m_bPosOnly ) m_pfnSGP4 = &cTLE2PosVel::SGP4Kernel< SGP4_LOW_PERIGEE, true >;
+		else m_pfnSGP4 = &cTLE2PosVel::SGP4Kernel< SGP4_LOW_PERIGEE, false >;
+	}
+	else
+	{
+		if( m_bPosOnly ) m_pfnSGP4 = &cTLE2PosVel::SGP4Kernel< SGP4_NEAR_EARTH, true >;
+		else m_pfnSGP4 = &cTLE2PosVel::SGP4Kernel< SGP4_NEAR_EARTH, false >;
+	}
+}
+
+
+void cTLE2PosVel::SetComputePositionOnly( bool bState )
+{
+	m_bPosOnly = bState;
+	SelectSGP4Kernel();
+}
+
 /******************************************************************************************
 
   Initialisation of the deep space effect
@@ -935,9 +1108,9 @@ bool cTLE2PosVel::InitialiseDeepSpace()
 	}
 
 	// FOR SGP4, INITIALIZE THE resonance INTEGRATOR                                                                           
-	m_dfXLI = m_dfXLAMO;
-	m_dfXNI = m_dfMM0;
-    m_dfATIME = 0.0;
+	// the integrator state itself lives in stSGP4WorkArea, it starts from the
+	// checkpoints built below
+	m_tWork.Reset();
 	m_dfSTEPP = 720.0;
 	m_dfSTEPN = -720.0;
 	m_dfSTEP2 = 259200.0;
@@ -948,6 +1121,10 @@ bool cTLE2PosVel::InitialiseDeepSpace()
 	else m_dfXFACT = m_dfMMDot + m_dfDMDT + 
 		             2.0 * ( m_dfRAANDot + m_dfDNODT - m_dfEarthRotationPerMinute ) - m_dfMM0;
 
+	m_vtResonanceAfter.clear();
+	m_vtResonanceBefore.clear();
+	if( m_nIREZ != 0 ) BuildResonanceCheckpoints( SGP4_RESONANCE_CHECKPOINT_DAYS, SGP4_RESONANCE_CHECKPOINT_DAYS );
+
 	// end of first part of FORTRAN subroutine SREZ
 
 /*************************************************************************************************/
@@ -1102,29 +1279,29 @@ bool cTLE2PosVel::DSCOM()
 
 *******************************************************************************************/
 
-bool cTLE2PosVel::DeepSpaceSecularEffect()
+bool cTLE2PosVel::DeepSpaceSecularEffect( stSGP4WorkArea &tWork ) const
 {
-	m_dfDNDT = 0.0;
-	double dfTHETA = fmod( m_dfGSTAtRefEpoch + m_dfTC * m_dfEarthRotationPerMinute, g_dfTWOPI );
+	tWork.dfDNDT = 0.0;
+	double dfTHETA = fmod( m_dfGSTAtRefEpoch + tWork.dfTC * m_dfEarthRotationPerMinute, g_dfTWOPI );
 	
-	m_dfEccM += m_dfDEDT * m_dfTC;
-    m_dfIncM += m_dfDIDT * m_dfTC;
-	m_dfPerigeeM += m_dfDOMDT * m_dfTC;
-	m_dfRAANM += m_dfDNODT * m_dfTC;
-	m_dfMAM += m_dfDMDT * m_dfTC;
+	tWork.dfEccM += m_dfDEDT * tWork.dfTC;
+    tWork.dfIncM += m_dfDIDT * tWork.dfTC;
+	tWork.dfPerigeeM += m_dfDOMDT * tWork.dfTC;
+	tWork.dfRAANM += m_dfDNODT * tWork.dfTC;
+	tWork.dfMAM += m_dfDMDT * tWork.dfTC;
 	
-	if( m_dfIncM < 0.0 ) 
+	if( tWork.dfIncM < 0.0 ) 
 	{
-		m_dfIncM = -m_dfIncM;
-		m_dfPerigeeM -= g_dfPI;
-		m_dfRAANM += g_dfPI;
+		tWork.dfIncM = -tWork.dfIncM;
+		tWork.dfPerigeeM -= g_dfPI;
+		tWork.dfRAANM += g_dfPI;
 	}
 
 	if( m_nIREZ == 0 ) return true;
 
-	if( !DeepSapceResonance( dfTHETA ) ) return true;                           
+	if( !DeepSapceResonance( dfTHETA, tWork ) ) return true;                           
     
-	m_dfMMM = m_dfMM0 + m_dfDNDT;
+	tWork.dfMMM = m_dfMM0 + tWork.dfDNDT;
 	
 	return true;
 }
@@ -1137,60 +1314,47 @@ bool cTLE2PosVel::DeepSpaceSecularEffect()
 
 *******************************************************************************************/
 
-bool cTLE2PosVel::DeepSapceResonance( double dfTHETA )
+bool cTLE2PosVel::DeepSapceResonance( double dfTHETA, stSGP4WorkArea &tWork ) const
 {
 	double G22 = 5.7686396, G32 = 0.95240898;
 	double G44 = 1.8014998, G52 = 1.0508330;
 	double G54 = 4.4108898;
 
 	double DELT=0.0, FT=0.0;
-	int IRET = 0, IRETN = 0;
+	int IRETN = 0;
 	double XNDT, XNDDT, XLDOT;
 	double XL;
 
-	if( m_dfATIME == 0.0 ) goto T390;
-	if( m_dfTC >= 0.0 && m_dfATIME < 0.0 ) goto T390;
-	if( m_dfTC < 0.0 && m_dfATIME >= 0.0 ) goto T390;
-
-T351:
-	if( fabs( m_dfTC ) < fabs( m_dfATIME ) )
-	{
-		if( m_dfTC >= 0.0 ) DELT = m_dfSTEPN;
-		else DELT = m_dfSTEPP;
-
-		IRET = 351;
-		goto T380;
-	}
+	// the integration always runs away from the epoch, starting from the nearest
+	// checkpoint or from the last computed point, so the result does not depend on
+	// the order of the calls
+	StartResonance( tWork );
 
-	if( m_dfTC < 0.0 ) DELT = m_dfSTEPN;
+	if( tWork.dfTC < 0.0 ) DELT = m_dfSTEPN;
 	else DELT = m_dfSTEPP;
 
 T356:
-	if( fabs( m_dfTC - m_dfATIME ) >= m_dfSTEPP ) 
-	{
-		IRET = 0;
-		goto T380;
-	}
+	if( fabs( tWork.dfTC - tWork.dfATIME ) >= m_dfSTEPP ) goto T380;
 	else
 	{
-		FT = m_dfTC - m_dfATIME;
+		FT = tWork.dfTC - tWork.dfATIME;
 		IRETN = 0;
 		goto T370;
 	}
 
 T361:
-	m_dfMMM = m_dfXNI + XNDT * FT + XNDDT * FT * FT *.5;
-	XL = m_dfXLI + XLDOT * FT + XNDT * FT * FT *.5;
+	tWork.dfMMM = tWork.dfXNI + XNDT * FT + XNDDT * FT * FT *.5;
+	XL = tWork.dfXLI + XLDOT * FT + XNDT * FT * FT *.5;
 	if( m_nIREZ == 2 )
 	{
-		m_dfMAM = XL - 2.0 * m_dfRAANM + 2.0 * dfTHETA;
-		m_dfDNDT = m_dfMMM - m_dfMM0;
+		tWork.dfMAM = XL - 2.0 * tWork.dfRAANM + 2.0 * dfTHETA;
+		tWork.dfDNDT = tWork.dfMMM - m_dfMM0;
 		return true;
 	}
 	else
 	{
-		m_dfMAM = XL - m_dfRAANM - m_dfPerigeeM + dfTHETA;                                           
-		m_dfDNDT = m_dfMMM - m_dfMM0;
+		tWork.dfMAM = XL - tWork.dfRAANM - tWork.dfPerigeeM + dfTHETA;                                           
+		tWork.dfDNDT = tWork.dfMMM - m_dfMM0;
 		return true;
 	}
 
@@ -1199,37 +1363,37 @@ T361:
 T370:
 	if( m_nIREZ == 1 ) //NEAR - SYNCHRONOUS RESONANCE TERMS
 	{
-		XNDT = m_dfDEL1 * sin( m_dfXLI - m_dfFASX2 ) + 
-		       m_dfDEL2 * sin( 2.0 * ( m_dfXLI - m_dfFASX4 ) ) +
-               m_dfDEL3 * sin( 3.0 * ( m_dfXLI - m_dfFASX6 ) );                                      
-		XLDOT = m_dfXNI + m_dfXFACT;
-		XNDDT = m_dfDEL1 * cos( m_dfXLI - m_dfFASX2 ) +
-			    2.0 * m_dfDEL2 * cos( 2.0 * ( m_dfXLI - m_dfFASX4 ) ) +
-				3.0 * m_dfDEL3 * cos( 3.0 * ( m_dfXLI - m_dfFASX6 ) );
+		XNDT = m_dfDEL1 * sin( tWork.dfXLI - m_dfFASX2 ) + 
+		       m_dfDEL2 * sin( 2.0 * ( tWork.dfXLI - m_dfFASX4 ) ) +
+               m_dfDEL3 * sin( 3.0 * ( tWork.dfXLI - m_dfFASX6 ) );                                      
+		XLDOT = tWork.dfXNI + m_dfXFACT;
+		XNDDT = m_dfDEL1 * cos( tWork.dfXLI - m_dfFASX2 ) +
+			    2.0 * m_dfDEL2 * cos( 2.0 * ( tWork.dfXLI - m_dfFASX4 ) ) +
+				3.0 * m_dfDEL3 * cos( 3.0 * ( tWork.dfXLI - m_dfFASX6 ) );
 		XNDDT = XNDDT * XLDOT;
 	}
 	else // NEAR - HALF-DAY RESONANCE TERMS                                       
 	{
-		double XOMI = m_dfPerigee0 + m_dfPerigeeDot * m_dfATIME;
+		double XOMI = m_dfPerigee0 + m_dfPerigeeDot * tWork.dfATIME;
 		double X2OMI = XOMI + XOMI;
-		double X2LI = m_dfXLI + m_dfXLI;
-		XNDT = m_dfD2201 * sin( X2OMI + m_dfXLI - G22 ) +
-               m_dfD2211 * sin( m_dfXLI - G22 ) +
-			   m_dfD3210 * sin( XOMI + m_dfXLI - G32 ) +
-			   m_dfD3222 * sin( -XOMI + m_dfXLI - G32 ) +
+		double X2LI = tWork.dfXLI + tWork.dfXLI;
+		XNDT = m_dfD2201 * sin( X2OMI + tWork.dfXLI - G22 ) +
+               m_dfD2211 * sin( tWork.dfXLI - G22 ) +
+			   m_dfD3210 * sin( XOMI + tWork.dfXLI - G32 ) +
+			   m_dfD3222 * sin( -XOMI + tWork.dfXLI - G32 ) +
 			   m_dfD4410 * sin( X2OMI + X2LI - G44 ) +
 			   m_dfD4422 * sin( X2LI - G44 ) +
-			   m_dfD5220 * sin( XOMI + m_dfXLI - G52 ) +
-			   m_dfD5232 * sin( -XOMI + m_dfXLI - G52 ) +
+			   m_dfD5220 * sin( XOMI + tWork.dfXLI - G52 ) +
+			   m_dfD5232 * sin( -XOMI + tWork.dfXLI - G52 ) +
 			   m_dfD5421 * sin( XOMI + X2LI - G54 ) +
 			   m_dfD5433 * sin( -XOMI + X2LI - G54 );
-		XLDOT = m_dfXNI + m_dfXFACT;
-		XNDDT = m_dfD2201 * cos( X2OMI + m_dfXLI - G22 ) +
-			    m_dfD2211 * cos( m_dfXLI - G22 ) +
-				m_dfD3210 * cos( XOMI + m_dfXLI - G32 ) +
-				m_dfD3222 * cos( -XOMI + m_dfXLI - G32 ) +
-				m_dfD5220 * cos( XOMI + m_dfXLI - G52 ) +
-				m_dfD5232 * cos( -XOMI + m_dfXLI - G52 ) +
+		XLDOT = tWork.dfXNI + m_dfXFACT;
+		XNDDT = m_dfD2201 * cos( X2OMI + tWork.dfXLI - G22 ) +
+			    m_dfD2211 * cos( tWork.dfXLI - G22 ) +
+				m_dfD3210 * cos( XOMI + tWork.dfXLI - G32 ) +
+				m_dfD3222 * cos( -XOMI + tWork.dfXLI - G32 ) +
+				m_dfD5220 * cos( XOMI + tWork.dfXLI - G52 ) +
+				m_dfD5232 * cos( -XOMI + tWork.dfXLI - G52 ) +
 				2.0 * ( m_dfD4410 * cos( X2OMI + X2LI - G44 ) +
 				        m_dfD4422 * cos( X2LI - G44 ) +
 						m_dfD5421 * cos( XOMI + X2LI - G54 ) +
@@ -1247,26 +1411,90 @@ T380:
 	goto T370;
 
 T381:
-	m_dfXLI = m_dfXLI + XLDOT * DELT + XNDT * m_dfSTEP2; 
-	m_dfXNI = m_dfXNI + XNDT * DELT + XNDDT * m_dfSTEP2;
-	m_dfATIME += DELT;
+	tWork.dfXLI = tWork.dfXLI + XLDOT * DELT + XNDT * m_dfSTEP2; 
+	tWork.dfXNI = tWork.dfXNI + XNDT * DELT + XNDDT * m_dfSTEP2;
+	tWork.dfATIME += DELT;
 	
-	if( IRET == 351 ) goto T351;
 	goto T356;                                                             
-                                                                            
-T390:
-	if( m_dfTC >= 0.0 ) DELT = m_dfSTEPP;
-	else DELT = m_dfSTEPN;
-	
-	m_dfATIME = 0.0;
-	m_dfXNI = m_dfMM0;
-	m_dfXLI = m_dfXLAMO;
-
-	goto T356;
 
 	//return true; 20170313 lei
 }
 
+/******************************************************************************************
+
+  Set the starting point of the resonance integration for the time in tWork.dfTC
+
+  The nearest checkpoint between the epoch and the given time is used, unless the 
+  last computed point in tWork lies between that checkpoint and the given time.
+
+*******************************************************************************************/
+
+void cTLE2PosVel::StartResonance( stSGP4WorkArea &tWork ) const
+{
+	const std::vector<stResonanceState> &vtCheckpoint = tWork.dfTC >= 0.0 ? m_vtResonanceAfter : m_vtResonanceBefore;
+
+	int nCheckpoint = (int) ( fabs( tWork.dfTC ) / m_dfResonanceInterval );
+	if( nCheckpoint >= (int) vtCheckpoint.size() ) nCheckpoint = (int) vtCheckpoint.size() - 1;
+
+	const stResonanceState &tCheckpoint = vtCheckpoint[ nCheckpoint ];
+
+	bool bSameSide = ( tWork.dfTC >= 0.0 && tWork.dfATIME > 0.0 ) || ( tWork.dfTC < 0.0 && tWork.dfATIME < 0.0 );
+
+	if( bSameSide && fabs( tWork.dfATIME ) <= fabs( tWork.dfTC ) && 
+		fabs( tWork.dfATIME ) > fabs( tCheckpoint.dfATIME ) ) return;
+
+	tWork.dfATIME = tCheckpoint.dfATIME;
+	tWork.dfXLI = tCheckpoint.dfXLI;
+	tWork.dfXNI = tCheckpoint.dfXNI;
+}
+
+/******************************************************************************************
+
+  Build the checkpoints of the resonance integration, one per day over the given
+  number of days before and after the epoch
+
+  The epoch itself is always the first checkpoint. Queries outside the covered period
+  integrate on from the last checkpoint.
+
+*******************************************************************************************/
+
+bool cTLE2PosVel::BuildResonanceCheckpoints( int nDaysBefore, int nDaysAfter )
+{
+	if( !m_bDeepSpace || m_nIREZ == 0 ) return false;
+
+	stResonanceState tEpoch;
+	tEpoch.dfATIME = 0.0;
+	tEpoch.dfXNI = m_dfMM0;
+	tEpoch.dfXLI = m_dfXLAMO;
+
+	m_vtResonanceAfter.assign( 1, tEpoch );
+	m_vtResonanceBefore.assign( 1, tEpoch );
+
+	stSGP4WorkArea tWork;
+
+	for( int i = 1; i <= nDaysAfter; i++ )
+	{
+		tWork.dfTC = i * m_dfResonanceInterval;
+		DeepSapceResonance( 0.0, tWork );
+
+		stResonanceState tState = { tWork.dfATIME, tWork.dfXLI, tWork.dfXNI };
+		m_vtResonanceAfter.push_back( tState );
+	}
+
+	tWork.Reset();
+
+	for( int i = 1; i <= nDaysBefore; i++ )
+	{
+		tWork.dfTC = -i * m_dfResonanceInterval;
+		DeepSapceResonance( 0.0, tWork );
+
+		stResonanceState tState = { tWork.dfATIME, tWork.dfXLI, tWork.dfXNI };
+		m_vtResonanceBefore.push_back( tState );
+	}
+
+	return true;
+}
+
 /******************************************************************************************
 
   Compute the periodic part of the deep space effect
@@ -1275,11 +1503,12 @@ T390:
 
 *******************************************************************************************/
 
-bool cTLE2PosVel::DeepSpacePeriodicEffect( double &dfEccP, double &dfIncP, double &dfRAANP,
-										   double &dfPerigeeP, double &dfMAP )
+bool cTLE2PosVel::DeepSpacePeriodicEffect( const stSGP4WorkArea &tWork, 
+										   double &dfEccP, double &dfIncP, double &dfRAANP,
+										   double &dfPerigeeP, double &dfMAP ) const
 {
 	// for the Sun
-	double ZM = m_dfZMOS + m_dfZNS * m_dfTC;
+	double ZM = m_dfZMOS + m_dfZNS * tWork.dfTC;
 	double ZF = ZM + 2.0 * m_dfZES * sin( ZM );
 	double SINZF = sin( ZF );
 	double F2 = .5 * SINZF * SINZF -.25;
@@ -1291,7 +1520,7 @@ bool cTLE2PosVel::DeepSpacePeriodicEffect( double &dfEccP, double &dfIncP, doubl
 	double SHS = m_dfDSSH2 * F2 + m_dfDSSH3 * F3;
 	
 	// for the Moon
-	ZM = m_dfZMOL + m_dfZNL * m_dfTC;
+	ZM = m_dfZMOL + m_dfZNL * tWork.dfTC;
 	ZF = ZM + 2.0 * m_dfZEL * sin( ZM );
 	SINZF = sin( ZF );
 	F2 = .5 * SINZF * SINZF - .25;
@@ -1364,7 +1593,7 @@ bool cTLE2PosVel::DeepSpacePeriodicEffect( double &dfEccP, double &dfIncP, doubl
 
 **********************************************************************************************/
 
-bool cTLE2PosVel::FromInertialToEFEC( double dfJD, double *pdfPos, double *pdfVel )
+bool cTLE2PosVel::FromInertialToEFEC( double dfJD, double *pdfPos, double *pdfVel ) const
 {
 	double dfGST = cGreenwichST::ComputeGST( dfJD );
 	double dfSin = sin( dfGST ), dfCos = cos( dfGST );
@@ -1401,9 +1630,9 @@ bool cTLE2PosVel::ReadTLELine1( string line, stSatelliteIOE &stIOE )
 
 	string sub;
 
-	// norad number of the object
+	// norad number of the object, Alpha-5 included
 	sub = line.substr( 1, 6 );
-	stIOE.nSatelliteID = atoi( sub.c_str() );
+	stIOE.nSatelliteID = cSatelliteRegistry::DecodeCatalogNumber( sub.c_str() + 1 );
 
 	// ref date/time
 	sub = line.substr( 18, 2 );
@@ -1539,14 +1768,14 @@ bool cTLE2PosVel::CheckSum( string line )
 ******************************************************************************/
 
 void cTLE2PosVel::GetPerigeeApogeeHeights( double &dfPerigeeHeight, 
-										   double &dfApogeeHeight )
+										   double &dfApogeeHeight ) const
 {
 	dfPerigeeHeight = ( m_dfQ0 - 1.0 ) * m_dfEarthRadius;
 	dfApogeeHeight = ( m_dfQ1 - 1.0 ) * m_dfEarthRadius;
 }
 
 
-void cTLE2PosVel::GetTLE( double *pdfTLE )
+void cTLE2PosVel::GetTLE( double *pdfTLE ) const
 {
 	for( int i = 0; i < 10; i++ ) pdfTLE[ i ] = m_pdfTLE[ i ];
 }
@@ -1571,23 +1800,16 @@ bool cTLE2PosVel::ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *
 {
 	try
 	{
-		// check whether the given file exists
 		//TLEData.clear( );
 		//TLEData.reserve( 100 );
 
-		WIN32_FIND_DATA FindFileData;
-
-		HANDLE hFile = FindFirstFile( szFileName, &FindFileData );
-
-		if( hFile == INVALID_HANDLE_VALUE ) 
-		{
-			return false;
-		}
+		cTLEStream tStream;
+		ifstream tFile;
+		istream in( NULL );
 
-		FindClose( hFile );
+		if( !OpenTLEInput( szFileName, tStream, tFile, in ) ) return false;
 
 		string line;
-		ifstream in( szFileName );
 		
 		stSatelliteIOE tIOE;
 
@@ -1629,7 +1851,7 @@ bool cTLE2PosVel::ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *
 				{
 					//eosLOG( "error reading TLE file ");
 					// end of file
-					return true;
+					return tStream.Close();
 				}
 			
 				// Line 2
@@ -1661,7 +1883,7 @@ bool cTLE2PosVel::ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *
 			}
 		}
 
-		return true;
+		return tStream.Close();
 	}
 	catch( ... )
 	{
@@ -1675,26 +1897,23 @@ bool cTLE2PosVel::ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *
 {
 	try
 	{
-		// check whether the given file exists
 		//TLEData.clear( );
 		//TLEData.reserve( 100 );
 
-		WIN32_FIND_DATA FindFileData;
-
-		HANDLE hFile = FindFirstFile( szFileName, &FindFileData );
-
-		if( hFile == INVALID_HANDLE_VALUE ) 
-		{
-			return false;
-		}
+		cTLEStream tStream;
+		ifstream tFile;
+		istream in( NULL );
 
-		FindClose( hFile );
+		if( !OpenTLEInput( szFileName, tStream, tFile, in ) ) return false;
 
 		string line;
-		ifstream in( szFileName );
 		
 		stSatelliteIOE tIOE;
 
+		// the requested NORAD IDs
+		cSatelliteRegistry tRequested;
+		for( int k = 0; k < numberID; k++ ) tRequested.Insert( noradID[ k ] );
+
 		while( getline( in, line ) )	// 
 		{
 			try
@@ -1733,7 +1952,7 @@ bool cTLE2PosVel::ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *
 				{
 					//eosLOG( "error reading TLE file ");
 					// end of file
-					return true;
+					return tStream.Close();
 				}
 			
 				// Line 2
@@ -1750,22 +1969,14 @@ bool cTLE2PosVel::ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *
 					}
 				}
 
-				for( int k = 0; k < numberID; k++ )
-				{
-					int id = tIOE.nSatelliteID;
-					if( id == noradID[ id ] )
-					{
-						TLEData.push_back( tIOE );
-						break;
-					}
-				}				
+				if( tRequested.Contains( tIOE.nSatelliteID ) ) TLEData.push_back( tIOE );
 			}
 			catch( ... )
 			{
 			}
 		}
 
-		return true;
+		return tStream.Close();
 	}
 	catch( ... )
 	{
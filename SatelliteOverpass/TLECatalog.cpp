@@ -0,0 +1,253 @@
+/***************************************************************************
+
+ Binary indexed TLE catalog
+
+***************************************************************************/
+#undef UNICODE
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include "TLECatalog.h"
+
+// file layout version of Write() and Open()
+#define TLE_CATALOG_VERSION 1
+
+#define TLE_CATALOG_HEADER_SIZE ( 4 + 4 * sizeof( int ) )
+
+
+void stCatalogRecord::Get( stSatelliteElements &stIOE ) const
+{
+	memset( &stIOE, 0, sizeof( stIOE ) );
+
+	stIOE.nSatelliteID = nSatelliteID;
+	stIOE.cElementType = 'T';
+	stIOE.nIntJD = nIntJD;
+	stIOE.nFractionJD = nFractionJD;
+
+	for( int i = 0; i < 6; i++ ) stIOE.pnElement1to6[ i ] = pnElement1to6[ i ];
+
+	stIOE.pfElement7to18[ 0 ] = pfElement[ 0 ];
+	stIOE.pfElement7to18[ 1 ] = pfElement[ 1 ];
+	stIOE.pfElement7to18[ 2 ] = pfElement[ 2 ];
+	stIOE.pfElement7to18[ 11 ] = pfElement[ 3 ];
+}
+
+
+void stCatalogRecord::Set( const stSatelliteElements &stIOE )
+{
+	nSatelliteID = stIOE.nSatelliteID;
+	nIntJD = stIOE.nIntJD;
+	nFractionJD = stIOE.nFractionJD;
+
+	for( int i = 0; i < 6; i++ ) pnElement1to6[ i ] = stIOE.pnElement1to6[ i ];
+
+	pfElement[ 0 ] = stIOE.pfElement7to18[ 0 ];
+	pfElement[ 1 ] = stIOE.pfElement7to18[ 1 ];
+	pfElement[ 2 ] = stIOE.pfElement7to18[ 2 ];
+	pfElement[ 3 ] = stIOE.pfElement7to18[ 11 ];
+
+	nReserved = 0;
+}
+
+
+cTLECatalog::cTLECatalog()
+{
+	m_ptIndex = NULL;
+	m_ptRecords = NULL;
+	m_nSatellites = m_nRecords = 0;
+	m_nError = 0;
+}
+
+
+cTLECatalog::~cTLECatalog()
+{
+
+}
+
+
+bool cTLECatalog::Write( const std::vector<stSatelliteElements> &TLEData, const char *szCatalogFile )
+{
+	std::vector<stCatalogRecord> vtRecords( TLEData.size() );
+	for( size_t i = 0; i < TLEData.size(); i++ ) vtRecords[ i ].Set( TLEData[ i ] );
+
+	return WriteRecords( vtRecords, szCatalogFile );
+}
+
+
+bool cTLECatalog::Write( const std::vector<stSatelliteIOE> &TLEData, const char *szCatalogFile )
+{
+	std::vector<stCatalogRecord> vtRecords( TLEData.size() );
+	stSatelliteElements tElements;
+
+	for( size_t i = 0; i < TLEData.size(); i++ )
+	{
+		TLEData[ i ].GetElements( tElements );
+		vtRecords[ i ].Set( tElements );
+	}
+
+	return WriteRecords( vtRecords, szCatalogFile );
+}
+
+/******************************************************************************************
+
+  Sort the element sets by NORAD ID and epoch, and write the index and the records
+
+*******************************************************************************************/
+
+bool cTLECatalog::WriteRecords( std::vector<stCatalogRecord> &vtRecords, const char *szCatalogFile )
+{
+	std::stable_sort( vtRecords.begin(), vtRecords.end(),
+					  []( const stCatalogRecord &a, const stCatalogRecord &b )
+					  {
+						  if( a.nSatelliteID != b.nSatelliteID ) return a.nSatelliteID < b.nSatelliteID;
+						  if( a.nIntJD != b.nIntJD ) return a.nIntJD < b.nIntJD;
+						  return a.nFractionJD < b.nFractionJD;
+					  } );
+
+	std::vector<stCatalogIndex> vtIndex;
+	for( int i = 0; i < (int) vtRecords.size(); i++ )
+	{
+		if( vtIndex.empty() || vtIndex.back().nSatelliteID != vtRecords[ i ].nSatelliteID )
+		{
+			stCatalogIndex tIndex = { vtRecords[ i ].nSatelliteID, i, 0 };
+			vtIndex.push_back( tIndex );
+		}
+
+		vtIndex.back().nCount++;
+	}
+
+	FILE *stream = fopen( szCatalogFile, "wb" );
+	if( stream == NULL ) return false;
+
+	int pnHeader[ 4 ];
+	pnHeader[ 0 ] = TLE_CATALOG_VERSION;
+	pnHeader[ 1 ] = (int) sizeof( stCatalogRecord );
+	pnHeader[ 2 ] = (int) vtIndex.size();
+	pnHeader[ 3 ] = (int) vtRecords.size();
+
+	bool bOK = fwrite( "TLEC", 1, 4, stream ) == 4 &&
+			   fwrite( pnHeader, sizeof( int ), 4, stream ) == 4 &&
+			   fwrite( vtIndex.data(), sizeof( stCatalogIndex ), vtIndex.size(), stream ) == vtIndex.size() &&
+			   fwrite( vtRecords.data(), sizeof( stCatalogRecord ), vtRecords.size(), stream ) == vtRecords.size();
+
+	if( fclose( stream ) != 0 ) bOK = false;
+
+	return bOK;
+}
+
+
+bool cTLECatalog::Convert( const char *szTLEFile, const char *szCatalogFile, int nThreads )
+{
+	cTLEParser tParser;
+	tParser.SetThreadNumber( nThreads );
+
+	std::vector<stSatelliteElements> TLEData;
+	if( !tParser.ReadAllTLE( TLEData, szTLEFile ) ) return false;
+
+	return Write( TLEData, szCatalogFile );
+}
+
+/******************************************************************************************
+
+  Map the catalog and check its layout against the size of the file, and each index 
+  entry against the records, so that a damaged file cannot send Find() out of bounds
+
+*******************************************************************************************/
+
+bool cTLECatalog::Open( const char *szCatalogFile )
+{
+	Close();
+
+	if( !m_tFile.Open( szCatalogFile ) || m_tFile.GetSize() < TLE_CATALOG_HEADER_SIZE )
+	{
+		Close();
+		m_nError = 1;
+		return false;
+	}
+
+	const char *pData = m_tFile.GetData();
+
+	int pnHeader[ 4 ];
+	memcpy( pnHeader, pData + 4, sizeof( pnHeader ) );
+
+	bool bOK = memcmp( pData, "TLEC", 4 ) == 0 && pnHeader[ 0 ] == TLE_CATALOG_VERSION &&
+			   pnHeader[ 1 ] == (int) sizeof( stCatalogRecord ) && pnHeader[ 2 ] >= 0 && pnHeader[ 3 ] >= 0 &&
+			   m_tFile.GetSize() == TLE_CATALOG_HEADER_SIZE + pnHeader[ 2 ] * sizeof( stCatalogIndex ) +
+									pnHeader[ 3 ] * sizeof( stCatalogRecord );
+
+	// a non empty range of records in each entry, the NORAD IDs strictly increasing
+	const stCatalogIndex *ptIndex = (const stCatalogIndex *) ( pData + TLE_CATALOG_HEADER_SIZE );
+
+	for( int i = 0; bOK && i < pnHeader[ 2 ]; i++ )
+	{
+		const stCatalogIndex &tIndex = ptIndex[ i ];
+
+		bOK = tIndex.nCount > 0 && tIndex.nFirst >= 0 && tIndex.nFirst <= pnHeader[ 3 ] - tIndex.nCount &&
+			  ( i == 0 || ptIndex[ i - 1 ].nSatelliteID < tIndex.nSatelliteID );
+	}
+
+	if( !bOK )
+	{
+		Close();
+		m_nError = 1;
+		return false;
+	}
+
+	m_nSatellites = pnHeader[ 2 ];
+	m_nRecords = pnHeader[ 3 ];
+	m_ptIndex = ptIndex;
+	m_ptRecords = (const stCatalogRecord *) ( m_ptIndex + m_nSatellites );
+
+	return true;
+}
+
+
+void cTLECatalog::Close()
+{
+	m_tFile.Close();
+
+	m_ptIndex = NULL;
+	m_ptRecords = NULL;
+	m_nSatellites = m_nRecords = 0;
+}
+
+
+const stCatalogRecord *cTLECatalog::Find( int nNORADID, int &nCount ) const
+{
+	nCount = 0;
+	if( m_nSatellites == 0 ) return NULL;
+
+	const stCatalogIndex *pIndex = std::lower_bound( m_ptIndex, m_ptIndex + m_nSatellites, nNORADID,
+													 []( const stCatalogIndex &tIndex, int nID )
+													 {
+														 return tIndex.nSatelliteID < nID;
+													 } );
+
+	if( pIndex == m_ptIndex + m_nSatellites || pIndex->nSatelliteID != nNORADID ) return NULL;
+
+	nCount = pIndex->nCount;
+
+	return m_ptRecords + pIndex->nFirst;
+}
+
+
+bool cTLECatalog::GetElements( int nNORADID, stSatelliteElements &stIOE ) const
+{
+	int nCount;
+	const stCatalogRecord *pRecord = Find( nNORADID, nCount );
+	if( pRecord == NULL ) return false;
+
+	pRecord[ nCount - 1 ].Get( stIOE );
+
+	return true;
+}
+
+
+bool cTLECatalog::ReadTLE( int nNORADID, cTLE2PosVel &tSat ) const
+{
+	stSatelliteElements tIOE;
+	if( !GetElements( nNORADID, tIOE ) ) return false;
+
+	return tSat.SetOrbitalElements( tIOE );
+}
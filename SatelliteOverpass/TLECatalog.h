@@ -0,0 +1,106 @@
+/***************************************************************************
+
+ Binary indexed TLE catalog
+
+ The numeric fields of the element sets of a text catalog are stored in a
+ binary file as fixed size records, sorted by NORAD ID and then by epoch,
+ after an index of the satellites. The file is memory mapped when it is
+ opened, with no parsing, and the element sets of a satellite are found by
+ a binary search of the index.
+
+ File layout, in the byte order of the machine which wrote it:
+
+	"TLEC"
+	int version, size of a record, number of satellites, number of records
+	stCatalogIndex  [ number of satellites ], in increasing NORAD ID
+	stCatalogRecord [ number of records ]
+
+***************************************************************************/
+#pragma once
+
+#include "TLE2PosVel.h"
+#include "TLEParser.h"
+
+#include <vector>
+
+/***************************************************************************
+
+ Element set of a satellite as stored in the catalog, the same units as
+ stSatelliteElements
+
+***************************************************************************/
+
+struct stCatalogRecord
+{
+	int nSatelliteID;
+	int nIntJD, nFractionJD;
+
+	int pnElement1to6[ 6 ];
+	float pfElement[ 4 ];		// n dot, n dot dot, BSTAR and orbital period in days
+	int nReserved;
+
+	void Get( stSatelliteElements &stIOE ) const;
+	void Set( const stSatelliteElements &stIOE );
+
+	double GetRefJD() const { return ( (double)nIntJD + (double)nFractionJD * 1.0e-9 ); }
+};
+
+/***************************************************************************
+
+ Element sets of a satellite, records nFirst to nFirst + nCount - 1
+
+***************************************************************************/
+
+struct stCatalogIndex
+{
+	int nSatelliteID;
+	int nFirst;
+	int nCount;
+};
+
+
+class cTLECatalog
+{
+	cMappedFile m_tFile;
+
+	const stCatalogIndex *m_ptIndex;
+	const stCatalogRecord *m_ptRecords;
+	int m_nSatellites, m_nRecords;
+
+	int m_nError;
+
+public:
+
+	cTLECatalog();
+	~cTLECatalog();
+
+	// write the element sets as a catalog, in any order
+	static bool Write( const std::vector<stSatelliteElements> &TLEData, const char *szCatalogFile );
+	static bool Write( const std::vector<stSatelliteIOE> &TLEData, const char *szCatalogFile );
+
+	// convert a text TLE file, parsed on nThreads threads (0 for one per core)
+	static bool Convert( const char *szTLEFile, const char *szCatalogFile, int nThreads = 1 );
+
+	bool Open( const char *szCatalogFile );
+	void Close();
+	bool IsOpen() const { return m_ptRecords != NULL; }
+
+	int GetSatelliteNumber() const { return m_nSatellites; }
+	int GetRecordNumber() const { return m_nRecords; }
+
+	// all the records, sorted by NORAD ID and epoch
+	const stCatalogRecord *GetRecords() const { return m_ptRecords; }
+
+	// element sets of the satellite in increasing epoch, NULL and nCount 0 if not found
+	const stCatalogRecord *Find( int nNORADID, int &nCount ) const;
+
+	// latest element set of the satellite
+	bool GetElements( int nNORADID, stSatelliteElements &stIOE ) const;
+
+	// same as cTLE2PosVel::ReadTLE(), with the latest element set of the satellite
+	bool ReadTLE( int nNORADID, cTLE2PosVel &tSat ) const;
+
+private:
+
+	static bool WriteRecords( std::vector<stCatalogRecord> &vtRecords, const char *szCatalogFile );
+};
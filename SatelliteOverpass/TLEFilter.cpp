@@ -0,0 +1,178 @@
+/***************************************************************************
+
+ Selection of the TLE records of a catalog
+
+***************************************************************************/
+#undef UNICODE
+
+#include <math.h>
+#include "TLEFilter.h"
+#include "DateTimeZ.h"
+
+
+cTLEFilter::cTLEFilter()
+{
+	Clear();
+}
+
+
+cTLEFilter::~cTLEFilter()
+{
+
+}
+
+
+void cTLEFilter::Clear()
+{
+	m_tIDs.Clear();
+	m_bIDs = false;
+
+	m_dfMinInclination = m_dfMaxInclination = 0.0;
+	m_bInclination = false;
+
+	m_dfPerigeeLimit = m_dfApogeeLimit = 0.0;
+	m_bPerigeeApogee = false;
+
+	m_dfMinMeanMotion = m_dfMaxMeanMotion = 0.0;
+	m_bMeanMotion = false;
+
+	m_nMinYear = 0;
+	m_dfMinDay = 0.0;
+	m_bEpoch = false;
+
+	m_bNamePattern = false;
+}
+
+
+void cTLEFilter::SetIDs( int nIDs, const int *pnIDs )
+{
+	m_tIDs.Clear();
+	for( int i = 0; i < nIDs; i++ ) m_tIDs.Insert( pnIDs[ i ] );
+
+	m_bIDs = true;
+}
+
+
+void cTLEFilter::SetIDs( const cSatelliteRegistry &tIDs )
+{
+	m_tIDs = tIDs;
+	m_bIDs = true;
+}
+
+
+void cTLEFilter::SetInclination( double dfMin, double dfMax )
+{
+	m_dfMinInclination = dfMin;
+	m_dfMaxInclination = dfMax;
+	m_bInclination = true;
+}
+
+
+void cTLEFilter::SetMeanMotion( double dfMin, double dfMax )
+{
+	m_dfMinMeanMotion = dfMin;
+	m_dfMaxMeanMotion = dfMax;
+	m_bMeanMotion = true;
+}
+
+
+void cTLEFilter::SetPerigeeApogee( double dfPerigeeLimit, double dfApogeeLimit )
+{
+	m_dfPerigeeLimit = dfPerigeeLimit;
+	m_dfApogeeLimit = dfApogeeLimit;
+	m_bPerigeeApogee = true;
+}
+
+/******************************************************************************************
+
+  The oldest epoch is kept as the year and the day of year of the TLE, so that the epoch
+  of a record is compared without converting it to JD
+
+*******************************************************************************************/
+
+void cTLEFilter::SetEpochAge( double dfJD, double dfMaxAge )
+{
+	double dfMinJD = dfJD - dfMaxAge, dfYearJD, s;
+	int m, d, h, mm;
+
+	g_DateTimeZ.JD2DateTime( dfMinJD, m_nMinYear, m, d, h, mm, s );
+	g_DateTimeZ.DateTime2JD( m_nMinYear, 1, 0, 0, 0, 0.0, dfYearJD );
+
+	m_dfMinDay = dfMinJD - dfYearJD;
+	m_bEpoch = true;
+}
+
+
+bool cTLEFilter::SetNamePattern( const char *szPattern )
+{
+	try
+	{
+		m_tNamePattern.assign( szPattern, std::regex::ECMAScript | std::regex::optimize );
+	}
+	catch( const std::regex_error & )
+	{
+		m_bNamePattern = false;
+		return false;
+	}
+
+	m_bNamePattern = true;
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Test the record, the fields decoded as cTLEParser::DecodeRecord()
+
+*******************************************************************************************/
+
+bool cTLEFilter::Accept( const stTLERecord &tRecord ) const
+{
+	const char *pLine1 = tRecord.pLine1, *pLine2 = tRecord.pLine2;
+
+	if( m_bIDs && !m_tIDs.Contains( cSatelliteRegistry::DecodeCatalogNumber( pLine1 + 2 ) ) ) return false;
+
+	if( m_bEpoch )
+	{
+		int nYear = cTLEParser::DecodeInteger( pLine1 + 18, 2 );
+		if( nYear < 90 ) nYear += 2000;
+		else nYear += 1900;
+
+		if( nYear < m_nMinYear ) return false;
+		if( nYear == m_nMinYear && cTLEParser::DecodeFixedDecimal( pLine1 + 20, 3, 8 ) < m_dfMinDay ) return false;
+	}
+
+	double dfMeanMotion = 0.0;
+	if( m_bMeanMotion || m_bPerigeeApogee )
+	{
+		// rev/day at the 1e-8 resolution of stSatelliteIOE
+		dfMeanMotion = (int)( cTLEParser::DecodeFixedDecimal( pLine2 + 52, 2, 8 ) * 1.0e8 ) * 1.0e-8;
+
+		if( m_bMeanMotion && ( dfMeanMotion < m_dfMinMeanMotion || dfMeanMotion > m_dfMaxMeanMotion ) ) return false;
+	}
+
+	if( m_bInclination )
+	{
+		double dfInclination = (int)( cTLEParser::DecodeFixedDecimal( pLine2 + 8, 3, 4 ) * 1.0e5 ) * 1.0e-5;
+
+		if( dfInclination < m_dfMinInclination || dfInclination > m_dfMaxInclination ) return false;
+	}
+
+	if( m_bPerigeeApogee )
+	{
+		double ecc = cTLEParser::DecodeInteger( pLine2 + 26, 7 ) * 1.0e-7;
+
+		double dfn = 2 * 3.1415926 * dfMeanMotion / 86400.0;
+		double sm = pow( 3.986004418e14/( dfn*dfn ), 1.0/3.0 );
+
+		if( !( sm * ( 1.0 - ecc ) > m_dfPerigeeLimit && sm * ( 1.0 + ecc ) < m_dfApogeeLimit ) ) return false;
+	}
+
+	if( m_bNamePattern )
+	{
+		if( tRecord.pName == NULL ) return false;
+		if( !std::regex_search( tRecord.pName, tRecord.pName + tRecord.nNameLength, m_tNamePattern ) ) return false;
+	}
+
+	return true;
+}
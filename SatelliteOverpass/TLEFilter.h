@@ -0,0 +1,71 @@
+/***************************************************************************
+
+ Selection of the TLE records of a catalog
+
+ The predicates are tested on the text of the record, each field decoded
+ only when its predicate is set, before the record is decoded into
+ elements: the catalog number first, then the epoch, the mean motion, the
+ inclination, the perigee and apogee, and the name last. Records rejected
+ cost no more than the fields looked at.
+
+ The perigee and apogee are computed from the mean motion and the
+ eccentricity as in stSatelliteIOE::GetSemiMajor(), the same as the
+ perigee test of cTLE2PosVel::ReadAllTLE().
+
+***************************************************************************/
+#pragma once
+
+#include "TLEParser.h"
+#include "SatelliteRegistry.h"
+
+#include <regex>
+
+class cTLEFilter
+{
+	cSatelliteRegistry m_tIDs;
+	bool m_bIDs;
+
+	double m_dfMinInclination, m_dfMaxInclination;		// deg
+	bool m_bInclination;
+
+	double m_dfPerigeeLimit, m_dfApogeeLimit;			// geocentric, m
+	bool m_bPerigeeApogee;
+
+	double m_dfMinMeanMotion, m_dfMaxMeanMotion;		// rev/day
+	bool m_bMeanMotion;
+
+	// oldest epoch, as its year and day of year
+	int m_nMinYear;
+	double m_dfMinDay;
+	bool m_bEpoch;
+
+	std::regex m_tNamePattern;
+	bool m_bNamePattern;
+
+public:
+
+	cTLEFilter();
+	~cTLEFilter();
+
+	// only the given catalog numbers
+	void SetIDs( int nIDs, const int *pnIDs );
+	void SetIDs( const cSatelliteRegistry &tIDs );
+
+	// ranges in deg and rev/day, bounds included
+	void SetInclination( double dfMin, double dfMax );
+	void SetMeanMotion( double dfMin, double dfMax );
+
+	// perigee above dfPerigeeLimit and apogee below dfApogeeLimit, geocentric in m
+	void SetPerigeeApogee( double dfPerigeeLimit, double dfApogeeLimit );
+
+	// epoch at most dfMaxAge days before dfJD
+	void SetEpochAge( double dfJD, double dfMaxAge );
+
+	// ECMAScript regular expression searched in the name line, records without a name
+	// rejected, false if the pattern is not valid
+	bool SetNamePattern( const char *szPattern );
+
+	void Clear();
+
+	bool Accept( const stTLERecord &tRecord ) const;
+};
@@ -0,0 +1,211 @@
+/***************************************************************************
+
+ History of the element sets of many satellites
+
+***************************************************************************/
+#undef UNICODE
+
+#include <algorithm>
+#include "TLEHistory.h"
+
+// propagators kept by default
+#define TLE_HISTORY_CACHE_SIZE 16
+
+
+cTLEHistory::cTLEHistory()
+{
+	m_nUseCounter = 0;
+	m_nInitialisations = 0;
+	m_nError = 0;
+
+	SetCacheSize( TLE_HISTORY_CACHE_SIZE );
+}
+
+
+cTLEHistory::~cTLEHistory()
+{
+
+}
+
+
+void cTLEHistory::Add( const std::vector<stSatelliteElements> &vtElements )
+{
+	m_vtElements.insert( m_vtElements.end(), vtElements.begin(), vtElements.end() );
+
+	BuildIndex();
+}
+
+
+bool cTLEHistory::ReadText( const char *szTLEFile, const cTLEFilter *pFilter, int nThreads )
+{
+	cTLEParser tParser;
+	tParser.SetThreadNumber( nThreads );
+
+	std::vector<stSatelliteElements> vtElements;
+	bool bOK = pFilter != NULL ? tParser.ReadAllTLE( vtElements, szTLEFile, *pFilter ) :
+								 tParser.ReadAllTLE( vtElements, szTLEFile );
+	if( !bOK )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	Add( vtElements );
+
+	return true;
+}
+
+
+bool cTLEHistory::ReadCatalog( const char *szCatalogFile )
+{
+	cTLECatalog tCatalog;
+	if( !tCatalog.Open( szCatalogFile ) )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	std::vector<stSatelliteElements> vtElements( tCatalog.GetRecordNumber() );
+
+	const stCatalogRecord *pRecords = tCatalog.GetRecords();
+	for( int i = 0; i < tCatalog.GetRecordNumber(); i++ ) pRecords[ i ].Get( vtElements[ i ] );
+
+	Add( vtElements );
+
+	return true;
+}
+
+
+void cTLEHistory::Clear()
+{
+	m_vtElements.clear();
+	m_vtIndex.clear();
+
+	SetCacheSize( (int) m_vtPropagators.size() );
+}
+
+/******************************************************************************************
+
+  Sort the element sets by NORAD ID and epoch and index the satellites, the cached
+  propagators refer to the old order and are dropped
+
+*******************************************************************************************/
+
+void cTLEHistory::BuildIndex()
+{
+	std::stable_sort( m_vtElements.begin(), m_vtElements.end(),
+					  []( const stSatelliteElements &a, const stSatelliteElements &b )
+					  {
+						  if( a.nSatelliteID != b.nSatelliteID ) return a.nSatelliteID < b.nSatelliteID;
+						  if( a.nIntJD != b.nIntJD ) return a.nIntJD < b.nIntJD;
+						  return a.nFractionJD < b.nFractionJD;
+					  } );
+
+	m_vtIndex.clear();
+	for( int i = 0; i < (int) m_vtElements.size(); i++ )
+	{
+		if( m_vtIndex.empty() || m_vtIndex.back().nSatelliteID != m_vtElements[ i ].nSatelliteID )
+		{
+			stCatalogIndex tIndex = { m_vtElements[ i ].nSatelliteID, i, 0 };
+			m_vtIndex.push_back( tIndex );
+		}
+
+		m_vtIndex.back().nCount++;
+	}
+
+	SetCacheSize( (int) m_vtPropagators.size() );
+}
+
+
+const stSatelliteElements *cTLEHistory::Find( int nNORADID, int &nCount ) const
+{
+	nCount = 0;
+
+	std::vector<stCatalogIndex>::const_iterator pIndex =
+		std::lower_bound( m_vtIndex.begin(), m_vtIndex.end(), nNORADID,
+						  []( const stCatalogIndex &tIndex, int nID )
+						  {
+							  return tIndex.nSatelliteID < nID;
+						  } );
+
+	if( pIndex == m_vtIndex.end() || pIndex->nSatelliteID != nNORADID ) return NULL;
+
+	nCount = pIndex->nCount;
+
+	return &m_vtElements[ pIndex->nFirst ];
+}
+
+
+const stSatelliteElements *cTLEHistory::Select( int nNORADID, double dfJD, int nSelection ) const
+{
+	int nCount;
+	const stSatelliteElements *pElements = Find( nNORADID, nCount );
+	if( pElements == NULL ) return NULL;
+
+	// first set with its epoch after dfJD
+	const stSatelliteElements *pAfter =
+		std::upper_bound( pElements, pElements + nCount, dfJD,
+						  []( double dfTime, const stSatelliteElements &tElements )
+						  {
+							  return dfTime < tElements.GetRefJD();
+						  } );
+
+	if( nSelection == TLE_SELECT_LATEST_BEFORE ) return pAfter == pElements ? NULL : pAfter - 1;
+
+	if( pAfter == pElements ) return pAfter;
+	if( pAfter == pElements + nCount ) return pAfter - 1;
+
+	return pAfter->GetRefJD() - dfJD < dfJD - ( pAfter - 1 )->GetRefJD() ? pAfter : pAfter - 1;
+}
+
+/******************************************************************************************
+
+  Propagator of the selected set, from the cache if it is there, otherwise initialised in
+  place of the least recently used one
+
+*******************************************************************************************/
+
+const cTLE2PosVel *cTLEHistory::GetPropagator( int nNORADID, double dfJD, int nSelection )
+{
+	const stSatelliteElements *pElements = Select( nNORADID, dfJD, nSelection );
+	if( pElements == NULL || m_vtPropagators.empty() ) return NULL;
+
+	int nRecord = (int) ( pElements - &m_vtElements[ 0 ] );
+
+	int nSlot = 0;
+	for( int i = 0; i < (int) m_vnCachedRecord.size(); i++ )
+	{
+		if( m_vnCachedRecord[ i ] == nRecord )
+		{
+			m_vnLastUse[ i ] = ++m_nUseCounter;
+			return &m_vtPropagators[ i ];
+		}
+
+		if( m_vnLastUse[ i ] < m_vnLastUse[ nSlot ] ) nSlot = i;
+	}
+
+	m_vnCachedRecord[ nSlot ] = -1;
+	m_nInitialisations++;
+
+	if( !m_vtPropagators[ nSlot ].SetOrbitalElements( *pElements ) )
+	{
+		m_nError = 1;
+		return NULL;
+	}
+
+	m_vnCachedRecord[ nSlot ] = nRecord;
+	m_vnLastUse[ nSlot ] = ++m_nUseCounter;
+
+	return &m_vtPropagators[ nSlot ];
+}
+
+
+void cTLEHistory::SetCacheSize( int nSize )
+{
+	if( nSize < 0 ) nSize = 0;
+
+	m_vtPropagators.clear();
+	m_vtPropagators.resize( nSize );
+	m_vnCachedRecord.assign( nSize, -1 );
+	m_vnLastUse.assign( nSize, 0 );
+}
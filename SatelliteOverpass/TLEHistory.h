@@ -0,0 +1,76 @@
+/***************************************************************************
+
+ History of the element sets of many satellites
+
+ The element sets are kept sorted by NORAD ID and epoch, with an index of
+ the satellites, so that the set which applies at a time is found by two
+ binary searches: the one with the epoch nearest to the time, or the
+ latest one at or before it.
+
+ Propagators initialised from the selected sets are kept in a small cache,
+ the least recently used one being replaced, so that a prediction which
+ goes back and forth between a few sets initialises each only once. A
+ propagator returned stays valid until it is replaced in the cache.
+
+***************************************************************************/
+#pragma once
+
+#include "TLE2PosVel.h"
+#include "TLECatalog.h"
+#include "TLEFilter.h"
+
+#include <vector>
+
+enum eTLESelection
+{
+	TLE_SELECT_NEAREST = 0,			// epoch nearest to the time
+	TLE_SELECT_LATEST_BEFORE = 1	// latest epoch at or before the time
+};
+
+class cTLEHistory
+{
+	std::vector<stSatelliteElements> m_vtElements;	// by NORAD ID, then epoch
+	std::vector<stCatalogIndex> m_vtIndex;
+
+	// propagator cache, record index -1 for an empty slot
+	std::vector<cTLE2PosVel> m_vtPropagators;
+	std::vector<int> m_vnCachedRecord;
+	std::vector<unsigned long long> m_vnLastUse;
+	unsigned long long m_nUseCounter;
+
+	int m_nInitialisations;		// propagators initialised by GetPropagator()
+	int m_nError;
+
+public:
+
+	cTLEHistory();
+	~cTLEHistory();
+
+	// element sets added to the history, in any order
+	void Add( const std::vector<stSatelliteElements> &vtElements );
+	bool ReadText( const char *szTLEFile, const cTLEFilter *pFilter = NULL, int nThreads = 1 );
+	bool ReadCatalog( const char *szCatalogFile );
+	void Clear();
+
+	int GetSatelliteNumber() const { return (int) m_vtIndex.size(); }
+	int GetElementSetNumber() const { return (int) m_vtElements.size(); }
+
+	// element sets of the satellite in increasing epoch, NULL and nCount 0 if not found
+	const stSatelliteElements *Find( int nNORADID, int &nCount ) const;
+
+	// set which applies at dfJD, NULL if the satellite is not found, or if no epoch is at
+	// or before dfJD for TLE_SELECT_LATEST_BEFORE
+	const stSatelliteElements *Select( int nNORADID, double dfJD, int nSelection = TLE_SELECT_NEAREST ) const;
+
+	// propagator initialised with the set which applies at dfJD, NULL if there is none or
+	// its initialisation fails
+	const cTLE2PosVel *GetPropagator( int nNORADID, double dfJD, int nSelection = TLE_SELECT_NEAREST );
+
+	// number of propagators kept, the cache is emptied
+	void SetCacheSize( int nSize );
+	int GetInitialisations() const { return m_nInitialisations; }
+
+private:
+
+	void BuildIndex();
+};
@@ -0,0 +1,783 @@
+/***************************************************************************
+
+ Memory mapped TLE catalog parser
+
+***************************************************************************/
+#undef UNICODE
+
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include "TLEParser.h"
+#include "TLEFilter.h"
+#include "TLEStream.h"
+#include "SatelliteRegistry.h"
+#include "DateTimeZ.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// exact powers of 10 for the decimal fields
+static const double s_pdfPowerOf10[ 19 ] =
+{
+	1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+	1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18
+};
+
+
+cMappedFile::cMappedFile()
+{
+	m_pData = NULL;
+	m_nSize = 0;
+
+#ifdef _WIN32
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_hMapping = NULL;
+#else
+	m_nFile = -1;
+#endif
+}
+
+
+cMappedFile::~cMappedFile()
+{
+	Close();
+}
+
+/******************************************************************************************
+
+  Map the whole file read only, an empty file is opened with no data
+
+*******************************************************************************************/
+
+bool cMappedFile::Open( const char *szFileName )
+{
+	Close();
+
+#ifdef _WIN32
+	m_hFile = CreateFileA( szFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+						   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+	if( m_hFile == INVALID_HANDLE_VALUE ) return false;
+
+	LARGE_INTEGER tSize;
+	if( !GetFileSizeEx( m_hFile, &tSize ) )
+	{
+		Close();
+		return false;
+	}
+
+	m_nSize = (size_t) tSize.QuadPart;
+	if( m_nSize == 0 ) return true;
+
+	m_hMapping = CreateFileMappingA( m_hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+	if( m_hMapping == NULL )
+	{
+		Close();
+		return false;
+	}
+
+	m_pData = (const char *) MapViewOfFile( m_hMapping, FILE_MAP_READ, 0, 0, 0 );
+#else
+	m_nFile = open( szFileName, O_RDONLY );
+	if( m_nFile < 0 ) return false;
+
+	struct stat tStat;
+	if( fstat( m_nFile, &tStat ) != 0 )
+	{
+		Close();
+		return false;
+	}
+
+	m_nSize = (size_t) tStat.st_size;
+	if( m_nSize == 0 ) return true;
+
+	void *pData = mmap( NULL, m_nSize, PROT_READ, MAP_PRIVATE, m_nFile, 0 );
+	if( pData != MAP_FAILED )
+	{
+		m_pData = (const char *) pData;
+		madvise( pData, m_nSize, MADV_SEQUENTIAL );
+	}
+#endif
+
+	if( m_pData == NULL )
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+
+void cMappedFile::Close()
+{
+#ifdef _WIN32
+	if( m_pData != NULL ) UnmapViewOfFile( m_pData );
+	if( m_hMapping != NULL ) CloseHandle( m_hMapping );
+	if( m_hFile != INVALID_HANDLE_VALUE ) CloseHandle( m_hFile );
+	m_hMapping = NULL;
+	m_hFile = INVALID_HANDLE_VALUE;
+#else
+	if( m_pData != NULL ) munmap( (void *) m_pData, m_nSize );
+	if( m_nFile >= 0 ) close( m_nFile );
+	m_nFile = -1;
+#endif
+
+	m_pData = NULL;
+	m_nSize = 0;
+}
+
+
+cTLEParser::cTLEParser()
+{
+	ResetCounters();
+
+	m_nYear = 0;
+	m_dfYearJD = 0.0;
+
+	m_nThreads = 1;
+	m_nChunkSize = 4 << 20;
+}
+
+
+cTLEParser::~cTLEParser()
+{
+
+}
+
+
+void cTLEParser::ResetCounters()
+{
+	m_nRecords = 0;
+	m_nChecksumErrors = 0;
+	m_nFormatErrors = 0;
+	m_nRejected = 0;
+}
+
+/******************************************************************************************
+
+  Checksum of a TLE line: the sum of the digits of columns 0-67, with 1 for each minus
+  sign, modulo 10, against the digit of column 68
+
+*******************************************************************************************/
+
+bool cTLEParser::CheckSum( const char *pLine )
+{
+	// branch free, for the compiler to vectorise
+	unsigned int nSum = 0;
+
+	for( int i = 0; i < 68; i++ )
+	{
+		unsigned char nDigit = (unsigned char) ( pLine[ i ] - '0' );
+
+		nSum += nDigit < 10 ? nDigit : ( pLine[ i ] == '-' );
+	}
+
+	return (int) ( nSum % 10 ) == pLine[ 68 ] - '0';
+}
+
+/******************************************************************************************
+
+  Integer of a fixed width field, as atoi() of the field
+
+*******************************************************************************************/
+
+int cTLEParser::DecodeInteger( const char *pField, int nWidth )
+{
+	const char *pEnd = pField + nWidth;
+
+	while( pField < pEnd && *pField == ' ' ) pField++;
+
+	bool bNegative = false;
+	if( pField < pEnd && ( *pField == '-' || *pField == '+' ) ) bNegative = *pField++ == '-';
+
+	int nValue = 0;
+	for( ; pField < pEnd; pField++ )
+	{
+		unsigned int nDigit = (unsigned int) ( *pField - '0' );
+		if( nDigit >= 10 ) break;
+		nValue = nValue * 10 + (int) nDigit;
+	}
+
+	return bNegative ? -nValue : nValue;
+}
+
+/******************************************************************************************
+
+  Decimal number of a fixed width field such as "051.6416" or "-.00001234", as atof()
+  of the field: the digits give an integer n with k decimals, and n / 10^k is correctly
+  rounded as both are exact doubles
+
+*******************************************************************************************/
+
+double cTLEParser::DecodeDecimal( const char *pField, int nWidth )
+{
+	const char *pEnd = pField + nWidth;
+
+	while( pField < pEnd && *pField == ' ' ) pField++;
+
+	bool bNegative = false;
+	if( pField < pEnd && ( *pField == '-' || *pField == '+' ) ) bNegative = *pField++ == '-';
+
+	unsigned long long nValue = 0;
+	int nDecimals = -1;
+
+	for( ; pField < pEnd; pField++ )
+	{
+		unsigned int nDigit = (unsigned int) ( *pField - '0' );
+
+		if( nDigit < 10 )
+		{
+			nValue = nValue * 10 + nDigit;
+			if( nDecimals >= 0 ) nDecimals++;
+		}
+		else if( *pField == '.' && nDecimals < 0 ) nDecimals = 0;
+		else break;
+	}
+
+	double dfValue = (double) nValue;
+	if( nDecimals > 0 ) dfValue /= s_pdfPowerOf10[ nDecimals ];
+
+	return bNegative ? -dfValue : dfValue;
+}
+
+/******************************************************************************************
+
+  Fast path of DecodeDecimal() for the fields with the decimal point at a fixed column,
+  such as the angles, the epoch day and the mean motion: blanks are allowed only before
+  the integer digits, any other layout goes to DecodeDecimal()
+
+*******************************************************************************************/
+
+double cTLEParser::DecodeFixedDecimal( const char *pField, int nIntegers, int nDecimals )
+{
+	if( pField[ nIntegers ] != '.' ) return DecodeDecimal( pField, nIntegers + 1 + nDecimals );
+
+	unsigned long long nValue = 0;
+	unsigned int nBad = 0;
+	int i = 0;
+
+	while( i < nIntegers && pField[ i ] == ' ' ) i++;
+
+	for( ; i < nIntegers; i++ )
+	{
+		unsigned int nDigit = (unsigned int) ( pField[ i ] - '0' );
+		nBad |= nDigit > 9;
+		nValue = nValue * 10 + nDigit;
+	}
+
+	for( i = nIntegers + 1; i <= nIntegers + nDecimals; i++ )
+	{
+		unsigned int nDigit = (unsigned int) ( pField[ i ] - '0' );
+		nBad |= nDigit > 9;
+		nValue = nValue * 10 + nDigit;
+	}
+
+	if( nBad ) return DecodeDecimal( pField, nIntegers + 1 + nDecimals );
+
+	return (double) nValue / s_pdfPowerOf10[ nDecimals ];
+}
+
+/******************************************************************************************
+
+  Number of the 8 column implied decimal and exponent fields, " 12345-4" for 0.12345e-4,
+  computed as cTLE2PosVel::ReadTLELine1()
+
+*******************************************************************************************/
+
+double cTLEParser::DecodeExponential( const char *pField )
+{
+	double dfMantissa = DecodeInteger( pField, 6 ) * 1.0e-5;
+	int nExponent = DecodeInteger( pField + 6, 2 );
+
+	if( nExponent >= 0 && nExponent <= 18 ) return dfMantissa * s_pdfPowerOf10[ nExponent ];
+	if( nExponent < 0 && nExponent >= -18 ) return dfMantissa * ( 1.0 / s_pdfPowerOf10[ -nExponent ] );
+
+	return dfMantissa * pow( 10.0, (double) nExponent );
+}
+
+
+const char *cTLEParser::FindLineEnd( const char *pText, const char *pEnd )
+{
+	const char *pLineEnd = (const char *) memchr( pText, '\n', pEnd - pText );
+
+	return pLineEnd != NULL ? pLineEnd : pEnd;
+}
+
+
+bool cTLEParser::IsTLELine( const char *pLine, const char *pLineEnd, char cNumber )
+{
+	return pLineEnd - pLine >= 69 && pLine[ 0 ] == cNumber && pLine[ 1 ] == ' ';
+}
+
+/******************************************************************************************
+
+  Start of the first record whose line 1 follows pText, its name line included if there
+  is one, pEnd if there is no more record
+
+*******************************************************************************************/
+
+const char *cTLEParser::FindRecordStart( const char *pBegin, const char *pText, const char *pEnd )
+{
+	const char *pLine1 = pEnd;
+
+	while( pText < pEnd )
+	{
+		const char *pLineEnd = (const char *) memchr( pText, '\n', pEnd - pText );
+		if( pLineEnd == NULL ) return pEnd;
+
+		pText = pLineEnd + 1;
+		if( pEnd - pText >= 2 && pText[ 0 ] == '1' && pText[ 1 ] == ' ' )
+		{
+			pLine1 = pText;
+			break;
+		}
+	}
+
+	if( pLine1 == pEnd ) return pEnd;
+
+	// the line before, taken as the name when it is neither blank, a comment nor line 2
+	const char *pLineEnd = pLine1 - 1;
+	const char *pLine = pLineEnd;
+	while( pLine > pBegin && pLine[ -1 ] != '\n' ) pLine--;
+	if( pLineEnd > pLine && pLineEnd[ -1 ] == '\r' ) pLineEnd--;
+
+	if( pLineEnd == pLine || pLine[ 0 ] == '#' || IsTLELine( pLine, pLineEnd, '2' ) ) return pLine1;
+
+	return pLine;
+}
+
+
+// start of the last record which begins in the text, pBegin if there is none
+const char *cTLEParser::FindLastRecordStart( const char *pBegin, const char *pEnd )
+{
+	if( pEnd - pBegin < 3 ) return pBegin;
+
+	for( const char *p = pEnd - 3; p >= pBegin; p-- )
+	{
+		if( p[ 0 ] == '\n' && p[ 1 ] == '1' && p[ 2 ] == ' ' ) return FindRecordStart( pBegin, p, pEnd );
+	}
+
+	return pBegin;
+}
+
+/******************************************************************************************
+
+  Walk to the next record of the text, in place
+
+  A line which is neither a comment nor line 1 is taken as the name of the satellite
+  when line 1 follows it, as in the three line format. Lines out of this pattern are
+  skipped and counted as format errors, records whose lines fail the checksum or have
+  different NORAD IDs as checksum errors.
+
+*******************************************************************************************/
+
+const char *cTLEParser::NextRecord( const char *pText, const char *pEnd, stTLERecord &tRecord )
+{
+	while( pText < pEnd )
+	{
+		const char *pLineEnd = FindLineEnd( pText, pEnd );
+		const char *pNext = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+		if( pLineEnd > pText && pLineEnd[ -1 ] == '\r' ) pLineEnd--;
+
+		if( pLineEnd == pText || pText[ 0 ] == '#' )
+		{
+			pText = pNext;
+			continue;
+		}
+
+		tRecord.pName = NULL;
+		tRecord.nNameLength = 0;
+
+		if( !IsTLELine( pText, pLineEnd, '1' ) )
+		{
+			tRecord.pName = pText;
+			while( pLineEnd > pText && pLineEnd[ -1 ] == ' ' ) pLineEnd--;
+			tRecord.nNameLength = (int) ( pLineEnd - pText );
+
+			pText = pNext;
+			if( pText >= pEnd ) break;
+
+			pLineEnd = FindLineEnd( pText, pEnd );
+			pNext = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+			if( pLineEnd > pText && pLineEnd[ -1 ] == '\r' ) pLineEnd--;
+
+			if( !IsTLELine( pText, pLineEnd, '1' ) )
+			{
+				// the name line was not followed by line 1, start again from this line
+				m_nFormatErrors++;
+				continue;
+			}
+		}
+
+		tRecord.pLine1 = pText;
+		pText = pNext;
+		if( pText >= pEnd )
+		{
+			m_nFormatErrors++;
+			break;
+		}
+
+		pLineEnd = FindLineEnd( pText, pEnd );
+		pNext = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+		if( pLineEnd > pText && pLineEnd[ -1 ] == '\r' ) pLineEnd--;
+
+		if( !IsTLELine( pText, pLineEnd, '2' ) )
+		{
+			m_nFormatErrors++;
+			continue;
+		}
+
+		tRecord.pLine2 = pText;
+		pText = pNext;
+
+		if( !CheckSum( tRecord.pLine1 ) || !CheckSum( tRecord.pLine2 ) ||
+			memcmp( tRecord.pLine1 + 2, tRecord.pLine2 + 2, 5 ) != 0 )
+		{
+			m_nChecksumErrors++;
+			continue;
+		}
+
+		return pText;
+	}
+
+	return NULL;
+}
+
+/******************************************************************************************
+
+  Numeric fields of the record, as cTLE2PosVel::ReadTLELine1() and ReadTLELine2()
+
+*******************************************************************************************/
+
+bool cTLEParser::DecodeRecord( const stTLERecord &tRecord, stSatelliteElements &stIOE )
+{
+	const char *pLine1 = tRecord.pLine1, *pLine2 = tRecord.pLine2;
+
+	memset( stIOE.pfElement7to18, 0, sizeof( stIOE.pfElement7to18 ) );
+
+	stIOE.nSatelliteID = cSatelliteRegistry::DecodeCatalogNumber( pLine1 + 2 );
+	stIOE.nSIC = 0;
+
+	// ref date/time, JD of day 0 of the year kept for the next records
+	int nYear = DecodeInteger( pLine1 + 18, 2 );
+	if( nYear < 90 ) nYear += 2000;
+	else nYear += 1900;
+
+	if( nYear != m_nYear )
+	{
+		g_DateTimeZ.DateTime2JD( nYear, 1, 0, 0, 0, 0.0, m_dfYearJD );
+		m_nYear = nYear;
+	}
+
+	stIOE.SetRefJD( m_dfYearJD + DecodeFixedDecimal( pLine1 + 20, 3, 8 ) );
+
+	// n dot, n dot dot and BSTAR
+	stIOE.pfElement7to18[ 0 ] = (float) DecodeDecimal( pLine1 + 33, 10 );
+	stIOE.pfElement7to18[ 1 ] = (float) DecodeExponential( pLine1 + 44 );
+	stIOE.pfElement7to18[ 2 ] = (float) DecodeExponential( pLine1 + 53 );
+
+	stIOE.pnElement1to6[ 2 ] = (int)( DecodeFixedDecimal( pLine2 + 8, 3, 4 ) * 1.0e5 );
+	stIOE.pnElement1to6[ 3 ] = (int)( DecodeFixedDecimal( pLine2 + 17, 3, 4 ) * 1.0e5 );
+	stIOE.pnElement1to6[ 1 ] = DecodeInteger( pLine2 + 26, 7 );
+	stIOE.pnElement1to6[ 4 ] = (int)( DecodeFixedDecimal( pLine2 + 34, 3, 4 ) * 1.0e5 );
+	stIOE.pnElement1to6[ 5 ] = (int)( DecodeFixedDecimal( pLine2 + 43, 3, 4 ) * 1.0e5 );
+	stIOE.pnElement1to6[ 0 ] = (int)( DecodeFixedDecimal( pLine2 + 52, 2, 8 ) * 1.0e8 );
+
+	// orbital period in days
+	stIOE.pfElement7to18[ 11 ] = (float) ( 1.0 / ( stIOE.pnElement1to6[ 0 ] * 1.0e-8 ) );
+
+	stIOE.cElementType = 'T';
+
+	m_nRecords++;
+
+	return stIOE.nSatelliteID > 0 && stIOE.pnElement1to6[ 0 ] > 0;
+}
+
+
+bool cTLEParser::DecodeRecord( const stTLERecord &tRecord, stSatelliteIOE &stIOE )
+{
+	stSatelliteElements tElements;
+	bool bOK = DecodeRecord( tRecord, tElements );
+
+	stIOE.SetElements( tElements );
+
+	return bOK;
+}
+
+
+void cTLEParser::GetAttributes( const stTLERecord &tRecord, stSatelliteAttributes &tAttributes )
+{
+	tAttributes.Line1 = tRecord.pName != NULL ? std::string( tRecord.pName, tRecord.nNameLength ) : std::string();
+	tAttributes.Line2 = std::string( tRecord.pLine1, 69 );
+	tAttributes.Line3 = std::string( tRecord.pLine2, 69 );
+}
+
+/******************************************************************************************
+
+  Decode all the records of the text, return the number of records appended
+
+*******************************************************************************************/
+
+int cTLEParser::Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteElements> &TLEData,
+					   bool bPerigeeTest, double perigeeLimit, double apogeeLimit )
+{
+	cTLEFilter tFilter;
+	if( bPerigeeTest ) tFilter.SetPerigeeApogee( perigeeLimit, apogeeLimit );
+
+	return ParseText( pBegin, pEnd, TLEData, bPerigeeTest ? &tFilter : NULL );
+}
+
+
+int cTLEParser::Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteIOE> &TLEData,
+					   bool bPerigeeTest, double perigeeLimit, double apogeeLimit )
+{
+	cTLEFilter tFilter;
+	if( bPerigeeTest ) tFilter.SetPerigeeApogee( perigeeLimit, apogeeLimit );
+
+	return ParseText( pBegin, pEnd, TLEData, bPerigeeTest ? &tFilter : NULL );
+}
+
+
+int cTLEParser::Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteElements> &TLEData,
+					   const cTLEFilter &tFilter )
+{
+	return ParseText( pBegin, pEnd, TLEData, &tFilter );
+}
+
+
+int cTLEParser::Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteIOE> &TLEData,
+					   const cTLEFilter &tFilter )
+{
+	return ParseText( pBegin, pEnd, TLEData, &tFilter );
+}
+
+int cTLEParser::Parse( cTLEStream &tStream, std::vector<stSatelliteElements> &TLEData, const cTLEFilter *pFilter )
+{
+	return ParseStream( tStream, TLEData, pFilter );
+}
+
+
+int cTLEParser::Parse( cTLEStream &tStream, std::vector<stSatelliteIOE> &TLEData, const cTLEFilter *pFilter )
+{
+	return ParseStream( tStream, TLEData, pFilter );
+}
+
+/******************************************************************************************
+
+  The blocks of the stream are appended to the text not parsed yet, which is parsed up to
+  the start of its last record, the record possibly cut by the end of the block being
+  kept for the next one. With several threads the text is let grow to a chunk per thread
+  before it is parsed.
+
+*******************************************************************************************/
+
+template< class T >
+int cTLEParser::ParseStream( cTLEStream &tStream, std::vector<T> &TLEData, const cTLEFilter *pFilter )
+{
+	int nThreads = m_nThreads;
+	if( nThreads <= 0 ) nThreads = (int) std::thread::hardware_concurrency();
+
+	size_t nBatch = nThreads > 1 ? m_nChunkSize * nThreads : 0;
+	size_t nSize = TLEData.size();
+
+	std::vector<char> vText, vBlock;
+
+	while( tStream.Read( vBlock ) )
+	{
+		vText.insert( vText.end(), vBlock.begin(), vBlock.end() );
+		if( vText.size() < nBatch ) continue;
+
+		const char *pBegin = &vText[ 0 ], *pEnd = pBegin + vText.size();
+		const char *pCut = FindLastRecordStart( pBegin, pEnd );
+		if( pCut == pBegin ) continue;
+
+		ParseText( pBegin, pCut, TLEData, pFilter );
+		vText.erase( vText.begin(), vText.begin() + ( pCut - pBegin ) );
+	}
+
+	if( !vText.empty() ) ParseText( &vText[ 0 ], &vText[ 0 ] + vText.size(), TLEData, pFilter );
+
+	return (int) ( TLEData.size() - nSize );
+}
+
+/******************************************************************************************
+
+  The filter is tested on the text of the record, only the records it accepts are decoded
+  and appended
+
+*******************************************************************************************/
+
+template< class T >
+int cTLEParser::ParseText( const char *pBegin, const char *pEnd, std::vector<T> &TLEData,
+						   const cTLEFilter *pFilter )
+{
+	int nThreads = m_nThreads;
+	if( nThreads <= 0 ) nThreads = (int) std::thread::hardware_concurrency();
+
+	if( nThreads > 1 && m_nChunkSize > 0 && (size_t) ( pEnd - pBegin ) > m_nChunkSize )
+	{
+		return ParseChunks( pBegin, pEnd, nThreads, TLEData, pFilter );
+	}
+
+	size_t nSize = TLEData.size();
+
+	stTLERecord tRecord;
+	stSatelliteElements tElements;
+	const char *pText = pBegin;
+
+	while( ( pText = NextRecord( pText, pEnd, tRecord ) ) != NULL )
+	{
+		if( pFilter != NULL && !pFilter->Accept( tRecord ) )
+		{
+			m_nRejected++;
+			continue;
+		}
+
+		if( !DecodeRecord( tRecord, tElements ) )
+		{
+			m_nFormatErrors++;
+			continue;
+		}
+
+		TLEData.emplace_back( tElements );
+	}
+
+	return (int) ( TLEData.size() - nSize );
+}
+
+/******************************************************************************************
+
+  Parse() on threads: the text is split into chunks of about m_nChunkSize bytes at the
+  start of a record, the threads take the chunks in turn, each with its own parser and
+  output, and the outputs are moved to TLEData in the order of the chunks
+
+*******************************************************************************************/
+
+template< class T >
+int cTLEParser::ParseChunks( const char *pBegin, const char *pEnd, int nThreads, std::vector<T> &TLEData,
+							 const cTLEFilter *pFilter )
+{
+	std::vector<const char *> vpChunks;
+	vpChunks.push_back( pBegin );
+
+	while( vpChunks.back() < pEnd )
+	{
+		const char *pText = vpChunks.back();
+		if( (size_t) ( pEnd - pText ) <= m_nChunkSize ) vpChunks.push_back( pEnd );
+		else vpChunks.push_back( FindRecordStart( pText, pText + m_nChunkSize, pEnd ) );
+	}
+
+	int nChunks = (int) vpChunks.size() - 1;
+	if( nThreads > nChunks ) nThreads = nChunks;
+
+	std::vector<cTLEParser> vtParsers( nChunks );
+	std::vector< std::vector<T> > vtOutputs( nChunks );
+	std::atomic<int> nNextChunk( 0 );
+
+	auto Work = [&]()
+	{
+		int k;
+		while( ( k = nNextChunk++ ) < nChunks )
+		{
+			if( pFilter == NULL ) vtOutputs[ k ].reserve( ( vpChunks[ k + 1 ] - vpChunks[ k ] ) / 140 + 1 );
+			vtParsers[ k ].ParseText( vpChunks[ k ], vpChunks[ k + 1 ], vtOutputs[ k ], pFilter );
+		}
+	};
+
+	std::vector<std::thread> vtThreads;
+	for( int i = 1; i < nThreads; i++ ) vtThreads.emplace_back( Work );
+	Work();
+	for( size_t i = 0; i < vtThreads.size(); i++ ) vtThreads[ i ].join();
+
+	size_t nSize = TLEData.size(), nTotal = nSize;
+	for( int k = 0; k < nChunks; k++ ) nTotal += vtOutputs[ k ].size();
+	TLEData.reserve( nTotal );
+
+	for( int k = 0; k < nChunks; k++ )
+	{
+		TLEData.insert( TLEData.end(), std::make_move_iterator( vtOutputs[ k ].begin() ),
+						std::make_move_iterator( vtOutputs[ k ].end() ) );
+
+		m_nRecords += vtParsers[ k ].m_nRecords;
+		m_nChecksumErrors += vtParsers[ k ].m_nChecksumErrors;
+		m_nFormatErrors += vtParsers[ k ].m_nFormatErrors;
+		m_nRejected += vtParsers[ k ].m_nRejected;
+	}
+
+	return (int) ( TLEData.size() - nSize );
+}
+
+/******************************************************************************************
+
+  Same as cTLE2PosVel::ReadAllTLE(), without Line1-3 of the records, "-", *.gz, *.zst and
+  named pipes read as streams
+
+*******************************************************************************************/
+
+bool cTLEParser::ReadAllTLE( std::vector<stSatelliteElements> &TLEData, const char *szFileName, bool bPerigeeTest,
+							 double perigeeLimit, double apogeeLimit )
+{
+	cTLEFilter tFilter;
+	if( bPerigeeTest ) tFilter.SetPerigeeApogee( perigeeLimit, apogeeLimit );
+
+	return ReadFile( TLEData, szFileName, bPerigeeTest ? &tFilter : NULL );
+}
+
+
+bool cTLEParser::ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *szFileName, bool bPerigeeTest,
+							 double perigeeLimit, double apogeeLimit )
+{
+	cTLEFilter tFilter;
+	if( bPerigeeTest ) tFilter.SetPerigeeApogee( perigeeLimit, apogeeLimit );
+
+	return ReadFile( TLEData, szFileName, bPerigeeTest ? &tFilter : NULL );
+}
+
+
+bool cTLEParser::ReadAllTLE( std::vector<stSatelliteElements> &TLEData, const char *szFileName,
+							 const cTLEFilter &tFilter )
+{
+	return ReadFile( TLEData, szFileName, &tFilter );
+}
+
+
+bool cTLEParser::ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *szFileName,
+							 const cTLEFilter &tFilter )
+{
+	return ReadFile( TLEData, szFileName, &tFilter );
+}
+
+
+template< class T >
+bool cTLEParser::ReadFile( std::vector<T> &TLEData, const char *szFileName, const cTLEFilter *pFilter )
+{
+	if( cTLEStream::IsStreamName( szFileName ) )
+	{
+		cTLEStream tStream;
+		if( !tStream.Open( szFileName ) ) return false;
+
+		ParseStream( tStream, TLEData, pFilter );
+
+		return tStream.Close();
+	}
+
+	cMappedFile tFile;
+	if( !tFile.Open( szFileName ) ) return false;
+
+	// a record takes at least 140 characters, the threads reserve their own outputs
+	if( pFilter == NULL && ( m_nThreads == 1 || tFile.GetSize() <= m_nChunkSize ) )
+	{
+		TLEData.reserve( TLEData.size() + tFile.GetSize() / 140 + 1 );
+	}
+
+	ParseText( tFile.GetData(), tFile.GetData() + tFile.GetSize(), TLEData, pFilter );
+
+	return true;
+}
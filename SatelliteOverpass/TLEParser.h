@@ -0,0 +1,179 @@
+/***************************************************************************
+
+ Memory mapped TLE catalog parser
+
+ The catalog file is mapped into memory and the two line element sets are
+ decoded in place: a record is a view of its name, line 1 and line 2 in the
+ mapped text, and the fixed column fields are decoded by hand from the
+ digits, without std::string, atof or atoi. The checksum of each line is
+ verified as the line is walked, a record failing it is skipped and counted.
+
+ The decoded values are the same as those of cTLE2PosVel::ReadAllTLE(): an
+ integer field n with k decimals gives the double n / 10^k, which is the
+ correctly rounded value atof returns for the same text.
+
+ A large text can be parsed on several threads: it is cut into chunks at
+ the start of a record (a line beginning with "1 ", with the name line
+ before it if any), each thread parses whole chunks and the records are
+ gathered in the order of the text.
+
+ ReadAllTLE() reads "-" (the standard input), *.gz, *.zst and named pipes
+ through a cTLEStream instead of a memory map: the text is parsed block by
+ block, up to the start of the last record of the blocks read, while the
+ next blocks are being decompressed.
+
+ Line 1                                                  Line 2
+ col  2- 6 NORAD ID, Alpha-5 allowed                    col  8-15 inclination, deg
+     18-19 epoch year                                        17-24 RAAN, deg
+     20-31 epoch day of year                                 26-32 eccentricity, implied decimal
+     33-42 first derivative of the mean motion               34-41 argument of perigee, deg
+     44-51 second derivative, implied decimal and exponent   43-50 mean anomaly, deg
+     53-60 BSTAR, implied decimal and exponent               52-62 mean motion, rev/day
+        68 checksum                                             68 checksum
+
+***************************************************************************/
+#pragma once
+
+#include <windows.h>
+#include "DataStructure.h"
+
+#include <vector>
+#include <stddef.h>
+
+class cTLEFilter;
+class cTLEStream;
+
+/***************************************************************************
+
+ A TLE record in the text it is parsed from, name NULL for two line sets
+
+***************************************************************************/
+
+struct stTLERecord
+{
+	const char *pName;
+	int nNameLength;
+	const char *pLine1;
+	const char *pLine2;
+};
+
+/***************************************************************************
+
+ Read only memory map of a whole file
+
+***************************************************************************/
+
+class cMappedFile
+{
+	const char *m_pData;
+	size_t m_nSize;
+
+#ifdef _WIN32
+	HANDLE m_hFile, m_hMapping;
+#else
+	int m_nFile;
+#endif
+
+public:
+
+	cMappedFile();
+	~cMappedFile();
+
+	bool Open( const char *szFileName );
+	void Close();
+
+	const char *GetData() const { return m_pData; }
+	size_t GetSize() const { return m_nSize; }
+};
+
+
+class cTLEParser
+{
+	int m_nRecords;				// records decoded
+	int m_nChecksumErrors;		// records skipped for a checksum error
+	int m_nFormatErrors;		// lines skipped for not being a TLE line
+	int m_nRejected;			// records rejected by the filter
+
+	int m_nYear;				// last epoch year, and its JD of day 0
+	double m_dfYearJD;
+
+	int m_nThreads;				// threads of Parse(), 0 for one per core
+	size_t m_nChunkSize;		// bytes of text per task of the threads
+
+public:
+
+	cTLEParser();
+	~cTLEParser();
+
+	// next record from pText, comment lines (#) and blank lines skipped, return the
+	// start of the text after the record, or NULL if there is no more record
+	const char *NextRecord( const char *pText, const char *pEnd, stTLERecord &tRecord );
+
+	// numeric fields of stIOE from the record, Line1-3 are not set
+	bool DecodeRecord( const stTLERecord &tRecord, stSatelliteElements &stIOE );
+	bool DecodeRecord( const stTLERecord &tRecord, stSatelliteIOE &stIOE );
+
+	// name, line 1 and line 2 of the record as Line1-3 of the side table
+	static void GetAttributes( const stTLERecord &tRecord, stSatelliteAttributes &tAttributes );
+
+	// all the records of the text, appended to TLEData, with the perigee and apogee test
+	// of cTLE2PosVel::ReadAllTLE()
+	int Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteElements> &TLEData,
+			   bool bPerigeeTest = false, double perigeeLimit = 6378137.0 + 250000.0,
+			   double apogeeLimit = 6378137.0 + 5000000.0 );
+	int Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteIOE> &TLEData,
+			   bool bPerigeeTest = false, double perigeeLimit = 6378137.0 + 250000.0,
+			   double apogeeLimit = 6378137.0 + 5000000.0 );
+
+	bool ReadAllTLE( std::vector<stSatelliteElements> &TLEData, const char *szFileName, bool bPerigeeTest = false,
+		             double perigeeLimit = 6378137.0 + 250000.0, double apogeeLimit = 6378137.0 + 5000000.0 );
+	bool ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *szFileName, bool bPerigeeTest = false,
+		             double perigeeLimit = 6378137.0 + 250000.0, double apogeeLimit = 6378137.0 + 5000000.0 );
+
+	// only the records accepted by the filter, which is tested before they are decoded
+	int Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteElements> &TLEData,
+			   const cTLEFilter &tFilter );
+	int Parse( const char *pBegin, const char *pEnd, std::vector<stSatelliteIOE> &TLEData,
+			   const cTLEFilter &tFilter );
+	bool ReadAllTLE( std::vector<stSatelliteElements> &TLEData, const char *szFileName, const cTLEFilter &tFilter );
+	bool ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *szFileName, const cTLEFilter &tFilter );
+
+	// records of a stream opened by the caller, parsed as its blocks arrive
+	int Parse( cTLEStream &tStream, std::vector<stSatelliteElements> &TLEData, const cTLEFilter *pFilter = NULL );
+	int Parse( cTLEStream &tStream, std::vector<stSatelliteIOE> &TLEData, const cTLEFilter *pFilter = NULL );
+
+	// the text is split at record boundaries into chunks parsed on nThreads threads, the
+	// records are appended in the order of the text
+	void SetThreadNumber( int nThreads ) { m_nThreads = nThreads; }
+	void SetChunkSize( size_t nChunkSize ) { m_nChunkSize = nChunkSize; }
+
+	int GetRecordNumber() const { return m_nRecords; }
+	int GetChecksumErrors() const { return m_nChecksumErrors; }
+	int GetFormatErrors() const { return m_nFormatErrors; }
+	int GetRejectedNumber() const { return m_nRejected; }
+	void ResetCounters();
+
+	// fixed width field decoders, leading and trailing blanks allowed
+	static bool CheckSum( const char *pLine );
+	static int DecodeInteger( const char *pField, int nWidth );
+	static double DecodeDecimal( const char *pField, int nWidth );
+	static double DecodeExponential( const char *pField );
+	static double DecodeFixedDecimal( const char *pField, int nIntegers, int nDecimals );
+
+private:
+
+	template< class T >
+	bool ReadFile( std::vector<T> &TLEData, const char *szFileName, const cTLEFilter *pFilter );
+	template< class T >
+	int ParseStream( cTLEStream &tStream, std::vector<T> &TLEData, const cTLEFilter *pFilter );
+	template< class T >
+	int ParseText( const char *pBegin, const char *pEnd, std::vector<T> &TLEData, const cTLEFilter *pFilter );
+	template< class T >
+	int ParseChunks( const char *pBegin, const char *pEnd, int nThreads, std::vector<T> &TLEData,
+					 const cTLEFilter *pFilter );
+
+	static const char *FindRecordStart( const char *pBegin, const char *pText, const char *pEnd );
+	static const char *FindLastRecordStart( const char *pBegin, const char *pEnd );
+	static const char *FindLineEnd( const char *pText, const char *pEnd );
+	static bool IsTLELine( const char *pLine, const char *pLineEnd, char cNumber );
+};
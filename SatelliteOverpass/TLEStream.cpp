@@ -0,0 +1,319 @@
+/***************************************************************************
+
+ Streaming input of compressed catalogs, pipes and the standard input
+
+***************************************************************************/
+#undef UNICODE
+
+#include <string.h>
+#include <sys/stat.h>
+#include <string>
+#include "TLEStream.h"
+
+#ifdef TLE_STREAM_ZLIB
+#include <zlib.h>
+#endif
+
+// exit status of a command the shell did not find: cmd.exe 9009, sh 127
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#define TLE_STREAM_PIPE_MODE "rb"
+#define TLE_STREAM_NOT_FOUND( nStatus ) ( ( nStatus ) == 9009 )
+#else
+#include <sys/wait.h>
+#define TLE_STREAM_PIPE_MODE "r"
+#define TLE_STREAM_NOT_FOUND( nStatus ) ( WIFEXITED( nStatus ) && WEXITSTATUS( nStatus ) == 127 )
+#endif
+
+enum eTLEStreamSource
+{
+	TLE_STREAM_FILE = 0,
+	TLE_STREAM_STDIN = 1,
+	TLE_STREAM_PIPE = 2,
+	TLE_STREAM_GZIP = 3			// zlib in the producer thread
+};
+
+/******************************************************************************************
+
+  Command which writes the decompressed file to its standard output, the name quoted for
+  the shell
+
+*******************************************************************************************/
+
+static std::string DecompressCommand( const char *szProgram, const char *szFileName )
+{
+	std::string sCommand( szProgram );
+
+#ifdef _WIN32
+	sCommand += " -dc \"";
+	sCommand += szFileName;
+	sCommand += "\"";
+#else
+	sCommand += " -dc -- '";
+	for( const char *p = szFileName; *p != '\0'; p++ )
+	{
+		if( *p == '\'' ) sCommand += "'\\''";
+		else sCommand += *p;
+	}
+	sCommand += "'";
+#endif
+
+	return sCommand;
+}
+
+
+static bool HasExtension( const char *szFileName, const char *szExtension )
+{
+	size_t nName = strlen( szFileName ), nExtension = strlen( szExtension );
+
+	return nName > nExtension && strcmp( szFileName + nName - nExtension, szExtension ) == 0;
+}
+
+
+cTLEStream::cTLEStream()
+{
+	m_pFile = NULL;
+	m_pGzFile = NULL;
+	m_nSource = TLE_STREAM_FILE;
+
+	m_nBlockSize = 1 << 20;
+	m_nBlocks = 4;
+
+	m_bEnd = true;
+	m_bStop = false;
+
+	m_nBytes = 0;
+	m_nError = TLE_STREAM_ERROR_NONE;
+}
+
+
+cTLEStream::~cTLEStream()
+{
+	Close();
+}
+
+
+bool cTLEStream::IsStreamName( const char *szFileName )
+{
+	if( strcmp( szFileName, "-" ) == 0 || HasExtension( szFileName, ".gz" ) ||
+		HasExtension( szFileName, ".zst" ) ) return true;
+
+	// a named pipe or a device cannot be mapped, a missing file is left to the caller
+	struct stat tStat;
+
+	return stat( szFileName, &tStat ) == 0 && ( tStat.st_mode & S_IFMT ) != S_IFREG;
+}
+
+
+bool cTLEStream::Open( const char *szFileName )
+{
+	Close();
+
+	if( strcmp( szFileName, "-" ) == 0 )
+	{
+		m_pFile = stdin;
+		m_nSource = TLE_STREAM_STDIN;
+	}
+	else
+	{
+		// a missing file fails here rather than in the decompressor
+		m_pFile = fopen( szFileName, "rb" );
+		if( m_pFile == NULL ) return false;
+
+		const char *szProgram = HasExtension( szFileName, ".gz" ) ? "gzip" :
+								HasExtension( szFileName, ".zst" ) ? "zstd" : NULL;
+		m_nSource = TLE_STREAM_FILE;
+
+#ifdef TLE_STREAM_ZLIB
+		if( HasExtension( szFileName, ".gz" ) )
+		{
+			fclose( m_pFile );
+			m_pFile = NULL;
+
+			m_pGzFile = gzopen( szFileName, "rb" );
+			if( m_pGzFile == NULL ) return false;
+
+			gzbuffer( (gzFile) m_pGzFile, 1 << 16 );
+			m_nSource = TLE_STREAM_GZIP;
+			szProgram = NULL;
+		}
+#endif
+
+		if( szProgram != NULL )
+		{
+			fclose( m_pFile );
+
+			m_pFile = popen( DecompressCommand( szProgram, szFileName ).c_str(), TLE_STREAM_PIPE_MODE );
+			if( m_pFile == NULL ) return false;
+
+			m_nSource = TLE_STREAM_PIPE;
+		}
+	}
+
+	if( m_nBlockSize == 0 ) m_nBlockSize = 1 << 20;
+	if( m_nBlocks < 1 ) m_nBlocks = 1;
+
+	m_bEnd = false;
+	m_bStop = false;
+	m_nBytes = 0;
+	m_nError = TLE_STREAM_ERROR_NONE;
+
+	setg( NULL, NULL, NULL );
+
+	m_tProducer = std::thread( &cTLEStream::Produce, this );
+
+	return true;
+}
+
+
+bool cTLEStream::Close()
+{
+	if( !IsOpen() ) return m_nError == TLE_STREAM_ERROR_NONE;
+
+	{
+		std::lock_guard<std::mutex> tLock( m_tMutex );
+		m_bStop = true;
+	}
+	m_tEmptied.notify_all();
+
+	if( m_tProducer.joinable() ) m_tProducer.join();
+
+	// a decompressor stopped before its end fails with a broken pipe, not an error
+	bool bComplete = m_bEnd && m_vtFull.empty();
+
+	if( m_nSource == TLE_STREAM_PIPE )
+	{
+		int nStatus = pclose( m_pFile );
+
+		if( TLE_STREAM_NOT_FOUND( nStatus ) ) m_nError = TLE_STREAM_ERROR_NO_DECOMPRESSOR;
+		else if( nStatus != 0 && bComplete && m_nError == TLE_STREAM_ERROR_NONE )
+			m_nError = TLE_STREAM_ERROR_DECOMPRESSOR;
+	}
+#ifdef TLE_STREAM_ZLIB
+	else if( m_nSource == TLE_STREAM_GZIP )
+	{
+		// Z_BUF_ERROR if the file ended in the middle of the gzip stream
+		if( gzclose( (gzFile) m_pGzFile ) != Z_OK && bComplete && m_nError == TLE_STREAM_ERROR_NONE )
+			m_nError = TLE_STREAM_ERROR_DECOMPRESSOR;
+	}
+#endif
+	else if( m_nSource == TLE_STREAM_FILE ) fclose( m_pFile );
+
+	m_pFile = NULL;
+	m_pGzFile = NULL;
+	m_bEnd = true;
+
+	m_vtFull.clear();
+	m_vtFree.clear();
+	m_vBuffer.clear();
+	setg( NULL, NULL, NULL );
+
+	return m_nError == TLE_STREAM_ERROR_NONE;
+}
+
+/******************************************************************************************
+
+  Producer thread: read blocks while fewer than m_nBlocks are waiting, in the storage of
+  the blocks given back when there is one
+
+*******************************************************************************************/
+
+void cTLEStream::Produce()
+{
+	for( ;; )
+	{
+		std::vector<char> vBlock;
+
+		{
+			std::unique_lock<std::mutex> tLock( m_tMutex );
+			m_tEmptied.wait( tLock, [this]() { return m_bStop || (int) m_vtFull.size() < m_nBlocks; } );
+
+			if( m_bStop ) break;
+
+			if( !m_vtFree.empty() )
+			{
+				vBlock.swap( m_vtFree.back() );
+				m_vtFree.pop_back();
+			}
+		}
+
+		bool bError = false;
+
+		vBlock.resize( m_nBlockSize );
+		size_t nRead = ReadInput( &vBlock[ 0 ], m_nBlockSize, bError );
+		vBlock.resize( nRead );
+
+		bool bEnd = nRead < m_nBlockSize;
+
+		{
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			if( nRead > 0 ) m_vtFull.push_back( std::move( vBlock ) );
+			if( bEnd )
+			{
+				if( bError ) 
+					m_nError = m_nSource == TLE_STREAM_GZIP ? TLE_STREAM_ERROR_DECOMPRESSOR : TLE_STREAM_ERROR_READ;
+				m_bEnd = true;
+			}
+		}
+		m_tFilled.notify_one();
+
+		if( bEnd ) break;
+	}
+}
+
+
+size_t cTLEStream::ReadInput( char *pBuffer, size_t nSize, bool &bError )
+{
+#ifdef TLE_STREAM_ZLIB
+	if( m_nSource == TLE_STREAM_GZIP )
+	{
+		int nRead = gzread( (gzFile) m_pGzFile, pBuffer, (unsigned) nSize );
+
+		bError = nRead < 0;
+
+		return nRead < 0 ? 0 : (size_t) nRead;
+	}
+#endif
+
+	size_t nRead = fread( pBuffer, 1, nSize, m_pFile );
+
+	bError = nRead < nSize && ferror( m_pFile ) != 0;
+
+	return nRead;
+}
+
+
+bool cTLEStream::Read( std::vector<char> &vBlock )
+{
+	std::unique_lock<std::mutex> tLock( m_tMutex );
+	m_tFilled.wait( tLock, [this]() { return m_bEnd || !m_vtFull.empty(); } );
+
+	if( m_vtFull.empty() ) return false;
+
+	if( vBlock.capacity() > 0 && (int) m_vtFree.size() < m_nBlocks ) m_vtFree.push_back( std::move( vBlock ) );
+
+	vBlock = std::move( m_vtFull.front() );
+	m_vtFull.pop_front();
+
+	tLock.unlock();
+	m_tEmptied.notify_one();
+
+	m_nBytes += vBlock.size();
+
+	return true;
+}
+
+
+cTLEStream::int_type cTLEStream::underflow()
+{
+	if( gptr() < egptr() ) return traits_type::to_int_type( *gptr() );
+
+	if( !IsOpen() || !Read( m_vBuffer ) ) return traits_type::eof();
+
+	char *pBuffer = &m_vBuffer[ 0 ];
+	setg( pBuffer, pBuffer, pBuffer + m_vBuffer.size() );
+
+	return traits_type::to_int_type( *pBuffer );
+}
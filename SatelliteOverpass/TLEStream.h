@@ -0,0 +1,109 @@
+/***************************************************************************
+
+ Streaming input of compressed catalogs, pipes and the standard input
+
+ The input is read by a producer thread in blocks of a fixed size, up to a
+ few blocks ahead of the reader, so that the decompression overlaps the
+ parsing and no uncompressed copy of the file is ever written. The blocks
+ are recycled between the two threads.
+
+ Input                 read through
+ "-"                   the standard input
+ name ending .gz       zlib in the producer thread when built with
+                       TLE_STREAM_ZLIB, gzip -dc otherwise
+ name ending .zst      zstd -dc
+ any other name        the file itself, which may be a named pipe
+
+ gzip and zstd are external programs started through popen() and must be
+ on the PATH; they usually are not on Windows, where .gz catalogs need a
+ build with TLE_STREAM_ZLIB defined and zlib linked. A missing program is
+ reported by Close() as TLE_STREAM_ERROR_NO_DECOMPRESSOR, a damaged or
+ truncated file as TLE_STREAM_ERROR_DECOMPRESSOR.
+
+ The stream is also a std::streambuf, so that a std::istream can be read
+ from it line by line as from an ifstream.
+
+***************************************************************************/
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+// errors of cTLEStream::GetError()
+enum eTLEStreamError
+{
+	TLE_STREAM_ERROR_NONE = 0,
+	TLE_STREAM_ERROR_READ = 1,				// the input could not be read
+	TLE_STREAM_ERROR_DECOMPRESSOR = 2,		// the decompressor failed, damaged or truncated file
+	TLE_STREAM_ERROR_NO_DECOMPRESSOR = 3	// gzip or zstd not found
+};
+
+class cTLEStream : public std::streambuf
+{
+	FILE *m_pFile;
+	void *m_pGzFile;			// gzFile of a .gz input read with zlib, NULL otherwise
+	int m_nSource;				// eTLEStreamSource of the open input
+
+	size_t m_nBlockSize;		// bytes per block
+	int m_nBlocks;				// blocks read ahead
+
+	std::thread m_tProducer;
+	std::mutex m_tMutex;
+	std::condition_variable m_tFilled, m_tEmptied;
+
+	std::deque< std::vector<char> > m_vtFull;		// blocks read, in order
+	std::vector< std::vector<char> > m_vtFree;		// blocks given back by the reader
+	bool m_bEnd;				// no more block will be read
+	bool m_bStop;				// the producer is asked to stop
+
+	std::vector<char> m_vBuffer;	// block under the streambuf
+	unsigned long long m_nBytes;	// bytes read so far
+	int m_nError;				// eTLEStreamError
+
+public:
+
+	cTLEStream();
+	~cTLEStream();
+
+	// start reading the input in the background, false if it cannot be opened
+	bool Open( const char *szFileName );
+
+	// stop the producer and close the input, false if a read failed or the decompressor
+	// reported an error, see GetError()
+	bool Close();
+
+	bool IsOpen() const { return m_pFile != NULL || m_pGzFile != NULL; }
+
+	// next block in vBlock, whose storage goes back to the producer, false at the end of
+	// the input
+	bool Read( std::vector<char> &vBlock );
+
+	// before Open(), 1 MB blocks and 4 blocks ahead by default
+	void SetBlockSize( size_t nBlockSize ) { m_nBlockSize = nBlockSize; }
+	void SetBlockNumber( int nBlocks ) { m_nBlocks = nBlocks; }
+
+	unsigned long long GetByteNumber() const { return m_nBytes; }
+	int GetError() const { return m_nError; }
+
+	// true for the inputs which must be streamed rather than mapped: "-", *.gz, *.zst and
+	// any file which is not a regular file, such as a named pipe
+	static bool IsStreamName( const char *szFileName );
+
+protected:
+
+	virtual int_type underflow();
+
+private:
+
+	void Produce();
+
+	// up to nSize bytes of the input, fewer at its end; bError set if the read failed
+	size_t ReadInput( char *pBuffer, size_t nSize, bool &bError );
+};
@@ -0,0 +1,148 @@
+/***************************************************************************************
+
+ Earth rotation over a common time grid
+
+***************************************************************************************/
+
+#include <math.h>
+#include "constant.h"
+#include "TimeGrid.h"
+#include "GreenwichSiderealTime.h"
+
+cTimeGrid::cTimeGrid()
+{
+
+}
+
+cTimeGrid::~cTimeGrid()
+{
+
+}
+
+
+void cTimeGrid::Clear()
+{
+	m_vdfJD.clear();
+	m_vdfGST.clear();
+	m_vdfSinGST.clear();
+	m_vdfCosGST.clear();
+}
+
+/***************************************************************************************
+
+  Set the grid to the given epochs in JD, UT1 system
+
+***************************************************************************************/
+
+bool cTimeGrid::SetEpochs( int nEpochs, const double *pdfJD )
+{
+	Clear();
+
+	if( nEpochs <= 0 || pdfJD == NULL ) return false;
+
+	m_vdfJD.assign( pdfJD, pdfJD + nEpochs );
+
+	ComputeRotation();
+
+	return true;
+}
+
+/***************************************************************************************
+
+  Set the grid to nEpochs equally spaced epochs from dfStartJD, step in day
+
+***************************************************************************************/
+
+bool cTimeGrid::SetEpochs( double dfStartJD, double dfStepDays, int nEpochs )
+{
+	Clear();
+
+	if( nEpochs <= 0 || dfStepDays <= 0.0 ) return false;
+
+	m_vdfJD.resize( nEpochs );
+	for( int n = 0; n < nEpochs; n++ ) m_vdfJD[ n ] = dfStartJD + n * dfStepDays;
+
+	ComputeRotation();
+
+	return true;
+}
+
+
+void cTimeGrid::ComputeRotation()
+{
+	int nEpochs = (int) m_vdfJD.size();
+
+	m_vdfGST.resize( nEpochs );
+	m_vdfSinGST.resize( nEpochs );
+	m_vdfCosGST.resize( nEpochs );
+
+	cGreenwichST::ComputeGST( nEpochs, &m_vdfJD[ 0 ], &m_vdfGST[ 0 ] );
+
+	for( int n = 0; n < nEpochs; n++ )
+	{
+		m_vdfSinGST[ n ] = sin( m_vdfGST[ n ] );
+		m_vdfCosGST[ n ] = cos( m_vdfGST[ n ] );
+	}
+}
+
+
+void cTimeGrid::GetRotationTEME2ECEF( int nEpoch, double *pdfMatrix ) const
+{
+	double dfSin = m_vdfSinGST[ nEpoch ], dfCos = m_vdfCosGST[ nEpoch ];
+
+	pdfMatrix[ 0 ] =  dfCos; pdfMatrix[ 1 ] = dfSin; pdfMatrix[ 2 ] = 0.0;
+	pdfMatrix[ 3 ] = -dfSin; pdfMatrix[ 4 ] = dfCos; pdfMatrix[ 5 ] = 0.0;
+	pdfMatrix[ 6 ] =    0.0; pdfMatrix[ 7 ] =   0.0; pdfMatrix[ 8 ] = 1.0;
+}
+
+/***************************************************************************************
+
+  Same as cTLE2PosVel::FromInertialToEFEC(), with the rotation of the grid epoch
+
+  pdfPos: inertial position in meter as input, ECEF position as output
+  pdfVel: inertial velocity in meter/s as input, ECEF velocity as output
+
+***************************************************************************************/
+
+void cTimeGrid::FromInertialToECEF( int nEpoch, double *pdfPos, double *pdfVel ) const
+{
+	double dfSin = m_vdfSinGST[ nEpoch ], dfCos = m_vdfCosGST[ nEpoch ];
+
+	double dfX =  pdfPos[ 0 ] * dfCos + pdfPos[ 1 ] * dfSin;
+	double dfY = -pdfPos[ 0 ] * dfSin + pdfPos[ 1 ] * dfCos;
+
+	if( pdfVel != NULL )
+	{
+		double dfVX =  pdfVel[ 0 ] * dfCos + pdfVel[ 1 ] * dfSin + dfY * g_dfEarthAngVelocity;
+		double dfVY = -pdfVel[ 0 ] * dfSin + pdfVel[ 1 ] * dfCos - dfX * g_dfEarthAngVelocity;
+		pdfVel[ 0 ] = dfVX;
+		pdfVel[ 1 ] = dfVY;
+	}
+
+	pdfPos[ 0 ] = dfX;
+	pdfPos[ 1 ] = dfY;
+}
+
+/***************************************************************************************
+
+  Inverse of FromInertialToECEF(), for example to place a station in TEME
+
+***************************************************************************************/
+
+void cTimeGrid::FromECEFToInertial( int nEpoch, double *pdfPos, double *pdfVel ) const
+{
+	double dfSin = m_vdfSinGST[ nEpoch ], dfCos = m_vdfCosGST[ nEpoch ];
+
+	if( pdfVel != NULL )
+	{
+		double dfVX = pdfVel[ 0 ] - pdfPos[ 1 ] * g_dfEarthAngVelocity;
+		double dfVY = pdfVel[ 1 ] + pdfPos[ 0 ] * g_dfEarthAngVelocity;
+		pdfVel[ 0 ] = dfVX * dfCos - dfVY * dfSin;
+		pdfVel[ 1 ] = dfVX * dfSin + dfVY * dfCos;
+	}
+
+	double dfX = pdfPos[ 0 ] * dfCos - pdfPos[ 1 ] * dfSin;
+	double dfY = pdfPos[ 0 ] * dfSin + pdfPos[ 1 ] * dfCos;
+	pdfPos[ 0 ] = dfX;
+	pdfPos[ 1 ] = dfY;
+}
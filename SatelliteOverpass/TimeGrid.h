@@ -0,0 +1,55 @@
+/***************************************************************************************
+
+ Earth rotation over a common time grid
+
+ The Greenwich sidereal time, its sine and cosine are computed once per epoch
+ of the grid, and shared by every satellite propagated on the grid, instead of
+ once per satellite and epoch as cTLE2PosVel::FromInertialToEFEC() does.
+
+ The rotation from TEME to ECEF is
+
+		|  cos(GST)  sin(GST)  0 |
+		| -sin(GST)  cos(GST)  0 |
+		|     0         0      1 |
+
+ the equinox equation and the polar motion are ignored, as in FromInertialToEFEC().
+
+***************************************************************************************/
+#pragma once
+
+#include <vector>
+
+class cTimeGrid
+{
+	std::vector<double> m_vdfJD;
+	std::vector<double> m_vdfGST;
+	std::vector<double> m_vdfSinGST, m_vdfCosGST;
+
+public:
+
+	cTimeGrid();
+	~cTimeGrid();
+
+	void Clear();
+
+	bool SetEpochs( int nEpochs, const double *pdfJD );
+	bool SetEpochs( double dfStartJD, double dfStepDays, int nEpochs );
+
+	int GetEpochNumber() const { return (int) m_vdfJD.size(); }
+	const double *GetJD() const { return m_vdfJD.empty() ? NULL : &m_vdfJD[ 0 ]; }
+	double GetJD( int nEpoch ) const { return m_vdfJD[ nEpoch ]; }
+	double GetGST( int nEpoch ) const { return m_vdfGST[ nEpoch ]; }
+	double GetSinGST( int nEpoch ) const { return m_vdfSinGST[ nEpoch ]; }
+	double GetCosGST( int nEpoch ) const { return m_vdfCosGST[ nEpoch ]; }
+
+	// 3x3 row major matrix, ECEF = M * TEME
+	void GetRotationTEME2ECEF( int nEpoch, double *pdfMatrix ) const;
+
+	// pdfVel may be NULL when only the position is rotated
+	void FromInertialToECEF( int nEpoch, double *pdfPos, double *pdfVel ) const;
+	void FromECEFToInertial( int nEpoch, double *pdfPos, double *pdfVel ) const;
+
+private:
+
+	void ComputeRotation();
+};
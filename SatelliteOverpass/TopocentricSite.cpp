@@ -0,0 +1,59 @@
+/***************************************************************************
+
+ Station with its local horizon frame computed once
+
+***************************************************************************/
+#undef UNICODE
+
+#include "TopocentricSite.h"
+
+
+cTopocentricSite::cTopocentricSite()
+{
+	double pdfOrigin[ 3 ] = { 0.0, 0.0, 0.0 };
+
+	SetStation( 0.0, 0.0, pdfOrigin );
+	SetElevationMask( 0.0 );
+}
+
+
+cTopocentricSite::~cTopocentricSite()
+{
+
+}
+
+
+void cTopocentricSite::SetStation( double dfLat, double dfLon, const double *pdfSiteECEF )
+{
+	m_dfLatitude = dfLat;
+	m_dfLongitude = dfLon;
+	for( int i = 0; i < 3; i++ ) m_pdfECEF[ i ] = pdfSiteECEF[ i ];
+
+	m_dfSinLat = sin( dfLat );
+	m_dfCosLat = cos( dfLat );
+	m_dfSinLon = sin( dfLon );
+	m_dfCosLon = cos( dfLon );
+
+	// unit vector of East in ECEF system
+	m_pdfEast[ 0 ] = -m_dfSinLon;
+	m_pdfEast[ 1 ] = m_dfCosLon;
+	m_pdfEast[ 2 ] = 0.0;
+
+	// unit vector of North in ECEF system
+	m_pdfNorth[ 0 ] = -m_dfCosLon * m_dfSinLat;
+	m_pdfNorth[ 1 ] = -m_dfSinLon * m_dfSinLat;
+	m_pdfNorth[ 2 ] = m_dfCosLat;
+
+	// unit vector of Vertical in ECEF system
+	m_pdfUp[ 0 ] = m_dfCosLon * m_dfCosLat;
+	m_pdfUp[ 1 ] = m_dfSinLon * m_dfCosLat;
+	m_pdfUp[ 2 ] = m_dfSinLat;
+}
+
+
+void cTopocentricSite::SetElevationMask( double dfElevationMask )
+{
+	m_dfElevationMask = dfElevationMask;
+	m_dfSinMask = sin( dfElevationMask );
+	m_dfSignedSinMask2 = m_dfSinMask * fabs( m_dfSinMask );
+}
@@ -0,0 +1,108 @@
+/***************************************************************************
+
+ Station with its local horizon frame computed once
+
+ The ECEF position of the station, the sine and cosine of its latitude and
+ longitude, its east, north and up unit vectors in ECEF, as
+ cCoorTrans::ComputeECEFUnitVector(), and the sine of its elevation mask
+ are set once, so that the topocentric coordinates of a satellite need no
+ trigonometric function of the station.
+
+ The elevation is compared to the mask on the signed squares of the up
+ component and of sin( mask ) * range, which keep the order of the two
+ values, so that the test needs neither asin nor a square root.
+
+***************************************************************************/
+#pragma once
+
+#include <math.h>
+#include "constant.h"
+
+class cTopocentricSite
+{
+	double m_dfLatitude, m_dfLongitude;		// in radian
+	double m_pdfECEF[ 3 ];					// in meter
+
+	double m_dfSinLat, m_dfCosLat, m_dfSinLon, m_dfCosLon;
+	double m_pdfEast[ 3 ], m_pdfNorth[ 3 ], m_pdfUp[ 3 ];
+
+	double m_dfElevationMask, m_dfSinMask;	// in radian
+	double m_dfSignedSinMask2;				// sin( mask ) * | sin( mask ) |
+
+public:
+
+	cTopocentricSite();
+	~cTopocentricSite();
+
+	// dfLat and dfLon geodetic in radian, pdfSiteECEF in meter
+	void SetStation( double dfLat, double dfLon, const double *pdfSiteECEF );
+	void SetElevationMask( double dfElevationMask );
+
+	double GetLatitude() const { return m_dfLatitude; }
+	double GetLongitude() const { return m_dfLongitude; }
+	const double *GetECEF() const { return m_pdfECEF; }
+	const double *GetEast() const { return m_pdfEast; }
+	const double *GetNorth() const { return m_pdfNorth; }
+	const double *GetUp() const { return m_pdfUp; }
+	double GetSinLat() const { return m_dfSinLat; }
+	double GetCosLat() const { return m_dfCosLat; }
+	double GetSinLon() const { return m_dfSinLon; }
+	double GetCosLon() const { return m_dfCosLon; }
+	double GetElevationMask() const { return m_dfElevationMask; }
+	double GetSinMask() const { return m_dfSinMask; }
+
+	// component of an ECEF vector along the local vertical
+	double ProjectUp( const double *pdfVector ) const
+	{
+		return m_pdfUp[ 0 ] * pdfVector[ 0 ] + m_pdfUp[ 1 ] * pdfVector[ 1 ] + m_pdfUp[ 2 ] * pdfVector[ 2 ];
+	}
+
+	// ECEF vector from the station to the satellite position pdfPos
+	void ComputeDelta( const double *pdfPos, double *pdfDelta ) const
+	{
+		pdfDelta[ 0 ] = pdfPos[ 0 ] - m_pdfECEF[ 0 ];
+		pdfDelta[ 1 ] = pdfPos[ 1 ] - m_pdfECEF[ 1 ];
+		pdfDelta[ 2 ] = pdfPos[ 2 ] - m_pdfECEF[ 2 ];
+	}
+
+	// sine of the elevation of the satellite position pdfPos, its range in meter
+	double ComputeSinElevation( const double *pdfPos, double &dfRange ) const
+	{
+		double pdfDelta[ 3 ];
+		ComputeDelta( pdfPos, pdfDelta );
+
+		dfRange = sqrt( pdfDelta[ 0 ] * pdfDelta[ 0 ] + pdfDelta[ 1 ] * pdfDelta[ 1 ] + pdfDelta[ 2 ] * pdfDelta[ 2 ] );
+
+		return ProjectUp( pdfDelta ) / dfRange;
+	}
+
+	// true if the elevation of the satellite position pdfPos is at or above the mask
+	bool IsAboveMask( const double *pdfPos ) const
+	{
+		double pdfDelta[ 3 ];
+		ComputeDelta( pdfPos, pdfDelta );
+
+		double dfUp = ProjectUp( pdfDelta );
+		double dfRange2 = pdfDelta[ 0 ] * pdfDelta[ 0 ] + pdfDelta[ 1 ] * pdfDelta[ 1 ] + pdfDelta[ 2 ] * pdfDelta[ 2 ];
+
+		return dfUp * fabs( dfUp ) >= m_dfSignedSinMask2 * dfRange2;
+	}
+
+	// azimuth in [0, 2pi) from the north to the east and elevation in radian, range in
+	// meter, as cCoorTrans::DeltaXYZ_to_EleAzi()
+	void ComputeAzElRange( const double *pdfPos, double &dfAz, double &dfEl, double &dfRange ) const
+	{
+		double pdfDelta[ 3 ];
+		ComputeDelta( pdfPos, pdfDelta );
+
+		double dfUp = ProjectUp( pdfDelta );
+		double dfNorth = m_pdfNorth[ 0 ] * pdfDelta[ 0 ] + m_pdfNorth[ 1 ] * pdfDelta[ 1 ] + m_pdfNorth[ 2 ] * pdfDelta[ 2 ];
+		double dfEast = m_pdfEast[ 0 ] * pdfDelta[ 0 ] + m_pdfEast[ 1 ] * pdfDelta[ 1 ];
+
+		dfRange = sqrt( pdfDelta[ 0 ] * pdfDelta[ 0 ] + pdfDelta[ 1 ] * pdfDelta[ 1 ] + pdfDelta[ 2 ] * pdfDelta[ 2 ] );
+		dfEl = asin( dfUp / dfRange );
+
+		dfAz = atan2( dfEast, dfNorth );
+		dfAz += dfAz < 0.0 ? g_dfTWOPI : 0.0;
+	}
+};
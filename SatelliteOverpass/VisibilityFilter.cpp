@@ -0,0 +1,337 @@
+/***************************************************************************
+
+ Geometric pre-filter of satellites and time spans which can not be above
+ the elevation mask of a station
+
+***************************************************************************/
+#undef UNICODE
+
+#include <math.h>
+#include <algorithm>
+#include "VisibilityFilter.h"
+#include "constant.h"
+
+
+cVisibilityFilter::cVisibilityFilter()
+{
+	m_dfSiteLat = 0.0;
+	m_dfSiteRadius = g_dfEarthSemiMajor;
+	m_dfElevationMask = 0.0;
+
+	m_nEvaluations = 0;
+	m_nSavedPropagations = 0;
+	m_nRejectedSatellites = 0;
+	m_nError = 0;
+}
+
+
+cVisibilityFilter::~cVisibilityFilter()
+{
+
+}
+
+
+void cVisibilityFilter::SetStation( const double *pdfSiteECEF )
+{
+	double dfXY = sqrt( pdfSiteECEF[ 0 ] * pdfSiteECEF[ 0 ] + pdfSiteECEF[ 1 ] * pdfSiteECEF[ 1 ] );
+
+	m_dfSiteLat = atan2( pdfSiteECEF[ 2 ], dfXY );
+	m_dfSiteRadius = sqrt( dfXY * dfXY + pdfSiteECEF[ 2 ] * pdfSiteECEF[ 2 ] );
+}
+
+
+void cVisibilityFilter::ResetCounters()
+{
+	m_nEvaluations = 0;
+	m_nSavedPropagations = 0;
+	m_nRejectedSatellites = 0;
+}
+
+/******************************************************************************************
+
+  Largest earth central angle between the station and the satellite above the mask,
+  at 1% above the apogee, plus 0.02 radian
+
+*******************************************************************************************/
+
+double cVisibilityFilter::ComputeVisibleAngle( const cTLE2PosVel &tSat ) const
+{
+	double dfPerigeeHeight, dfApogeeHeight;
+	tSat.GetPerigeeApogeeHeights( dfPerigeeHeight, dfApogeeHeight );
+
+	double dfRA = g_dfEarthSemiMajor + std::max( dfApogeeHeight, 0.0 );
+	double dfCos = std::min( m_dfSiteRadius * cos( m_dfElevationMask ) / ( 1.01 * dfRA ), 1.0 );
+
+	return acos( dfCos ) - m_dfElevationMask + 0.02;
+}
+
+/******************************************************************************************
+
+  Whole satellite test: the latitude band of the station against the inclination
+
+*******************************************************************************************/
+
+bool cVisibilityFilter::CanBeVisible( const cTLE2PosVel &tSat )
+{
+	double pdfTLE[ 10 ];
+	tSat.GetTLE( pdfTLE );
+
+	double dfInc = pdfTLE[ 5 ] * g_dfDEG2RAD;
+	dfInc = std::min( dfInc, g_dfPI - dfInc );
+
+	if( fabs( m_dfSiteLat ) - ComputeVisibleAngle( tSat ) > dfInc + 0.02 )
+	{
+		m_nRejectedSatellites++;
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Time spans the satellite may be above the mask in
+
+  For each revolution, the osculating elements are computed from the SGP4 TEME state
+  at its start, the velocity by the central difference of two positions 1 second apart
+  so that a position only propagator can be used too. The arguments of latitude of the
+  latitude band, ascending and descending, are converted to times through the true,
+  eccentric and mean anomalies.
+
+  return false if SGP4 fails, the time from the failure on is kept as one span
+
+*******************************************************************************************/
+
+bool cVisibilityFilter::GetCandidateSpans( const cTLE2PosVel &tSat, double dfStartJD, double dfEndJD,
+										   std::vector<double> &vdfSpans )
+{
+	vdfSpans.clear();
+
+	if( !tSat.IsInitialised() || dfEndJD <= dfStartJD )
+	{
+		m_nError = 1;
+		return false;
+	}
+
+	if( !CanBeVisible( tSat ) ) return true;
+
+	double pdfTLE[ 10 ];
+	tSat.GetTLE( pdfTLE );
+	double dfInc = pdfTLE[ 5 ] * g_dfDEG2RAD;
+	dfInc = std::min( dfInc, g_dfPI - dfInc ) + 0.02;
+
+	double dfPsi = ComputeVisibleAngle( tSat );
+	double dfLow = std::max( m_dfSiteLat - dfPsi, -0.5 * g_dfPI );
+	double dfHigh = std::min( m_dfSiteLat + dfPsi, 0.5 * g_dfPI );
+
+	// the whole orbit is in the band, or the argument of latitude is ill defined
+	if( ( dfLow <= -dfInc && dfHigh >= dfInc ) || dfInc < 0.07 )
+	{
+		AddSpan( dfStartJD, dfEndJD, vdfSpans );
+		return true;
+	}
+
+	stSGP4WorkArea tWork;
+	double dfJD = dfStartJD;
+
+	while( dfJD < dfEndJD )
+	{
+		double pdfPos0[ 3 ], pdfPos1[ 3 ], pdfVel[ 3 ];
+
+		m_nEvaluations += 2;
+		if( !tSat.ComputeInertialPosVel( dfJD - 0.5 / 86400.0, pdfPos0, pdfVel, tWork ) ||
+			!tSat.ComputeInertialPosVel( dfJD + 0.5 / 86400.0, pdfPos1, pdfVel, tWork ) )
+		{
+			AddSpan( dfJD, dfEndJD, vdfSpans );
+			m_nError = 1;
+			return false;
+		}
+
+		double pdfPos[ 3 ];
+		for( int i = 0; i < 3; i++ )
+		{
+			pdfPos[ i ] = 0.5 * ( pdfPos0[ i ] + pdfPos1[ i ] );
+			pdfVel[ i ] = pdfPos1[ i ] - pdfPos0[ i ];
+		}
+
+		double dfR = sqrt( pdfPos[ 0 ] * pdfPos[ 0 ] + pdfPos[ 1 ] * pdfPos[ 1 ] + pdfPos[ 2 ] * pdfPos[ 2 ] );
+		double dfV2 = pdfVel[ 0 ] * pdfVel[ 0 ] + pdfVel[ 1 ] * pdfVel[ 1 ] + pdfVel[ 2 ] * pdfVel[ 2 ];
+		double dfRV = pdfPos[ 0 ] * pdfVel[ 0 ] + pdfPos[ 1 ] * pdfVel[ 1 ] + pdfPos[ 2 ] * pdfVel[ 2 ];
+
+		double pdfH[ 3 ];
+		pdfH[ 0 ] = pdfPos[ 1 ] * pdfVel[ 2 ] - pdfPos[ 2 ] * pdfVel[ 1 ];
+		pdfH[ 1 ] = pdfPos[ 2 ] * pdfVel[ 0 ] - pdfPos[ 0 ] * pdfVel[ 2 ];
+		pdfH[ 2 ] = pdfPos[ 0 ] * pdfVel[ 1 ] - pdfPos[ 1 ] * pdfVel[ 0 ];
+		double dfHXY = sqrt( pdfH[ 0 ] * pdfH[ 0 ] + pdfH[ 1 ] * pdfH[ 1 ] );
+		double dfH = sqrt( dfHXY * dfHXY + pdfH[ 2 ] * pdfH[ 2 ] );
+
+		double dfA = 1.0 / ( 2.0 / dfR - dfV2 / g_dfEarthGM );
+		double dfP = dfH * dfH / g_dfEarthGM;
+		double dfECos = dfP / dfR - 1.0;
+		double dfESin = sqrt( dfP / g_dfEarthGM ) * dfRV / dfR;
+		double dfE = sqrt( dfECos * dfECos + dfESin * dfESin );
+
+		if( dfA <= 0.0 || dfE >= 1.0 || dfHXY <= 0.0 )
+		{
+			AddSpan( dfJD, dfEndJD, vdfSpans );
+			return true;
+		}
+
+		double dfN = sqrt( g_dfEarthGM / dfA / dfA / dfA );
+		double dfPeriod = g_dfTWOPI / dfN;
+		double dfRevEndJD = std::min( dfJD + dfPeriod / 86400.0, dfEndJD );
+
+		// argument of latitude from the ascending node N = z x h, in the direction of motion
+		double pdfNode[ 3 ] = { -pdfH[ 1 ] / dfHXY, pdfH[ 0 ] / dfHXY, 0.0 };
+		double pdfQ[ 3 ];
+		pdfQ[ 0 ] = ( pdfH[ 1 ] * pdfNode[ 2 ] - pdfH[ 2 ] * pdfNode[ 1 ] ) / dfH;
+		pdfQ[ 1 ] = ( pdfH[ 2 ] * pdfNode[ 0 ] - pdfH[ 0 ] * pdfNode[ 2 ] ) / dfH;
+		pdfQ[ 2 ] = ( pdfH[ 0 ] * pdfNode[ 1 ] - pdfH[ 1 ] * pdfNode[ 0 ] ) / dfH;
+		double dfU0 = atan2( pdfPos[ 0 ] * pdfQ[ 0 ] + pdfPos[ 1 ] * pdfQ[ 1 ] + pdfPos[ 2 ] * pdfQ[ 2 ],
+							 pdfPos[ 0 ] * pdfNode[ 0 ] + pdfPos[ 1 ] * pdfNode[ 1 ] );
+
+		double dfNu0 = dfE > 1.0e-8 ? atan2( dfESin, dfECos ) : 0.0;
+		double dfArgPerigee = dfU0 - dfNu0;
+		double dfSqrt = sqrt( 1.0 - dfE * dfE );
+
+		// mean anomaly of the arguments of latitude u, relative to the start
+		double pdfU[ 4 ], pdfM[ 4 ];
+		double dfSinI = dfHXY / dfH;
+		double dfSinLow = std::max( sin( dfLow ) / dfSinI, -1.0 );
+		double dfSinHigh = std::min( sin( dfHigh ) / dfSinI, 1.0 );
+
+		if( dfSinLow <= -1.0 && dfSinHigh >= 1.0 )
+		{
+			AddSpan( dfJD, dfRevEndJD, vdfSpans );
+		}
+		else if( dfSinLow < dfSinHigh )
+		{
+			pdfU[ 0 ] = asin( dfSinLow );
+			pdfU[ 1 ] = asin( dfSinHigh );
+			pdfU[ 2 ] = g_dfPI - pdfU[ 1 ];
+			pdfU[ 3 ] = g_dfPI - pdfU[ 0 ];
+
+			double dfM0 = 0.0;
+			for( int k = -1; k < 4; k++ )
+			{
+				double dfNu = ( k < 0 ? dfU0 : pdfU[ k ] ) - dfArgPerigee;
+				double dfEA = atan2( dfSqrt * sin( dfNu ), dfE + cos( dfNu ) );
+				double dfM = dfEA - dfE * sin( dfEA );
+
+				if( k < 0 )
+				{
+					dfM0 = dfM;
+					continue;
+				}
+
+				dfM = fmod( dfM - dfM0, g_dfTWOPI );
+				if( dfM < 0.0 ) dfM += g_dfTWOPI;
+				pdfM[ k ] = dfM;
+			}
+
+			// ascending and descending spans, in second from the start, each widened by 1%
+			// of the period, split in two when they wrap over the start
+			double pdfSpan[ 8 ];
+			int nSpans = 0;
+			double dfMargin = 0.01 * dfPeriod;
+
+			for( int k = 0; k < 4; k += 2 )
+			{
+				double dfT0 = pdfM[ k ] / dfN, dfT1 = pdfM[ k + 1 ] / dfN;
+
+				if( dfT0 <= dfT1 )
+				{
+					pdfSpan[ 2 * nSpans ] = dfT0 - dfMargin;
+					pdfSpan[ 2 * nSpans + 1 ] = dfT1 + dfMargin;
+					nSpans++;
+				}
+				else
+				{
+					pdfSpan[ 2 * nSpans ] = 0.0;
+					pdfSpan[ 2 * nSpans + 1 ] = dfT1 + dfMargin;
+					nSpans++;
+					pdfSpan[ 2 * nSpans ] = dfT0 - dfMargin;
+					pdfSpan[ 2 * nSpans + 1 ] = dfPeriod;
+					nSpans++;
+				}
+			}
+
+			// in time order for AddSpan()
+			for( int i = 1; i < nSpans; i++ )
+			{
+				for( int j = i; j > 0 && pdfSpan[ 2 * j ] < pdfSpan[ 2 * j - 2 ]; j-- )
+				{
+					std::swap( pdfSpan[ 2 * j ], pdfSpan[ 2 * j - 2 ] );
+					std::swap( pdfSpan[ 2 * j + 1 ], pdfSpan[ 2 * j - 1 ] );
+				}
+			}
+
+			for( int i = 0; i < nSpans; i++ )
+			{
+				double dfSpanStart = std::max( dfJD + pdfSpan[ 2 * i ] / 86400.0, dfJD );
+				double dfSpanEnd = std::min( dfJD + pdfSpan[ 2 * i + 1 ] / 86400.0, dfRevEndJD );
+				AddSpan( dfSpanStart, dfSpanEnd, vdfSpans );
+			}
+		}
+
+		dfJD = dfRevEndJD;
+	}
+
+	return true;
+}
+
+/******************************************************************************************
+
+  Append a span, merged with the last one if they overlap
+
+*******************************************************************************************/
+
+void cVisibilityFilter::AddSpan( double dfStartJD, double dfEndJD, std::vector<double> &vdfSpans ) const
+{
+	if( dfEndJD <= dfStartJD ) return;
+
+	if( !vdfSpans.empty() && dfStartJD <= vdfSpans.back() )
+	{
+		vdfSpans.back() = std::max( vdfSpans.back(), dfEndJD );
+		return;
+	}
+
+	vdfSpans.push_back( dfStartJD );
+	vdfSpans.push_back( dfEndJD );
+}
+
+/******************************************************************************************
+
+  Epochs of a time grid which can not be ruled out
+
+*******************************************************************************************/
+
+int cVisibilityFilter::SelectEpochs( const cTLE2PosVel &tSat, int nEpochs, const double *pdfJD, bool *pbCandidate )
+{
+	if( nEpochs <= 0 ) return 0;
+
+	std::vector<double> vdfSpans;
+	if( nEpochs == 1 || !GetCandidateSpans( tSat, pdfJD[ 0 ], pdfJD[ nEpochs - 1 ], vdfSpans ) )
+	{
+		if( vdfSpans.empty() )
+		{
+			for( int n = 0; n < nEpochs; n++ ) pbCandidate[ n ] = true;
+			return nEpochs;
+		}
+	}
+
+	int nCandidates = 0;
+	size_t nSpan = 0;
+
+	for( int n = 0; n < nEpochs; n++ )
+	{
+		while( nSpan < vdfSpans.size() && vdfSpans[ nSpan + 1 ] < pdfJD[ n ] ) nSpan += 2;
+
+		pbCandidate[ n ] = nSpan < vdfSpans.size() && vdfSpans[ nSpan ] <= pdfJD[ n ];
+		if( pbCandidate[ n ] ) nCandidates++;
+	}
+
+	m_nSavedPropagations += nEpochs - nCandidates;
+
+	return nCandidates;
+}
@@ -0,0 +1,72 @@
+/***************************************************************************
+
+ Geometric pre-filter of satellites and time spans which can not be above
+ the elevation mask of a station
+
+ A satellite at the mask is within the earth central angle Psi of the
+ station, cos( Psi + mask ) = s / r * cos( mask ), s and r the geocentric
+ distances of the station and the satellite, so its geocentric latitude is
+ within Psi of that of the station. The latitude of the satellite never
+ exceeds the inclination, so a satellite whose inclination (or 180 deg less
+ the inclination, if retrograde) is below |station latitude| - Psi at the
+ apogee is never visible.
+
+ Along the orbit, sin( latitude ) = sin( i ) * sin( u ), u the argument of
+ latitude. At the start of each revolution the osculating elements of the
+ SGP4 state give the times of the revolution where u keeps the latitude in
+ the band of the station, and only these spans have to be searched.
+
+ The filter is conservative: Psi is taken at 1% above the apogee, with
+ 0.02 radian added for the geodetic vertical and the SGP4 periodic terms,
+ and each span is widened by 1% of the period for the drift of the
+ osculating elements over the revolution.
+
+***************************************************************************/
+#pragma once
+
+#include "TLE2PosVel.h"
+
+#include <vector>
+
+class cVisibilityFilter
+{
+	double m_dfSiteLat;			// geocentric latitude of the station, in radian
+	double m_dfSiteRadius;		// geocentric distance of the station, in meter
+	double m_dfElevationMask;	// in radian
+
+	int m_nEvaluations;			// SGP4 calls made by the filter itself
+	int m_nSavedPropagations;	// epochs ruled out by SelectEpochs()
+	int m_nRejectedSatellites;	// satellites ruled out as a whole
+	int m_nError;
+
+public:
+
+	cVisibilityFilter();
+	~cVisibilityFilter();
+
+	// pdfSiteECEF in meter
+	void SetStation( const double *pdfSiteECEF );
+	void SetElevationMask( double dfElevationMask ) { m_dfElevationMask = dfElevationMask; }
+
+	// false if the satellite can never be above the mask of the station
+	bool CanBeVisible( const cTLE2PosVel &tSat );
+
+	// time spans in [dfStartJD, dfEndJD] out of which the satellite can not be above the
+	// mask, as pairs of start and end JD in vdfSpans
+	bool GetCandidateSpans( const cTLE2PosVel &tSat, double dfStartJD, double dfEndJD,
+							std::vector<double> &vdfSpans );
+
+	// pbCandidate[ n ] set to false for the epochs ruled out, pdfJD in increasing order,
+	// return the number of epochs left
+	int SelectEpochs( const cTLE2PosVel &tSat, int nEpochs, const double *pdfJD, bool *pbCandidate );
+
+	int GetEvaluationNumber() const { return m_nEvaluations; }
+	int GetSavedPropagations() const { return m_nSavedPropagations; }
+	int GetRejectedSatellites() const { return m_nRejectedSatellites; }
+	void ResetCounters();
+
+private:
+
+	double ComputeVisibleAngle( const cTLE2PosVel &tSat ) const;
+	void AddSpan( double dfStartJD, double dfEndJD, std::vector<double> &vdfSpans ) const;
+};
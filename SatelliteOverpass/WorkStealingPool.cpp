@@ -0,0 +1,208 @@
+/***************************************************************************
+
+ Work stealing pool of threads
+
+***************************************************************************/
+#undef UNICODE
+
+#include "WorkStealingPool.h"
+
+
+cWorkStealingPool::cWorkStealingPool()
+{
+	m_nThreads = 0;
+
+	m_pfTask = NULL;
+	m_nRun = 0;
+	m_nBusy = 0;
+	m_bQuit = false;
+
+	m_bAbort = false;
+	m_nStolen = 0;
+}
+
+
+cWorkStealingPool::~cWorkStealingPool()
+{
+	StopWorkers();
+}
+
+
+int cWorkStealingPool::GetThreadNumber() const
+{
+	if( m_nThreads > 0 ) return m_nThreads;
+
+	int nCores = (int) std::thread::hardware_concurrency();
+
+	return nCores > 0 ? nCores : 1;
+}
+
+/******************************************************************************************
+
+  Deal the tasks to the queues, wake the workers and take part as thread 0. A run with
+  fewer tasks than threads leaves the extra workers idle rather than stopping them.
+
+*******************************************************************************************/
+
+void cWorkStealingPool::Run( int nTasks, const std::function<void( int, int )> &fTask )
+{
+	m_nStolen = 0;
+	if( nTasks <= 0 ) return;
+
+	int nPoolThreads = GetThreadNumber();
+	if( (int) m_vtWorkers.size() != nPoolThreads - 1 )
+	{
+		StopWorkers();
+		StartWorkers( nPoolThreads - 1 );
+	}
+
+	int nThreads = nPoolThreads > nTasks ? nTasks : nPoolThreads;
+
+	m_vpQueues.clear();
+	for( int i = 0; i < nThreads; i++ )
+	{
+		m_vpQueues.push_back( std::unique_ptr<stQueue>( new stQueue ) );
+
+		int nFirst = (int) ( (long long) nTasks * i / nThreads );
+		int nLast = (int) ( (long long) nTasks * ( i + 1 ) / nThreads );
+		for( int k = nFirst; k < nLast; k++ ) m_vpQueues[ i ]->vnTasks.push_back( k );
+	}
+
+	m_bAbort = false;
+	m_pException = NULL;
+
+	{
+		std::lock_guard<std::mutex> tLock( m_tMutex );
+		m_pfTask = &fTask;
+		m_nBusy = (int) m_vtWorkers.size();
+		m_nRun++;
+	}
+	m_tStart.notify_all();
+
+	Work( 0 );
+
+	{
+		std::unique_lock<std::mutex> tLock( m_tMutex );
+		m_tDone.wait( tLock, [this]() { return m_nBusy == 0; } );
+		m_pfTask = NULL;
+	}
+
+	m_vpQueues.clear();
+
+	if( m_pException != NULL )
+	{
+		std::exception_ptr pException = m_pException;
+		m_pException = NULL;
+		std::rethrow_exception( pException );
+	}
+}
+
+
+void cWorkStealingPool::StartWorkers( int nWorkers )
+{
+	m_bQuit = false;
+
+	// a worker which starts late must still see the next run as new
+	for( int i = 1; i <= nWorkers; i++ ) m_vtWorkers.emplace_back( &cWorkStealingPool::WorkerLoop, this, i, m_nRun );
+}
+
+
+void cWorkStealingPool::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> tLock( m_tMutex );
+		m_bQuit = true;
+	}
+	m_tStart.notify_all();
+
+	for( size_t i = 0; i < m_vtWorkers.size(); i++ ) m_vtWorkers[ i ].join();
+	m_vtWorkers.clear();
+}
+
+/******************************************************************************************
+
+  Worker nThread: wait for a run after nLastRun, work on it if the run has a queue for
+  this thread, and report done; until StopWorkers()
+
+*******************************************************************************************/
+
+void cWorkStealingPool::WorkerLoop( int nThread, int nLastRun )
+{
+	for( ;; )
+	{
+		{
+			std::unique_lock<std::mutex> tLock( m_tMutex );
+			m_tStart.wait( tLock, [&]() { return m_bQuit || m_nRun != nLastRun; } );
+
+			if( m_bQuit ) return;
+			nLastRun = m_nRun;
+		}
+
+		if( nThread < (int) m_vpQueues.size() ) Work( nThread );
+
+		{
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+			if( --m_nBusy == 0 ) m_tDone.notify_one();
+		}
+	}
+}
+
+
+void cWorkStealingPool::Work( int nThread )
+{
+	try
+	{
+		int nTask;
+		while( NextTask( nThread, nTask ) ) ( *m_pfTask )( nTask, nThread );
+	}
+	catch( ... )
+	{
+		std::lock_guard<std::mutex> tLock( m_tMutex );
+		if( m_pException == NULL ) m_pException = std::current_exception();
+		m_bAbort = true;
+	}
+}
+
+/******************************************************************************************
+
+  Front of the own queue, otherwise the back of the next queue which has a task, the
+  victims tried in turn from the next thread on; false when all the queues are empty
+  or a task of the run threw
+
+*******************************************************************************************/
+
+bool cWorkStealingPool::NextTask( int nThread, int &nTask )
+{
+	if( m_bAbort ) return false;
+
+	{
+		stQueue &tQueue = *m_vpQueues[ nThread ];
+		std::lock_guard<std::mutex> tLock( tQueue.tMutex );
+
+		if( !tQueue.vnTasks.empty() )
+		{
+			nTask = tQueue.vnTasks.front();
+			tQueue.vnTasks.pop_front();
+			return true;
+		}
+	}
+
+	int nThreads = (int) m_vpQueues.size();
+
+	for( int i = 1; i < nThreads; i++ )
+	{
+		stQueue &tVictim = *m_vpQueues[ ( nThread + i ) % nThreads ];
+		std::lock_guard<std::mutex> tLock( tVictim.tMutex );
+
+		if( !tVictim.vnTasks.empty() )
+		{
+			nTask = tVictim.vnTasks.back();
+			tVictim.vnTasks.pop_back();
+			m_nStolen++;
+			return true;
+		}
+	}
+
+	// no task is ever added during a run, so empty queues stay empty
+	return false;
+}
@@ -0,0 +1,86 @@
+/***************************************************************************
+
+ Work stealing pool of threads
+
+ The tasks 0 ... n-1 are dealt to the threads in contiguous ranges, each
+ thread keeping its own queue. A thread takes its tasks from the front of
+ its queue in order, and once it has none left it steals from the back of
+ the queue of another thread, so that the threads stay busy to the end
+ when the costs of the tasks differ widely, and the tasks of a range are
+ mostly run by the same thread in order.
+
+ Which thread runs a task depends on the timing, so a task writes its
+ results to a place of its own, for example a slot indexed by the task,
+ for the results to be gathered in a deterministic order.
+
+ The worker threads are started by the first Run() and wait for the next
+ one, so that a caller running many small batches does not pay for the
+ creation of the threads each time. They are stopped by the destructor,
+ or restarted by a Run() after SetThreadNumber() changed their number.
+
+ An exception thrown by a task stops the run: the tasks not yet started
+ are dropped, and the first exception is thrown again by Run() once all
+ the threads are done.
+
+***************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class cWorkStealingPool
+{
+	struct stQueue
+	{
+		std::mutex tMutex;
+		std::deque<int> vnTasks;
+	};
+
+	int m_nThreads;				// 0 for one per core
+	std::vector< std::unique_ptr<stQueue> > m_vpQueues;
+
+	// workers 1 ... n-1, the thread calling Run() being thread 0
+	std::vector<std::thread> m_vtWorkers;
+	std::mutex m_tMutex;
+	std::condition_variable m_tStart, m_tDone;
+	const std::function<void( int, int )> *m_pfTask;	// task of the current run
+	int m_nRun;					// number of the current run, the workers wait for the next
+	int m_nBusy;				// workers not done with the current run
+	bool m_bQuit;				// the workers are asked to end
+
+	std::atomic<bool> m_bAbort;	// a task threw, the other tasks are dropped
+	std::exception_ptr m_pException;	// first exception of the current run
+
+	std::atomic<int> m_nStolen;	// tasks stolen by the last Run()
+
+public:
+
+	cWorkStealingPool();
+	~cWorkStealingPool();
+
+	void SetThreadNumber( int nThreads ) { m_nThreads = nThreads; }
+	int GetThreadNumber() const;
+
+	// fTask( nTask, nThread ) for each task, nThread in [0, GetThreadNumber()), the
+	// calling thread being thread 0; return when all the tasks are done. Not to be
+	// called by a task of the same pool
+	void Run( int nTasks, const std::function<void( int, int )> &fTask );
+
+	int GetStolenNumber() const { return m_nStolen; }
+
+private:
+
+	void StartWorkers( int nWorkers );
+	void StopWorkers();
+	void WorkerLoop( int nThread, int nLastRun );
+	void Work( int nThread );
+
+	bool NextTask( int nThread, int &nTask );
+};
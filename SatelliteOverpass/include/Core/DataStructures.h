@@ -217,6 +217,87 @@ struct stSatelliteIOE
 	double GetOrbitalPeriod() { return (double)pfElement7to18[ 11 ]; }
 };
 */
+/***********************************************************************************
+
+ Numeric orbital elements of a satellite, the same fields and units as
+ stSatelliteIOE without its text lines and scheduling data. It is trivially
+ copyable, for the catalogs to be parsed, copied and grown as plain memory.
+
+***********************************************************************************/
+
+struct stSatelliteElements
+{
+	int nSatelliteID;
+	int nSIC;
+	char cElementType;			// T for TLE, E for EOS, I for IRV
+	int nIntJD, nFractionJD;
+
+	int pnElement1to6[ 6 ];
+	float pfElement7to18[ 20 ];
+
+	double GetRefJD( ) const 
+	{ 
+		return ( (double)nIntJD + (double)nFractionJD * 1.0e-9 ); 
+	};
+
+	void SetRefJD( double dfJD ) 
+	{
+		nIntJD = (int) dfJD;
+		nFractionJD = (int) ( ( dfJD - nIntJD ) * 1.0e9 );
+	}
+
+	double GetOrbitalPeriod( ) const { return (double)pfElement7to18[ 11 ]; };
+	double GetInclination() const { return (double) pnElement1to6[ 2 ] * 1.0e-5; };
+	double GetEccentricity() const { return (double) pnElement1to6[ 1 ] * 1.0e-7; };
+
+	double GetSemiMajor() const
+	{
+		double dfn = 2 * 3.1415926 * pnElement1to6[0] * 1e-8 / 86400.0;
+		return pow( 3.986004418e14/( dfn*dfn ), 1.0/3.0 );
+	}
+};
+
+/***********************************************************************************
+
+ Text lines and scheduling data of a satellite, the side table of the
+ stSatelliteElements of a catalog, where they are needed
+
+***********************************************************************************/
+
+struct stSatelliteAttributes
+{
+	std::string Line1, Line2, Line3;
+
+	bool bNewElement;
+	double dfTimeLastTracked;
+	bool bTrackingtarget;
+	bool bAcquired;
+	bool bTrackable;
+	bool bTrackingTested;
+	bool bSecondTrack;
+
+	bool bLEO;
+	bool bNORAD;
+
+	double Diameter;//m
+
+	std::vector< std::string > trackbenefit;
+
+	stSatelliteAttributes( )
+	{
+		bNewElement = true;
+		dfTimeLastTracked = -10;
+		bTrackingtarget = false;
+		bAcquired = false;
+		bTrackable = false;
+		bTrackingTested = false;
+		bSecondTrack = false;
+		bLEO = false;
+		bNORAD = false;
+		Diameter = 0.0;
+	}
+};
+
 /***********************************************************************************
 
  Orbital elements that define a satellite orbit
@@ -379,6 +460,9 @@ struct stSatelliteIOE
 	{
 		Assign( RHS );
 	}
+	// moved without copying the strings, when a vector of them grows
+	stSatelliteIOE( stSatelliteIOE &&RHS ) = default;
+	stSatelliteIOE& operator=( stSatelliteIOE &&RHS ) = default;
 	stSatelliteIOE( )
 	{
 		nSatelliteID = 0;
@@ -402,11 +486,77 @@ struct stSatelliteIOE
 		dfTimeLastTracked = -10;
 		bTrackingtarget = false;
 		trackbenefit.clear( );
-		trackbenefit.reserve( 1000 );
 		bAcquired = false;
 		bTrackable = false;
 		bTrackingTested = false;
 		bSecondTrack = false;
+		bLEO = false;
+		bNORAD = false;
+		Diameter = 0.0;
+	}
+
+	// adapters to the slim element record and its side table
+	stSatelliteIOE( const stSatelliteElements &tElements ) : stSatelliteIOE( )
+	{
+		SetElements( tElements );
+	}
+
+	void GetElements( stSatelliteElements &tElements ) const
+	{
+		tElements.nSatelliteID = nSatelliteID;
+		tElements.nSIC = nSIC;
+		tElements.cElementType = cElementType;
+		tElements.nIntJD = nIntJD;
+		tElements.nFractionJD = nFractionJD;
+		for( int i = 0; i < 6; i++ ) tElements.pnElement1to6[ i ] = pnElement1to6[ i ];
+		for( int i = 0; i < 20; i++ ) tElements.pfElement7to18[ i ] = pfElement7to18[ i ];
+	}
+
+	void SetElements( const stSatelliteElements &tElements )
+	{
+		nSatelliteID = tElements.nSatelliteID;
+		nSIC = tElements.nSIC;
+		cElementType = tElements.cElementType;
+		nIntJD = tElements.nIntJD;
+		nFractionJD = tElements.nFractionJD;
+		for( int i = 0; i < 6; i++ ) pnElement1to6[ i ] = tElements.pnElement1to6[ i ];
+		for( int i = 0; i < 20; i++ ) pfElement7to18[ i ] = tElements.pfElement7to18[ i ];
+	}
+
+	void GetAttributes( stSatelliteAttributes &tAttributes ) const
+	{
+		tAttributes.Line1 = Line1;
+		tAttributes.Line2 = Line2;
+		tAttributes.Line3 = Line3;
+		tAttributes.bNewElement = bNewElement;
+		tAttributes.dfTimeLastTracked = dfTimeLastTracked;
+		tAttributes.bTrackingtarget = bTrackingtarget;
+		tAttributes.bAcquired = bAcquired;
+		tAttributes.bTrackable = bTrackable;
+		tAttributes.bTrackingTested = bTrackingTested;
+		tAttributes.bSecondTrack = bSecondTrack;
+		tAttributes.bLEO = bLEO;
+		tAttributes.bNORAD = bNORAD;
+		tAttributes.Diameter = Diameter;
+		tAttributes.trackbenefit = trackbenefit;
+	}
+
+	void SetAttributes( const stSatelliteAttributes &tAttributes )
+	{
+		Line1 = tAttributes.Line1;
+		Line2 = tAttributes.Line2;
+		Line3 = tAttributes.Line3;
+		bNewElement = tAttributes.bNewElement;
+		dfTimeLastTracked = tAttributes.dfTimeLastTracked;
+		bTrackingtarget = tAttributes.bTrackingtarget;
+		bAcquired = tAttributes.bAcquired;
+		bTrackable = tAttributes.bTrackable;
+		bTrackingTested = tAttributes.bTrackingTested;
+		bSecondTrack = tAttributes.bSecondTrack;
+		bLEO = tAttributes.bLEO;
+		bNORAD = tAttributes.bNORAD;
+		Diameter = tAttributes.Diameter;
+		trackbenefit = tAttributes.trackbenefit;
 	}
 
 	double GetSemiMajor()
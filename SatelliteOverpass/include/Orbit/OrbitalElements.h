@@ -23,8 +23,68 @@
 
 using namespace std;
 
+class cTimeGrid;
+
+/***************************************************************************
+
+ Per-call working storage of the SGP4 propagation
+
+ SGP4() keeps everything that changes from call to call in this structure,
+ so that an initialised cTLE2PosVel is read-only during propagation. The
+ deep space resonance integrator state (XLI, XNI, ATIME) is carried between
+ calls to continue the integration from the last computed point; a zeroed 
+ work area restarts the integration from the epoch.
+
+***************************************************************************/
+
+struct stSGP4WorkArea
+{
+	// mean elements at the requested time
+	double dfSMM, dfEccM, dfIncM, dfRAANM, dfPerigeeM, dfMAM;
+	double dfMMM;	// mean motion
+
+	double dfTC;	// time since epoch, in minute
+	double dfDNDT;	// change of mean motion due to resonance
+
+	// resonance integrator state
+	double dfXLI, dfXNI, dfATIME;
+
+	int nError;
+
+	stSGP4WorkArea() { Reset(); }
+
+	void Reset()
+	{
+		dfSMM = dfEccM = dfIncM = dfRAANM = dfPerigeeM = dfMAM = dfMMM = 0.0;
+		dfTC = dfDNDT = 0.0;
+		dfXLI = dfXNI = dfATIME = 0.0;
+		nError = 0;
+	}
+};
+
+// state of the deep space resonance integrator at a checkpoint
+struct stResonanceState
+{
+	double dfATIME;		// time since epoch, in minute
+	double dfXLI, dfXNI;
+};
+
+// number of days before and after the epoch covered by the resonance checkpoints
+#define SGP4_RESONANCE_CHECKPOINT_DAYS 7
+
+// orbit regimes of the SGP4 variants
+enum eSGP4Regime
+{
+	SGP4_NEAR_EARTH,	// perigee height 220km or above, period less than 225 minutes
+	SGP4_LOW_PERIGEE,	// perigee height below 220km, simplified drag terms
+	SGP4_DEEP_SPACE		// period 225 minutes or longer
+};
+
 class cTLE2PosVel
 {
+	// the batch propagator copies the near-earth coefficients
+	friend class cSGP4Batch;
+
 	// original TLE elements
 	// pdfTLE[ 1 ]: year
 	// pdfTLE[ 2 ]: day of year
@@ -88,8 +148,8 @@ class cTLE2PosVel
 		   m_dfT2Coe, m_dfT3Coe, m_dfT4Coe, m_dfT5Coe;	// coefficients for deltaT^2, ..., terms of MA+Perigee+RAAN
 	double m_dfCC1, m_dfCC2, m_dfCC3, m_dfCC4, m_dfCC5;
 
-	// mean value at epoch
-	double m_dfSMM, m_dfEccM, m_dfIncM, m_dfRAANM, m_dfPerigeeM, m_dfMAM;
+	// mean value at epoch, used by the deep space initialisation
+	double m_dfEccM, m_dfIncM;
 	double m_dfMMM;	// mean motion
 
 	double m_dfSinRAANM, m_dfCosRAANM, m_dfSinPerigeeM, m_dfCosPerigeeM, m_dfSinIncM, m_dfCosIncM;
@@ -121,16 +181,28 @@ class cTLE2PosVel
 
 	int m_nIREZ;	// resonance type, 1 for 24 hour resonance, 2 for 12 hour resonance
 	double m_dfDEDT, m_dfDIDT, m_dfDMDT, m_dfDOMDT, m_dfDNODT;
-	double m_dfDNDT;
 
 	double m_dfD2201, m_dfD2211, m_dfD3210, m_dfD3222, m_dfD4410, m_dfD4422,
 		   m_dfD5220, m_dfD5232, m_dfD5421, m_dfD5433;
 	double m_dfDEL1, m_dfDEL2, m_dfDEL3, m_dfFASX2, m_dfFASX4, m_dfFASX6, m_dfXLAMO;
-	double m_dfXLI, m_dfXNI, m_dfATIME, m_dfSTEPP, m_dfSTEPN, m_dfSTEP2, m_dfXFACT;
+	double m_dfSTEPP, m_dfSTEPN, m_dfSTEP2, m_dfXFACT;
+
+	// checkpoints of the resonance integration after and before the epoch,
+	// m_dfResonanceInterval minutes apart, the first one at the epoch
+	std::vector<stResonanceState> m_vtResonanceAfter, m_vtResonanceBefore;
+	double m_dfResonanceInterval;
 	
 	bool m_bInit;
 	bool m_bPosOnly;
 
+	// work area of the non-reentrant interface
+	stSGP4WorkArea m_tWork;
+
+	// SGP4 variant of the orbit regime, chosen by SelectSGP4Kernel()
+	typedef bool ( cTLE2PosVel::*SGP4Function )( double dfJD, double *pdfPos, double *pdfVel, 
+												  stSGP4WorkArea &tWork ) const;
+	SGP4Function m_pfnSGP4;
+
 public:
 
 	cTLE2PosVel();
@@ -138,23 +210,41 @@ public:
 
 	bool ReadTLE( int nNORADID, char *szFileName );
 
-	bool SetOrbitalElements( stSatelliteIOE stIOE );
+	bool SetOrbitalElements( const stSatelliteIOE &stIOE );
+	bool SetOrbitalElements( const stSatelliteElements &stIOE );
 	bool SetOrbitalElements( double *pdfTLE );
 	bool GetOrbitalElements( double *pdfTLE );
 
-	void GetOrbitalElementsRefJD( double &dfRefJD );
-	void SetComputePositionOnly( bool bState ) { m_bPosOnly = bState; }
+	void GetOrbitalElementsRefJD( double &dfRefJD ) const;
+	void SetComputePositionOnly( bool bState );
+	bool IsComputePositionOnly() const { return m_bPosOnly; }
+	bool IsInitialised() const { return m_bInit; }
+
+	// state of the non-reentrant interface, including the resonance integrator
+	const stSGP4WorkArea &GetWorkArea() const { return m_tWork; }
+	void SetWorkArea( const stSGP4WorkArea &tWork ) { m_tWork = tWork; }
+
+	// extend the resonance checkpoints, for long prediction periods
+	bool BuildResonanceCheckpoints( int nDaysBefore, int nDaysAfter );
 
 	bool ComputeInertialPosVel( double dfJD, double *pdfPos, double *pdfVel );
 	bool ComputeInertialPosVel( double &dfIntJDUTCGivenEpoch, double &dfFraJDUTCGivenEpoch, 
 			                    double *pdfPos, double *pdfVel );
 	bool ComputeECEFPosVel( double dfJD, double *pdfPos, double *pdfVel );
 
-	void GetPerigeeApogeeHeights( double &dfPerigeeHeight, double &dfApogeeHeight );
-	double GetInclination() { return m_dfInc0; }
+	// reentrant propagation, safe to call concurrently on a shared propagator
+	bool ComputeInertialPosVel( double dfJD, double *pdfPos, double *pdfVel, stSGP4WorkArea &tWork ) const;
+	bool ComputeECEFPosVel( double dfJD, double *pdfPos, double *pdfVel, stSGP4WorkArea &tWork ) const;
+	// at epoch nEpoch of a grid, with the earth rotation of the grid
+	bool ComputeECEFPosVel( const cTimeGrid &tGrid, int nEpoch, double *pdfPos, double *pdfVel, 
+							stSGP4WorkArea &tWork ) const;
+
+	void GetPerigeeApogeeHeights( double &dfPerigeeHeight, double &dfApogeeHeight ) const;
+	double GetInclination() const { return m_dfInc0; }
 
-	void GetTLE( double *pdfTLE );
+	void GetTLE( double *pdfTLE ) const;
 
+	// szFileName "-" reads the standard input, *.gz and *.zst are decompressed as they are read
 	bool ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *szFileName, bool bPerigeeTest = false,
 		             double perigeeLimit = 6378137.0 + 250000.0, double apogeeLimit = 6378137.0 + 5000000.0 );
 	bool ReadAllTLE( std::vector<stSatelliteIOE> &TLEData, const char *szFileName, int numberID, int*NORADID );
@@ -162,17 +252,26 @@ public:
 private:
 
 	bool Initialise();
-	bool SGP4( double dfJD, double *pdfPos, double *pdfVel );
+	bool SGP4( double dfJD, double *pdfPos, double *pdfVel, stSGP4WorkArea &tWork ) const
+	{
+		return ( this->*m_pfnSGP4 )( dfJD, pdfPos, pdfVel, tWork );
+	}
+
+	template< int nRegime, bool bPosOnly >
+	bool SGP4Kernel( double dfJD, double *pdfPos, double *pdfVel, stSGP4WorkArea &tWork ) const;
+	void SelectSGP4Kernel();
 
 	bool InitialiseDeepSpace();
 
 	bool DSCOM();
 
-	bool DeepSpaceSecularEffect();
-	bool DeepSapceResonance( double dfTHETA );
-	bool DeepSpacePeriodicEffect( double &dfEccP, double &dfIncP, double &dfRAANP,
-								  double &dfPerigeeP, double &dfMAP );
-	bool FromInertialToEFEC( double dfJD, double *pdfPos, double *pdfVel );
+	bool DeepSpaceSecularEffect( stSGP4WorkArea &tWork ) const;
+	bool DeepSapceResonance( double dfTHETA, stSGP4WorkArea &tWork ) const;
+	void StartResonance( stSGP4WorkArea &tWork ) const;
+	bool DeepSpacePeriodicEffect( const stSGP4WorkArea &tWork, 
+								  double &dfEccP, double &dfIncP, double &dfRAANP,
+								  double &dfPerigeeP, double &dfMAP ) const;
+	bool FromInertialToEFEC( double dfJD, double *pdfPos, double *pdfVel ) const;
 
 	bool ReadTLELine1( string line, struct stSatelliteIOE &stIOE );
 	bool ReadTLELine2( string line, struct stSatelliteIOE &stIOE );
@@ -180,10 +279,9 @@ private:
 	bool CheckSum( string line );
 
 	int m_nCounter;
-	bool m_bTLEExists[50000];
 
 	double GetAltitudeKM( const double pos[3] );
 
 	void PerturbElement( stSatelliteIOE &tIOE, int nsatID );
 
-};
\ No newline at end of file
+};
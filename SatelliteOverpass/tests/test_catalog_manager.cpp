@@ -0,0 +1,103 @@
+/**
+ * @file test_catalog_manager.cpp
+ * @brief 目录热更新单元测试
+ *
+ * 测试cCatalogManager的增量重新加载和快照发布。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include "../TLE2PosVel.h"
+#include "../CatalogManager.h"
+#include "test_fixtures.h"
+
+/**
+ * @test 测试目录热更新
+ * @brief 只有新增和变化的卫星重新初始化，未变化的卫星沿用原外推器，读者持有的旧快照保持有效
+ */
+TEST(CatalogManagerTest, Reload)
+{
+    std::string first = makeTLE(10001, 10.0) + makeTLE(10002, 20.0) + makeTLE(10003, 30.0);
+    std::string second = makeTLE(10002, 20.0) + makeTLE(10003, 35.0) + makeTLE(10004, 40.0);
+
+    cCatalogManager manager;
+    EXPECT_EQ(manager.GetSnapshot(), nullptr);
+    ASSERT_TRUE(manager.Reload(first.data(), first.data() + first.size()));
+    EXPECT_EQ(manager.GetAddedNumber(), 3);
+
+    std::shared_ptr<const stCatalogSnapshot> old = manager.GetSnapshot();
+    ASSERT_NE(old, nullptr);
+    EXPECT_EQ(old->nVersion, 1);
+    EXPECT_EQ(old->GetSatelliteNumber(), 3);
+
+    std::atomic<bool> stop(false);
+    std::atomic<int> reads(0);
+    std::thread reader([&]() {
+        stSGP4WorkArea work;
+        while (!stop) {
+            std::shared_ptr<const stCatalogSnapshot> snapshot = manager.GetSnapshot();
+            const cTLE2PosVel* sat = snapshot->GetPropagator(10002);
+            double pos[3], vel[3];
+            if (sat != nullptr && sat->ComputeECEFPosVel(2454736.0, pos, vel, work)) ++reads;
+        }
+    });
+
+    for (int n = 0; n < 20; ++n) {
+        ASSERT_TRUE(manager.Reload(n % 2 == 0 ? second.data() : first.data(),
+                                   n % 2 == 0 ? second.data() + second.size() : first.data() + first.size()));
+    }
+    ASSERT_TRUE(manager.Reload(first.data(), first.data() + first.size()));
+    ASSERT_TRUE(manager.Reload(second.data(), second.data() + second.size()));
+    while (reads == 0) std::this_thread::yield();
+    stop = true;
+    reader.join();
+    EXPECT_GT(reads.load(), 0);
+
+    EXPECT_EQ(manager.GetAddedNumber(), 1);
+    EXPECT_EQ(manager.GetChangedNumber(), 1);
+    EXPECT_EQ(manager.GetRemovedNumber(), 1);
+    EXPECT_EQ(manager.GetUnchangedNumber(), 1);
+
+    std::shared_ptr<const stCatalogSnapshot> current = manager.GetSnapshot();
+    EXPECT_EQ(current->nVersion, 23);
+    EXPECT_EQ(current->Find(10001), -1);
+    EXPECT_NE(current->GetPropagator(10004), nullptr);
+
+    // 旧快照中的外推器仍可使用
+    EXPECT_EQ(old->GetSatelliteNumber(), 3);
+    double pos[3], vel[3];
+    stSGP4WorkArea work;
+    EXPECT_TRUE(old->GetPropagator(10001)->ComputeECEFPosVel(2454736.0, pos, vel, work));
+
+    // 未变化的卫星共用外推器
+    std::shared_ptr<const stCatalogSnapshot> before = manager.GetSnapshot();
+    ASSERT_TRUE(manager.Reload(second.data(), second.data() + second.size()));
+    EXPECT_EQ(manager.GetUnchangedNumber(), 3);
+    EXPECT_EQ(manager.GetSnapshot()->GetPropagator(10003), before->GetPropagator(10003));
+
+    // 空的、截断的或校验和错误的文件不发布，读者仍使用原目录，计数保持原目录的值
+    std::shared_ptr<const stCatalogSnapshot> published = manager.GetSnapshot();
+    std::string truncated = second.substr(0, second.size() - 30);
+    std::string corrupted = second;
+    corrupted[10] = corrupted[10] == '0' ? '1' : '0';
+    for (const std::string* text : { &truncated, &corrupted }) {
+        EXPECT_FALSE(manager.Reload(text->data(), text->data() + text->size()));
+    }
+    EXPECT_FALSE(manager.Reload(second.data(), second.data()));
+    EXPECT_EQ(manager.GetSnapshot(), published);
+    EXPECT_EQ(manager.GetSnapshot()->GetSatelliteNumber(), 3);
+    EXPECT_EQ(manager.GetUnchangedNumber(), 3);
+
+    cCatalogManager empty;
+    EXPECT_FALSE(empty.Reload(second.data(), second.data()));
+    EXPECT_EQ(empty.GetSnapshot(), nullptr);
+    EXPECT_EQ(empty.GetAddedNumber(), 0);
+}
@@ -0,0 +1,65 @@
+/**
+ * @file test_element_record.cpp
+ * @brief 精简根数记录单元测试
+ *
+ * 测试stSatelliteElements的平凡复制性及其与stSatelliteIOE的互转。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../TLE2PosVel.h"
+#include "../TLEParser.h"
+
+/**
+ * @test 测试精简根数记录
+ * @brief stSatelliteElements可平凡复制，经适配器与stSatelliteIOE互转后外推结果一致
+ */
+TEST(ElementRecordTest, SlimRecordAdapters)
+{
+    static_assert(std::is_trivially_copyable<stSatelliteElements>::value, "stSatelliteElements must be trivially copyable");
+
+    const char* line1 = "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+    const char* line2 = "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+    std::string text = std::string("ISS (ZARYA)\n") + line1 + "\n" + line2 + "\n";
+
+    cTLEParser parser;
+    std::vector<stSatelliteElements> elements;
+    std::vector<stSatelliteIOE> ioes;
+    ASSERT_EQ(parser.Parse(text.data(), text.data() + text.size(), elements), 1);
+    ASSERT_EQ(parser.Parse(text.data(), text.data() + text.size(), ioes), 1);
+    EXPECT_TRUE(ioes[0].trackbenefit.capacity() == 0);
+
+    stSatelliteElements fromIOE;
+    ioes[0].GetElements(fromIOE);
+    EXPECT_EQ(memcmp(&fromIOE.pnElement1to6, &elements[0].pnElement1to6, sizeof(fromIOE.pnElement1to6)), 0);
+    EXPECT_EQ(fromIOE.GetRefJD(), elements[0].GetRefJD());
+
+    stSatelliteIOE adapted(elements[0]);
+    EXPECT_EQ(adapted.nSatelliteID, 25544);
+    EXPECT_TRUE(adapted.Line2.empty());
+
+    stTLERecord view;
+    ASSERT_NE(parser.NextRecord(text.data(), text.data() + text.size(), view), nullptr);
+    stSatelliteAttributes attributes;
+    cTLEParser::GetAttributes(view, attributes);
+    adapted.SetAttributes(attributes);
+    EXPECT_EQ(adapted.Line1, "ISS (ZARYA)");
+    EXPECT_EQ(adapted.Line2, line1);
+    EXPECT_EQ(adapted.Line3, line2);
+
+    cTLE2PosVel fromElements, fromAdapted;
+    ASSERT_TRUE(fromElements.SetOrbitalElements(elements[0]));
+    ASSERT_TRUE(fromAdapted.SetOrbitalElements(adapted));
+    double pos[3], vel[3], posRef[3], velRef[3];
+    double refJD = elements[0].GetRefJD();
+    ASSERT_TRUE(fromElements.ComputeECEFPosVel(refJD + 0.5, pos, vel));
+    ASSERT_TRUE(fromAdapted.ComputeECEFPosVel(refJD + 0.5, posRef, velRef));
+    for (int k = 0; k < 3; ++k) EXPECT_EQ(pos[k], posRef[k]);
+}
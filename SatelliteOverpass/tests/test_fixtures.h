@@ -0,0 +1,74 @@
+/**
+ * @file test_fixtures.h
+ * @brief 单元测试共用的测试数据
+ *
+ * 多个测试文件共用的两行根数、根数数组及测站坐标的生成函数。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "../DataStructure.h"
+
+// ISS的两行根数
+inline const char* const issLine1 = "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+inline const char* const issLine2 = "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+
+// 以ISS的两行根数为模板，改写编号和平近点角，重新计算校验和
+inline std::string makeTLE(int id, double meanAnomaly)
+{
+    std::string first = issLine1;
+    std::string second = issLine2;
+    char field[16];
+    snprintf(field, sizeof(field), "%05d", id);
+    first.replace(2, 5, field);
+    second.replace(2, 5, field);
+    snprintf(field, sizeof(field), "%8.4f", meanAnomaly);
+    second.replace(43, 8, field);
+    for (std::string* line : { &first, &second }) {
+        int sum = 0;
+        for (int i = 0; i < 68; ++i) {
+            char c = (*line)[i];
+            if (c >= '0' && c <= '9') sum += c - '0';
+            else if (c == '-') sum += 1;
+        }
+        (*line)[68] = (char)('0' + sum % 10);
+    }
+    return first + "\n" + second + "\n";
+}
+
+// TLE数组格式：[0]编号 [1]年 [2]年积日 [3]BSTAR [4]偏心率 [5]倾角 [6]升交点赤经 [7]近地点幅角 [8]平近点角 [9]平运动
+inline double issTLE[10] = { 25544, 24, 140.5, 1.027e-4, 0.0007, 51.64, 200.0, 50.0, 310.0, 15.5 };
+inline double molniyaTLE[10] = { 8195, 24, 140.5, 1.0e-4, 0.6877146, 64.1586, 279.0717, 264.7651, 20.2257, 2.00491383 };
+
+// WGS84椭球面上的测站地固系坐标，lat、lon为大地纬度、经度（弧度），ecef单位为米
+inline void stationECEF(double lat, double lon, double* ecef)
+{
+    const double a = 6378137.0, f = 1.0 / 298.257223563, e2 = f * (2.0 - f);
+    const double n = a / std::sqrt(1.0 - e2 * std::sin(lat) * std::sin(lat));
+    ecef[0] = n * std::cos(lat) * std::cos(lon);
+    ecef[1] = n * std::cos(lat) * std::sin(lon);
+    ecef[2] = n * (1.0 - e2) * std::sin(lat);
+}
+
+// 椭球面上的测站，只填写纬度、经度和地固系坐标
+inline stTrackStation makeStation(double lat, double lon)
+{
+    stTrackStation station;
+    memset(&station, 0, sizeof(station));
+    station.dfLatitude = lat;
+    station.dfLongitude = lon;
+    double ecef[3];
+    stationECEF(lat, lon, ecef);
+    station.dfECEFX = ecef[0];
+    station.dfECEFY = ecef[1];
+    station.dfECEFZ = ecef[2];
+    return station;
+}
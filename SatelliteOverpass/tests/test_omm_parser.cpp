@@ -0,0 +1,150 @@
+/**
+ * @file test_omm_parser.cpp
+ * @brief OMM读取单元测试
+ *
+ * 测试cOMMParser对KVN、XML、CSV格式的解析及与TLE结果的一致性。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../TLE2PosVel.h"
+#include "../TLEParser.h"
+#include "../TLEStream.h"
+#include "../OMMParser.h"
+
+/**
+ * @test 测试 OMM 读取
+ * @brief KVN、XML、CSV 三种格式得到与 TLE 相同的根数记录，超过5位的编号和年积日历元可读取
+ */
+TEST(OMMParserTest, MatchesTLE)
+{
+    const char* line1 = "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+    const char* line2 = "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+    std::string tleText = std::string(line1) + "\n" + line2 + "\n";
+
+    cTLEParser tleParser;
+    std::vector<stSatelliteElements> expected;
+    ASSERT_EQ(tleParser.Parse(tleText.data(), tleText.data() + tleText.size(), expected), 1);
+
+    std::string kvn =
+        "CCSDS_OMM_VERS = 2.0\n"
+        "COMMENT GENERATED FROM THE TLE\n"
+        "ORIGINATOR = TEST\n"
+        "OBJECT_NAME = ISS (ZARYA)\n"
+        "OBJECT_ID = 1998-067A\n"
+        "MEAN_ELEMENT_THEORY = SGP4\n"
+        "EPOCH = 2008-09-20T12:25:40.104192\n"
+        "MEAN_MOTION = 15.72125391 [rev/day]\n"
+        "ECCENTRICITY = .0006703\n"
+        "INCLINATION = 51.6416 [deg]\n"
+        "RA_OF_ASC_NODE = 247.4627\n"
+        "ARG_OF_PERICENTER = 130.5360\n"
+        "MEAN_ANOMALY = 325.0288\n"
+        "NORAD_CAT_ID = 25544\n"
+        "BSTAR = -.11606E-4\n"
+        "MEAN_MOTION_DOT = -.00002182\n"
+        "MEAN_MOTION_DDOT = 0\n"
+        "CCSDS_OMM_VERS = 2.0\n"
+        "NORAD_CAT_ID = 25545\n";
+
+    std::string xml =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<ndm><omm id=\"CCSDS_OMM_VERS\" version=\"2.0\"><header><ORIGINATOR>TEST</ORIGINATOR></header>"
+        "<body><segment><metadata><OBJECT_NAME>ISS (ZARYA)</OBJECT_NAME><OBJECT_ID>1998-067A</OBJECT_ID>"
+        "</metadata><data><!-- <EPOCH>bad</EPOCH> --><meanElements><EPOCH>2008-09-20T12:25:40.104192</EPOCH>"
+        "<MEAN_MOTION>15.72125391</MEAN_MOTION><ECCENTRICITY>.0006703</ECCENTRICITY>"
+        "<INCLINATION>51.6416</INCLINATION><RA_OF_ASC_NODE>247.4627</RA_OF_ASC_NODE>"
+        "<ARG_OF_PERICENTER>130.5360</ARG_OF_PERICENTER><MEAN_ANOMALY>325.0288</MEAN_ANOMALY>"
+        "</meanElements><tleParameters><NORAD_CAT_ID>25544</NORAD_CAT_ID><BSTAR>-1.1606E-5</BSTAR>"
+        "<MEAN_MOTION_DOT>-2.182E-5</MEAN_MOTION_DOT><MEAN_MOTION_DDOT>0</MEAN_MOTION_DDOT>"
+        "</tleParameters></data></segment></body></omm></ndm>\n";
+
+    std::string csv =
+        "OBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,"
+        "ARG_OF_PERICENTER,MEAN_ANOMALY,EPHEMERIS_TYPE,CLASSIFICATION_TYPE,NORAD_CAT_ID,"
+        "ELEMENT_SET_NO,REV_AT_EPOCH,BSTAR,MEAN_MOTION_DOT,MEAN_MOTION_DDOT\r\n"
+        "\"ISS (ZARYA), MODULE\",1998-067A,2008-09-20T12:25:40.104192,15.72125391,.0006703,51.6416,247.4627,"
+        "130.5360,325.0288,0,U,25544,292,56353,-.11606e-4,-.00002182,0\r\n"
+        "BIG,2030-001A,2008-264T12:25:40.104192,15.72125391,.0006703,51.6416,247.4627,"
+        "130.5360,325.0288,0,U,270000123,1,1,-.11606e-4,-.00002182,0\r\n"
+        "BAD,2030-002A,2008-09-20T12:25:40,15.7x,.0006703,51.6416,247.4627,"
+        "130.5360,325.0288,0,U,270000124,1,1,0,0,0\r\n";
+
+    EXPECT_EQ(cOMMParser::DetectFormat(kvn.data(), kvn.data() + kvn.size()), OMM_FORMAT_KVN);
+    EXPECT_EQ(cOMMParser::DetectFormat(xml.data(), xml.data() + xml.size()), OMM_FORMAT_XML);
+    EXPECT_EQ(cOMMParser::DetectFormat(csv.data(), csv.data() + csv.size()), OMM_FORMAT_CSV);
+
+    int formats[3] = { OMM_FORMAT_KVN, OMM_FORMAT_XML, OMM_FORMAT_CSV };
+    const std::string* texts[3] = { &kvn, &xml, &csv };
+    size_t counts[3] = { 1, 1, 2 };
+
+    for (int k = 0; k < 3; ++k) {
+        cOMMParser parser;
+        std::vector<stSatelliteElements> records;
+        EXPECT_EQ(parser.Parse(texts[k]->data(), texts[k]->data() + texts[k]->size(), records), (int)counts[k]);
+        EXPECT_EQ(parser.GetFormat(), formats[k]);
+        EXPECT_EQ(parser.GetFormatErrors(), 1 - (k == 1));
+        ASSERT_EQ(records.size(), counts[k]);
+
+        for (const stSatelliteElements& record : records) {
+            for (int i = 0; i < 6; ++i) EXPECT_EQ(record.pnElement1to6[i], expected[0].pnElement1to6[i]);
+            for (int i = 0; i < 3; ++i) EXPECT_FLOAT_EQ(record.pfElement7to18[i], expected[0].pfElement7to18[i]);
+            EXPECT_FLOAT_EQ(record.pfElement7to18[11], expected[0].pfElement7to18[11]);
+            EXPECT_NEAR(record.GetRefJD(), expected[0].GetRefJD(), 1.0e-8);
+        }
+        EXPECT_EQ(records[0].nSatelliteID, 25544);
+    }
+
+    // 超过 TLE 5 位的编号，年积日历元，带逗号的名称
+    cOMMParser parser;
+    stOMMRecord record;
+    const char* text = parser.NextRecord(csv.data(), csv.data() + csv.size(), record);
+    ASSERT_NE(text, nullptr);
+    EXPECT_EQ(std::string(record.pName, record.nNameLength), "ISS (ZARYA), MODULE");
+    EXPECT_EQ(std::string(record.pObjectID, record.nObjectIDLength), "1998-067A");
+    ASSERT_NE(parser.NextRecord(text, csv.data() + csv.size(), record), nullptr);
+    EXPECT_EQ(record.nSatelliteID, 270000123);
+
+    // 与 TLE 外推结果一致
+    std::vector<stSatelliteElements> omm;
+    cOMMParser kvnParser;
+    ASSERT_EQ(kvnParser.Parse(kvn.data(), kvn.data() + kvn.size(), omm), 1);
+    cTLE2PosVel fromTLE, fromOMM;
+    ASSERT_TRUE(fromTLE.SetOrbitalElements(expected[0]));
+    ASSERT_TRUE(fromOMM.SetOrbitalElements(omm[0]));
+    double pos1[3], vel1[3], pos2[3], vel2[3];
+    ASSERT_TRUE(fromTLE.ComputeECEFPosVel(2454730.0, pos1, vel1));
+    ASSERT_TRUE(fromOMM.ComputeECEFPosVel(2454730.0, pos2, vel2));
+    for (int i = 0; i < 3; ++i) EXPECT_NEAR(pos1[i], pos2[i], 1.0e-3);
+
+    // 压缩的 CSV 以小块流式读取
+    std::string plainFile = testing::TempDir() + "omm_stream.csv";
+    FILE* fp = fopen(plainFile.c_str(), "wb");
+    ASSERT_NE(fp, nullptr);
+    fputs(csv.c_str(), fp);
+    for (int n = 0; n < 200; ++n) fputs(csv.substr(csv.find("BIG")).c_str(), fp);
+    fclose(fp);
+
+    std::string command = "gzip -c \"" + plainFile + "\" > \"" + plainFile + ".gz\"";
+    if (system(command.c_str()) != 0) GTEST_SKIP() << "gzip not available";
+
+    std::vector<stSatelliteElements> mapped, streamed;
+    cOMMParser fileParser;
+    ASSERT_TRUE(fileParser.ReadAll(mapped, plainFile.c_str()));
+    EXPECT_EQ(mapped.size(), 202u);
+
+    cTLEStream stream;
+    stream.SetBlockSize(97);
+    ASSERT_TRUE(stream.Open((plainFile + ".gz").c_str()));
+    cOMMParser streamParser;
+    EXPECT_EQ(streamParser.Parse(stream, streamed), 202);
+    EXPECT_EQ(streamParser.GetFormatErrors(), 201);
+    EXPECT_TRUE(stream.Close());
+}
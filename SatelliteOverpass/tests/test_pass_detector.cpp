@@ -0,0 +1,110 @@
+/**
+ * @file test_pass_detector.cpp
+ * @brief 逐点采样过顶检测单元测试
+ *
+ * 测试cPassDetector与保存全部采样后扫描的结果一致。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "../TLE2PosVel.h"
+#include "../TopocentricSite.h"
+#include "../PassDetector.h"
+#include "test_fixtures.h"
+
+/**
+ * @test 测试逐点采样的过顶检测
+ * @brief 与保存全部采样后扫描的结果一致，中断的历元结束过顶，Finish()输出未结束的过顶
+ */
+TEST(PassDetectorTest, MatchesSampleScan)
+{
+    const double lat = 40.0 * M_PI / 180.0, lon = 116.0 * M_PI / 180.0;
+    double site[3];
+    stationECEF(lat, lon, site);
+    cTopocentricSite topo;
+    topo.SetStation(lat, lon, site);
+
+    cTLE2PosVel sat;
+    ASSERT_TRUE(sat.SetOrbitalElements(issTLE));
+    double refJD;
+    sat.GetOrbitalElementsRefJD(refJD);
+    stSGP4WorkArea work;
+
+    std::vector<double> jd, az, el;
+    for (int i = 0; i < 2 * 1440; ++i) {
+        double pos[3], vel[3], range;
+        ASSERT_TRUE(sat.ComputeECEFPosVel(refJD + i / 1440.0, pos, vel, work));
+        jd.push_back(refJD + i / 1440.0);
+        az.push_back(0.0);
+        el.push_back(0.0);
+        topo.ComputeAzElRange(pos, az.back(), el.back(), range);
+    }
+
+    // 参考：保存全部采样后扫描高于掩码的连续区间
+    const double mask = 10.0 * M_PI / 180.0;
+    std::vector<std::pair<size_t, size_t>> runs;
+    for (size_t i = 0; i < el.size(); ++i) {
+        if (el[i] > mask && (i == 0 || !(el[i - 1] > mask))) runs.push_back({ i, i });
+        if (el[i] > mask) runs.back().second = i;
+    }
+    ASSERT_GT(runs.size(), 2u);
+
+    std::vector<stVisiblePass> passes;
+    cPassDetector detector;
+    detector.SetIDs(25544, 3, 7);
+    detector.SetElevationMask(mask);
+    detector.SetCallback([&](const stVisiblePass& pass) { passes.push_back(pass); });
+
+    for (size_t i = 0; i < jd.size(); ++i) detector.AddSample(jd[i], az[i], el[i]);
+    EXPECT_FALSE(detector.IsInPass());
+    detector.Finish();
+
+    ASSERT_EQ(passes.size(), runs.size());
+    EXPECT_EQ(detector.GetPassNumber(), static_cast<int>(runs.size()));
+    for (size_t p = 0; p < runs.size(); ++p) {
+        const size_t rise = runs[p].first, set = runs[p].second;
+        const size_t tca = std::max_element(el.begin() + rise, el.begin() + set + 1) - el.begin();
+
+        EXPECT_EQ(passes[p].nSatID, 25544);
+        EXPECT_EQ(passes[p].nStationID, 3);
+        EXPECT_EQ(passes[p].nTrackingFacility, 7);
+        EXPECT_EQ(passes[p].tRise.dfJD, jd[rise]);
+        EXPECT_EQ(passes[p].tRise.dfAz, az[rise]);
+        EXPECT_EQ(passes[p].tSet.dfJD, jd[set]);
+        EXPECT_EQ(passes[p].tSet.dfAz, az[set]);
+        EXPECT_EQ(passes[p].tTCA.dfJD, jd[tca]);
+        EXPECT_EQ(passes[p].tTCA.dfEl, el[tca]);
+    }
+
+    // 过顶中间的中断历元把过顶分成两段；在过顶中结束采样，Finish()输出截断的过顶
+    const size_t rise = runs[0].first, set = runs[0].second;
+    ASSERT_GT(set - rise, 2u);
+    const size_t gap = rise + (set - rise) / 2;
+
+    passes.clear();
+    detector.Reset();
+    for (size_t i = 0; i <= runs[1].first + 1; ++i) {
+        if (i == gap) detector.AddGap(jd[i]);
+        else detector.AddSample(jd[i], az[i], el[i]);
+    }
+    EXPECT_TRUE(detector.IsInPass());
+    EXPECT_EQ(passes.size(), 2u);
+    detector.Finish();
+    EXPECT_FALSE(detector.IsInPass());
+
+    ASSERT_EQ(passes.size(), 3u);
+    EXPECT_EQ(detector.GetPassNumber(), 3);
+    EXPECT_EQ(passes[0].tRise.dfJD, jd[rise]);
+    EXPECT_EQ(passes[0].tSet.dfJD, jd[gap - 1]);
+    EXPECT_EQ(passes[1].tRise.dfJD, jd[gap + 1]);
+    EXPECT_EQ(passes[1].tSet.dfJD, jd[set]);
+    EXPECT_EQ(passes[2].tRise.dfJD, jd[runs[1].first]);
+    EXPECT_EQ(passes[2].tSet.dfJD, jd[runs[1].first + 1]);
+}
@@ -0,0 +1,163 @@
+/**
+ * @file test_pass_engine.cpp
+ * @brief 多星多站过顶预报单元测试
+ *
+ * 测试cPassEngine与逐星逐站cPassFinder搜索结果的一致性。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../TLE2PosVel.h"
+#include "../PassFinder.h"
+#include "../PassEngine.h"
+#include "../TLEParser.h"
+#include "test_fixtures.h"
+
+/**
+ * @test 测试多星多站过顶预报
+ * @brief 各站的过顶与单星单站搜索一致，结果与线程数无关，时间片的切分不丢失也不重复过顶
+ */
+TEST(PassEngineTest, MatchesPassFinder)
+{
+    const double latsDeg[] = { 32.656465, -33.9, 64.8 };
+    const double lonsDeg[] = { 110.745166, 18.4, -147.7 };
+
+    std::vector<stTrackStation> stations(3);
+    for (int s = 0; s < 3; ++s) {
+        stTrackStation& station = stations[s];
+        station = makeStation(latsDeg[s] * M_PI / 180.0, lonsDeg[s] * M_PI / 180.0);
+        station.nSiteNo = 100 + s;
+        station.nTrackingFacility = s;
+    }
+    const double mask = 5.0 * M_PI / 180.0;
+
+    // ISS按平近点角错开的几颗星，加上Molniya
+    std::vector<std::unique_ptr<cTLE2PosVel>> sats;
+    for (int k = 0; k < 4; ++k) {
+        double tle[10];
+        std::copy(issTLE, issTLE + 10, tle);
+        tle[0] = 30000 + k;
+        tle[8] = std::fmod(tle[8] + 90.0 * k, 360.0);
+        sats.emplace_back(new cTLE2PosVel);
+        ASSERT_TRUE(sats.back()->SetOrbitalElements(tle));
+    }
+    sats.emplace_back(new cTLE2PosVel);
+    ASSERT_TRUE(sats.back()->SetOrbitalElements(molniyaTLE));
+    std::vector<const cTLE2PosVel*> satPointers;
+    for (auto& sat : sats) satPointers.push_back(sat.get());
+    satPointers.push_back(nullptr);
+
+    double startJD;
+    sats[0]->GetOrbitalElementsRefJD(startJD);
+    const double endJD = startJD + 2.0;
+
+    cPassEngine engine;
+    engine.SetStations(stations);
+    engine.SetElevationMask(mask);
+    engine.SetTimeSlice(0.3);
+    engine.SetThreadNumber(1);
+    ASSERT_TRUE(engine.Predict(satPointers, startJD, endJD));
+    EXPECT_EQ(engine.GetWorkItemNumber(), 6 * 7);
+    EXPECT_EQ(engine.GetFailureNumber(), 0);
+
+    for (int s = 0; s < 3; ++s) {
+        const stTrackStation& station = stations[s];
+        const double site[3] = { station.dfECEFX, station.dfECEFY, station.dfECEFZ };
+        std::vector<stVisiblePass> expected;
+        for (auto& sat : sats) {
+            cPassFinder finder;
+            finder.SetStation(station.nSiteNo, station.dfLatitude, station.dfLongitude, site);
+            finder.SetElevationMask(mask);
+            ASSERT_TRUE(finder.FindPasses(*sat, startJD, endJD, expected));
+        }
+        std::sort(expected.begin(), expected.end(), [](const stVisiblePass& x, const stVisiblePass& y) {
+            return x.tRise.dfJD < y.tRise.dfJD;
+        });
+
+        const std::vector<stVisiblePass>& passes = engine.GetPasses(s);
+        ASSERT_FALSE(passes.empty());
+        ASSERT_EQ(passes.size(), expected.size());
+        for (size_t k = 0; k < passes.size(); ++k) {
+            EXPECT_EQ(passes[k].nSatID, expected[k].nSatID);
+            EXPECT_EQ(passes[k].nStationID, station.nSiteNo);
+            EXPECT_EQ(passes[k].nTrackingFacility, s);
+            EXPECT_NEAR(passes[k].tRise.dfJD, expected[k].tRise.dfJD, 0.1 / 86400.0);
+            EXPECT_NEAR(passes[k].tSet.dfJD, expected[k].tSet.dfJD, 0.1 / 86400.0);
+            // 高轨星过顶的最高点平缓，比较最大仰角
+            EXPECT_NEAR(passes[k].tTCA.dfEl, expected[k].tTCA.dfEl, 1.0e-5);
+            if (k > 0) {
+                EXPECT_LE(passes[k - 1].tRise.dfJD, passes[k].tRise.dfJD);
+            }
+        }
+    }
+
+    // 线程数不同，结果逐位相同；时间片不同，过顶一一对应
+    for (int threads : { 3, 0 }) {
+        cPassEngine other;
+        other.SetStations(stations);
+        other.SetElevationMask(mask);
+        other.SetTimeSlice(0.3);
+        other.SetThreadNumber(threads);
+        ASSERT_TRUE(other.Predict(satPointers, startJD, endJD));
+        EXPECT_EQ(other.GetEvaluationNumber(), engine.GetEvaluationNumber());
+        for (int s = 0; s < 3; ++s) {
+            ASSERT_EQ(other.GetPasses(s).size(), engine.GetPasses(s).size());
+            for (size_t k = 0; k < engine.GetPasses(s).size(); ++k) {
+                EXPECT_EQ(other.GetPasses(s)[k].nSatID, engine.GetPasses(s)[k].nSatID);
+                EXPECT_EQ(other.GetPasses(s)[k].tRise.dfJD, engine.GetPasses(s)[k].tRise.dfJD);
+                EXPECT_EQ(other.GetPasses(s)[k].tSet.dfJD, engine.GetPasses(s)[k].tSet.dfJD);
+            }
+        }
+    }
+
+    cPassEngine whole;
+    whole.SetStations(stations);
+    whole.SetElevationMask(mask);
+    whole.SetTimeSlice(10.0);
+    ASSERT_TRUE(whole.Predict(satPointers, startJD, endJD));
+    EXPECT_EQ(whole.GetWorkItemNumber(), 6);
+    for (int s = 0; s < 3; ++s) {
+        ASSERT_EQ(whole.GetPasses(s).size(), engine.GetPasses(s).size());
+        for (size_t k = 0; k < engine.GetPasses(s).size(); ++k) {
+            EXPECT_EQ(whole.GetPasses(s)[k].nSatID, engine.GetPasses(s)[k].nSatID);
+            EXPECT_NEAR(whole.GetPasses(s)[k].tRise.dfJD, engine.GetPasses(s)[k].tRise.dfJD, 0.1 / 86400.0);
+        }
+    }
+}
+
+/**
+ * @test 测试由解析的根数初始化的卫星
+ * @brief 过顶记录的卫星编号取自根数，与初始化的方式无关
+ */
+TEST(PassEngineTest, SatelliteIDFromElements)
+{
+    const std::string text = std::string(issLine1) + "\n" + issLine2 + "\n";
+
+    cTLEParser parser;
+    stTLERecord record;
+    stSatelliteElements elements;
+    ASSERT_NE(parser.NextRecord(text.data(), text.data() + text.size(), record), nullptr);
+    ASSERT_TRUE(parser.DecodeRecord(record, elements));
+
+    cTLE2PosVel sat;
+    ASSERT_TRUE(sat.SetOrbitalElements(elements));
+    double tle[10];
+    sat.GetTLE(tle);
+    EXPECT_EQ((int)tle[0], 25544);
+
+    std::vector<stTrackStation> stations(1, makeStation(32.656465 * M_PI / 180.0, 110.745166 * M_PI / 180.0));
+
+    cPassEngine engine;
+    engine.SetStations(stations);
+    ASSERT_TRUE(engine.Predict({ &sat }, elements.GetRefJD(), elements.GetRefJD() + 1.0));
+    ASSERT_FALSE(engine.GetPasses(0).empty());
+    for (const stVisiblePass& pass : engine.GetPasses(0)) EXPECT_EQ(pass.nSatID, 25544);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file test_satellite_registry.cpp
+ * @brief 卫星编号集合单元测试
+ *
+ * 测试cSatelliteRegistry的插入查询和Alpha-5编号的编码解码。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../TLE2PosVel.h"
+#include "../TLEParser.h"
+#include "../SatelliteRegistry.h"
+
+/**
+ * @test 测试卫星编号集合与Alpha-5编号
+ * @brief 位图与哈希表两部分的插入查询正确，Alpha-5编号可解码并被两种TLE读取器识别
+ */
+TEST(SatelliteRegistryTest, Alpha5)
+{
+    EXPECT_EQ(cSatelliteRegistry::DecodeCatalogNumber("25544"), 25544);
+    EXPECT_EQ(cSatelliteRegistry::DecodeCatalogNumber("  123"), 123);
+    EXPECT_EQ(cSatelliteRegistry::DecodeCatalogNumber("A0000"), 100000);
+    EXPECT_EQ(cSatelliteRegistry::DecodeCatalogNumber("J2345"), 182345);
+    EXPECT_EQ(cSatelliteRegistry::DecodeCatalogNumber("Z9999"), 339999);
+    EXPECT_EQ(cSatelliteRegistry::DecodeCatalogNumber("I0000"), 0);
+
+    char field[6] = { 0 };
+    ASSERT_TRUE(cSatelliteRegistry::EncodeCatalogNumber(182345, field));
+    EXPECT_STREQ(field, "J2345");
+    ASSERT_TRUE(cSatelliteRegistry::EncodeCatalogNumber(5544, field));
+    EXPECT_STREQ(field, "05544");
+    EXPECT_FALSE(cSatelliteRegistry::EncodeCatalogNumber(340000, field));
+
+    cSatelliteRegistry registry;
+    std::vector<int> ids;
+    for (int n = 1; n <= 3000; ++n) ids.push_back(n * 997 % 2000003 + (n % 3 == 0 ? 300000000 : 0));
+    for (int id : ids) EXPECT_TRUE(registry.Insert(id));
+    EXPECT_FALSE(registry.Insert(ids[5]));
+    EXPECT_FALSE(registry.Insert(0));
+    EXPECT_EQ(registry.GetCount(), (int)ids.size());
+    for (int id : ids) EXPECT_TRUE(registry.Contains(id));
+    EXPECT_FALSE(registry.Contains(12));
+    EXPECT_FALSE(registry.Contains(300000012));
+    registry.Clear();
+    EXPECT_FALSE(registry.Contains(ids[0]));
+
+    const char* line1 = "1 J2345U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2921";
+    const char* line2 = "2 J2345  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563531";
+    std::string text = std::string(line1) + "\n" + line2 + "\n";
+
+    cTLEParser parser;
+    std::vector<stSatelliteElements> elements;
+    ASSERT_EQ(parser.Parse(text.data(), text.data() + text.size(), elements), 1);
+    EXPECT_EQ(elements[0].nSatelliteID, 182345);
+
+    std::string fileName = testing::TempDir() + "tle_alpha5.txt";
+    FILE* fp = fopen(fileName.c_str(), "w");
+    ASSERT_NE(fp, nullptr);
+    fputs(text.c_str(), fp);
+    fclose(fp);
+
+    cTLE2PosVel legacy;
+    std::vector<stSatelliteIOE> ioes;
+    int requested[] = { 25544, 182345 };
+    ASSERT_TRUE(legacy.ReadAllTLE(ioes, fileName.c_str(), 2, requested));
+    std::remove(fileName.c_str());
+    ASSERT_EQ(ioes.size(), 1u);
+    EXPECT_EQ(ioes[0].nSatelliteID, 182345);
+}
@@ -0,0 +1,680 @@
+/**
+ * @file test_sgp4.cpp
+ * @brief SGP4轨道外推单元测试
+ *
+ * 测试cTLE2PosVel的可重入外推接口与传统接口的一致性。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TLE2PosVel.h"
+#include "../SGP4Batch.h"
+#include "../ChebyshevEphemeris.h"
+#include "../GreenwichSiderealTime.h"
+#include "../TimeGrid.h"
+#include "../PassFinder.h"
+#include "../VisibilityFilter.h"
+#include "test_fixtures.h"
+
+namespace
+{
+    // 近地点较低的卫星，数组格式同issTLE
+    double lowPerigeeTLE[10] = { 99999, 24, 140.5, 5.0e-4, 0.001, 51.6, 100.0, 90.0, 270.0, 16.25 };
+
+    double offsetsDays[] = { 0.0, 0.37, 1.2, 3.0, 7.5, 2.0, -0.6 };
+
+    void expectSameAsLegacy(double* pdfTLE)
+    {
+        cTLE2PosVel legacy;
+        cTLE2PosVel shared;
+        ASSERT_TRUE(legacy.SetOrbitalElements(pdfTLE));
+        ASSERT_TRUE(shared.SetOrbitalElements(pdfTLE));
+
+        double refJD;
+        shared.GetOrbitalElementsRefJD(refJD);
+
+        const cTLE2PosVel& propagator = shared;
+        stSGP4WorkArea work;
+
+        for (double offset : offsetsDays) {
+            double pos[3], vel[3], posRef[3], velRef[3];
+            ASSERT_TRUE(legacy.ComputeECEFPosVel(refJD + offset, posRef, velRef));
+            ASSERT_TRUE(propagator.ComputeECEFPosVel(refJD + offset, pos, vel, work));
+            for (int i = 0; i < 3; ++i) {
+                EXPECT_DOUBLE_EQ(pos[i], posRef[i]);
+                EXPECT_DOUBLE_EQ(vel[i], velRef[i]);
+            }
+        }
+    }
+}
+
+/**
+ * @test 测试近地轨道可重入外推
+ * @brief 可重入接口结果应与传统接口完全一致
+ */
+TEST(SGP4Test, ReentrantMatchesLegacyNearEarth)
+{
+    expectSameAsLegacy(issTLE);
+}
+
+/**
+ * @test 测试深空共振轨道可重入外推
+ * @brief 共振积分状态保存在工作区中，乱序时刻外推结果应与传统接口一致
+ */
+TEST(SGP4Test, ReentrantMatchesLegacyDeepSpace)
+{
+    expectSameAsLegacy(molniyaTLE);
+}
+
+/**
+ * @test 测试未初始化的外推器
+ * @brief 未设置根数时可重入接口应返回false
+ */
+TEST(SGP4Test, ReentrantRequiresInitialisation)
+{
+    const cTLE2PosVel propagator;
+    stSGP4WorkArea work;
+    double pos[3], vel[3];
+
+    EXPECT_FALSE(propagator.IsInitialised());
+    EXPECT_FALSE(propagator.ComputeInertialPosVel(2460000.5, pos, vel, work));
+}
+
+/**
+ * @test 测试多线程共享外推器
+ * @brief 多个线程各自持有工作区，共享同一外推器，结果应与单线程一致
+ */
+TEST(SGP4Test, SharedPropagatorAcrossThreads)
+{
+    cTLE2PosVel shared;
+    ASSERT_TRUE(shared.SetOrbitalElements(molniyaTLE));
+
+    double refJD;
+    shared.GetOrbitalElementsRefJD(refJD);
+
+    constexpr int threadCount = 4;
+    constexpr int stepCount = 2000;
+
+    std::vector<double> expected(stepCount * 3);
+    {
+        stSGP4WorkArea work;
+        double vel[3];
+        for (int k = 0; k < stepCount; ++k) {
+            ASSERT_TRUE(shared.ComputeInertialPosVel(refJD + k / 1440.0, &expected[k * 3], vel, work));
+        }
+    }
+
+    std::vector<std::vector<double>> results(threadCount, std::vector<double>(stepCount * 3));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            const cTLE2PosVel& propagator = shared;
+            stSGP4WorkArea work;
+            double vel[3];
+            for (int k = 0; k < stepCount; ++k) {
+                propagator.ComputeInertialPosVel(refJD + k / 1440.0, &results[t][k * 3], vel, work);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (int t = 0; t < threadCount; ++t) {
+        for (int i = 0; i < stepCount * 3; ++i) {
+            EXPECT_DOUBLE_EQ(results[t][i], expected[i]);
+        }
+    }
+}
+
+/**
+ * @test 测试批量外推
+ * @brief 近地卫星走SoA批量内核，深空卫星走标量路径，结果应与逐星外推一致
+ */
+TEST(SGP4Test, BatchMatchesScalar)
+{
+    double* tles[] = { issTLE, molniyaTLE, lowPerigeeTLE };
+
+    // 数量不是通道数的整数倍，覆盖最后一个不满的块
+    std::vector<cTLE2PosVel> sats(3 * SGP4_BATCH_LANES + 2);
+    cSGP4Batch batch;
+    for (size_t i = 0; i < sats.size(); ++i) {
+        double tle[10];
+        for (int k = 0; k < 10; ++k) tle[k] = tles[i % 3][k];
+        tle[8] += 7.0 * i;
+        ASSERT_TRUE(sats[i].SetOrbitalElements(tle));
+        sats[i].SetComputePositionOnly(false);
+        EXPECT_EQ(batch.AddSatellite(sats[i]), static_cast<int>(i));
+    }
+    EXPECT_EQ(batch.GetSatelliteNumber(), static_cast<int>(sats.size()));
+    EXPECT_EQ(batch.GetDeepSpaceNumber(), static_cast<int>((sats.size() + 1) / 3));
+
+    double refJD;
+    sats[0].GetOrbitalElementsRefJD(refJD);
+
+    for (double offset : offsetsDays) {
+        std::vector<double> pos(3 * sats.size()), vel(3 * sats.size());
+        std::unique_ptr<bool[]> valid(new bool[sats.size()]);
+        ASSERT_TRUE(batch.ComputeECEFPosVel(refJD + offset, pos.data(), vel.data(), valid.get()));
+
+        for (size_t i = 0; i < sats.size(); ++i) {
+            EXPECT_TRUE(valid[i]);
+            double posRef[3], velRef[3];
+            stSGP4WorkArea work;
+            ASSERT_TRUE(sats[i].ComputeECEFPosVel(refJD + offset, posRef, velRef, work));
+            for (int k = 0; k < 3; ++k) {
+                EXPECT_NEAR(pos[3 * i + k], posRef[k], 1.0e-3);
+                EXPECT_NEAR(vel[3 * i + k], velRef[k], 1.0e-6);
+            }
+        }
+    }
+}
+
+/**
+ * @test 测试单精度筛选模式误差范围
+ * @brief 单精度位置与双精度结果在1、3、7天的差值应小于文档给出的20米，与时段无关
+ */
+TEST(SGP4Test, FloatScreeningWithinEnvelope)
+{
+    double* tles[] = { issTLE, lowPerigeeTLE, molniyaTLE };
+
+    // 覆盖不同高度、偏心率和倾角的近地轨道，深空卫星走双精度路径
+    std::vector<cTLE2PosVel> sats(2 * 2 * SGP4_BATCH_LANES + 3);
+    for (size_t i = 0; i < sats.size(); ++i) {
+        double tle[10];
+        for (int k = 0; k < 10; ++k) tle[k] = tles[i % 3][k];
+        if (i % 3 != 2) {
+            tle[4] = 0.002 * i;
+            tle[5] = 5.0 + 5.0 * i;
+            tle[9] -= 0.1 * i;
+        }
+        tle[8] += 11.0 * i;
+        ASSERT_TRUE(sats[i].SetOrbitalElements(tle));
+    }
+
+    // 随机近地轨道：近地点高度300-2000 km，偏心率0-0.2，任意倾角，BSTAR 0-5e-4
+    std::mt19937 rng(20261016);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const size_t fixedCount = sats.size();
+    sats.resize(fixedCount + 256);
+    for (size_t i = fixedCount; i < sats.size(); ++i) {
+        const double perigee = 6378.137 + 300.0 + 1700.0 * uniform(rng);
+        double ecc = 0.2 * uniform(rng);
+        double meanMotion = 86400.0 / (2.0 * M_PI * std::sqrt(std::pow(perigee / (1.0 - ecc), 3) / 398600.4418));
+        if (meanMotion < 6.4) {
+            // 周期超过225分钟为深空轨道，改为圆轨道
+            ecc = 0.0;
+            meanMotion = 86400.0 / (2.0 * M_PI * std::sqrt(std::pow(perigee, 3) / 398600.4418));
+        }
+        double tle[10] = { static_cast<double>(40000 + i), 24, 140.5, 5.0e-4 * uniform(rng), ecc,
+                           180.0 * uniform(rng), 360.0 * uniform(rng), 360.0 * uniform(rng),
+                           360.0 * uniform(rng), meanMotion };
+        ASSERT_TRUE(sats[i].SetOrbitalElements(tle));
+    }
+
+    cSGP4Batch batch;
+    for (auto& sat : sats) batch.AddSatellite(sat);
+
+    double refJD;
+    sats[0].GetOrbitalElementsRefJD(refJD);
+
+    // SGP4Batch.cpp中记录的误差上限20 m，不随时段增长
+    const double bound = 20.0;
+    for (double days : { 1.0, 3.0, 7.0 }) {
+        double maxError = 0.0;
+        for (double t = days - 0.5; t <= days; t += 0.01) {
+            std::vector<double> pos(3 * sats.size()), vel(3 * sats.size());
+            std::vector<float> posFloat(3 * sats.size());
+            std::unique_ptr<bool[]> valid(new bool[sats.size()]);
+            ASSERT_TRUE(batch.ComputeECEFPosVel(refJD + t, pos.data(), vel.data()));
+            ASSERT_TRUE(batch.ComputeECEFPositionFloat(refJD + t, posFloat.data(), valid.get()));
+
+            for (size_t i = 0; i < sats.size(); ++i) {
+                EXPECT_TRUE(valid[i]);
+                double error = 0.0;
+                for (int k = 0; k < 3; ++k) {
+                    double d = pos[3 * i + k] - posFloat[3 * i + k];
+                    error += d * d;
+                }
+                maxError = std::max(maxError, std::sqrt(error));
+            }
+        }
+        EXPECT_LT(maxError, bound) << days << " days";
+    }
+}
+
+/**
+ * @test 测试单星时间序列外推
+ * @brief 通道按时间展开的序列外推结果应与逐历元外推一致
+ */
+TEST(SGP4Test, SeriesMatchesScalar)
+{
+    for (double* tle : { issTLE, molniyaTLE, lowPerigeeTLE }) {
+        cTLE2PosVel sat;
+        ASSERT_TRUE(sat.SetOrbitalElements(tle));
+        sat.SetComputePositionOnly(false);
+
+        double refJD;
+        sat.GetOrbitalElementsRefJD(refJD);
+
+        // 历元数不是通道数的整数倍
+        std::vector<double> epochs;
+        for (int k = 0; k < 1440 + 3; ++k) epochs.push_back(refJD + 0.25 + k / 1440.0);
+
+        std::vector<double> pos(3 * epochs.size()), vel(3 * epochs.size());
+        std::unique_ptr<bool[]> valid(new bool[epochs.size()]);
+        cSGP4Batch batch;
+        ASSERT_TRUE(batch.ComputeECEFPosVelSeries(sat, static_cast<int>(epochs.size()), epochs.data(),
+                                                  pos.data(), vel.data(), valid.get()));
+
+        stSGP4WorkArea work;
+        for (size_t n = 0; n < epochs.size(); ++n) {
+            EXPECT_TRUE(valid[n]);
+            double posRef[3], velRef[3];
+            ASSERT_TRUE(sat.ComputeECEFPosVel(epochs[n], posRef, velRef, work));
+            for (int k = 0; k < 3; ++k) {
+                EXPECT_NEAR(pos[3 * n + k], posRef[k], 1.0e-3);
+                EXPECT_NEAR(vel[3 * n + k], velRef[k], 1.0e-6);
+            }
+        }
+    }
+}
+
+/**
+ * @test 测试批量格林尼治恒星时
+ * @brief 数组形式的GST计算应与逐个计算一致
+ */
+TEST(SGP4Test, GSTArrayMatchesScalar)
+{
+    std::vector<double> epochs;
+    for (int k = 0; k < 100; ++k) epochs.push_back(2460450.0 + k * 0.137);
+
+    std::vector<double> gst(epochs.size());
+    cGreenwichST::ComputeGST(static_cast<int>(epochs.size()), epochs.data(), gst.data());
+
+    for (size_t n = 0; n < epochs.size(); ++n) {
+        EXPECT_NEAR(gst[n], cGreenwichST::ComputeGST(epochs[n]), 1.0e-12);
+    }
+}
+
+/**
+ * @test 测试共享地球自转时间网格
+ * @brief 使用网格旋转的ECEF结果应与逐次计算恒星时的结果一致，且逆变换可还原惯性系
+ */
+TEST(SGP4Test, TimeGridMatchesScalarRotation)
+{
+    cTLE2PosVel sat;
+    ASSERT_TRUE(sat.SetOrbitalElements(issTLE));
+    double refJD;
+    sat.GetOrbitalElementsRefJD(refJD);
+
+    cTimeGrid grid;
+    ASSERT_TRUE(grid.SetEpochs(refJD, 1.0 / 1440.0, 200));
+    EXPECT_EQ(grid.GetEpochNumber(), 200);
+    EXPECT_FALSE(cTimeGrid().SetEpochs(0, grid.GetJD()));
+
+    std::vector<double> positions(3 * 200), velocities(3 * 200);
+    cSGP4Batch batch;
+    ASSERT_TRUE(batch.ComputeECEFPosVelSeries(sat, grid, positions.data(), velocities.data()));
+
+    stSGP4WorkArea work;
+    for (int n = 0; n < grid.GetEpochNumber(); ++n) {
+        double pos[3], vel[3], posRef[3], velRef[3];
+        ASSERT_TRUE(sat.ComputeECEFPosVel(grid, n, pos, vel, work));
+        ASSERT_TRUE(sat.ComputeECEFPosVel(grid.GetJD(n), posRef, velRef, work));
+        for (int k = 0; k < 3; ++k) {
+            EXPECT_NEAR(pos[k], posRef[k], 1.0e-6);
+            EXPECT_NEAR(vel[k], velRef[k], 1.0e-9);
+            EXPECT_NEAR(positions[3 * n + k], posRef[k], 1.0e-3);
+            EXPECT_NEAR(velocities[3 * n + k], velRef[k], 1.0e-6);
+        }
+
+        double posInertial[3], velInertial[3];
+        ASSERT_TRUE(sat.ComputeInertialPosVel(grid.GetJD(n), posInertial, velInertial, work));
+        grid.FromECEFToInertial(n, pos, vel);
+        for (int k = 0; k < 3; ++k) {
+            EXPECT_NEAR(pos[k], posInertial[k], 1.0e-6);
+            EXPECT_NEAR(vel[k], velInertial[k], 1.0e-9);
+        }
+    }
+
+    double pos[3], vel[3];
+    EXPECT_FALSE(sat.ComputeECEFPosVel(grid, 200, pos, vel, work));
+
+    // 空的时间网格与空的历元数组一样，不做外推并返回true
+    EXPECT_TRUE(batch.ComputeECEFPosVelSeries(sat, cTimeGrid(), positions.data(), velocities.data()));
+    EXPECT_TRUE(batch.ComputeECEFPosVelSeries(sat, 0, grid.GetJD(), positions.data(), velocities.data()));
+    EXPECT_TRUE(batch.ComputeECEFPosVelSeries(sat, 0, nullptr, positions.data(), velocities.data()));
+    EXPECT_FALSE(batch.ComputeECEFPosVelSeries(sat, -1, grid.GetJD(), positions.data(), velocities.data()));
+}
+
+/**
+ * @test 测试仅位置外推变体
+ * @brief 各轨道类型的仅位置变体应给出与完整变体相同的位置，且可随时切换
+ */
+TEST(SGP4Test, PositionOnlyVariantMatchesFull)
+{
+    for (double* tle : { issTLE, molniyaTLE, lowPerigeeTLE }) {
+        cTLE2PosVel full, posOnly;
+        ASSERT_TRUE(full.SetOrbitalElements(tle));
+        posOnly.SetComputePositionOnly(true);
+        ASSERT_TRUE(posOnly.SetOrbitalElements(tle));
+        full.SetComputePositionOnly(false);
+
+        double refJD;
+        full.GetOrbitalElementsRefJD(refJD);
+
+        stSGP4WorkArea workFull, workPos;
+        for (double offset : offsetsDays) {
+            double pos[3], vel[3], posRef[3], velRef[3];
+            ASSERT_TRUE(full.ComputeInertialPosVel(refJD + offset, posRef, velRef, workFull));
+            ASSERT_TRUE(posOnly.ComputeInertialPosVel(refJD + offset, pos, vel, workPos));
+            for (int i = 0; i < 3; ++i) {
+                EXPECT_DOUBLE_EQ(pos[i], posRef[i]);
+            }
+        }
+
+        // 切换回完整变体后速度也应一致
+        posOnly.SetComputePositionOnly(false);
+        stSGP4WorkArea workA, workB;
+        double pos[3], vel[3], posRef[3], velRef[3];
+        ASSERT_TRUE(full.ComputeInertialPosVel(refJD + 0.5, posRef, velRef, workA));
+        ASSERT_TRUE(posOnly.ComputeInertialPosVel(refJD + 0.5, pos, vel, workB));
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_DOUBLE_EQ(vel[i], velRef[i]);
+        }
+    }
+}
+
+/**
+ * @test 测试深空共振积分检查点
+ * @brief 乱序查询的结果应与全新外推器从历元积分的结果完全一致，与查询顺序无关
+ */
+TEST(SGP4Test, ResonanceIndependentOfQueryOrder)
+{
+    cTLE2PosVel shared;
+    ASSERT_TRUE(shared.SetOrbitalElements(molniyaTLE));
+    shared.SetComputePositionOnly(false);
+
+    double refJD;
+    shared.GetOrbitalElementsRefJD(refJD);
+
+    // 覆盖检查点范围内外、历元前后
+    double offsets[] = { 12.3, 2.0, 6.9, -0.6, 0.01, 30.5, -9.2, 7.0, 1.5 };
+
+    stSGP4WorkArea work;
+    for (double offset : offsets) {
+        double pos[3], vel[3], posRef[3], velRef[3];
+        ASSERT_TRUE(shared.ComputeInertialPosVel(refJD + offset, pos, vel, work));
+
+        cTLE2PosVel fresh;
+        ASSERT_TRUE(fresh.SetOrbitalElements(molniyaTLE));
+        fresh.SetComputePositionOnly(false);
+        ASSERT_TRUE(fresh.ComputeInertialPosVel(refJD + offset, posRef, velRef));
+
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_DOUBLE_EQ(pos[i], posRef[i]);
+            EXPECT_DOUBLE_EQ(vel[i], velRef[i]);
+        }
+    }
+}
+
+/**
+ * @test 测试扩展检查点范围
+ * @brief 扩展检查点只减少积分步数，不改变外推结果；工作区可从外推器中取出
+ */
+TEST(SGP4Test, ResonanceCheckpointsExtended)
+{
+    cTLE2PosVel standard, extended;
+    ASSERT_TRUE(standard.SetOrbitalElements(molniyaTLE));
+    ASSERT_TRUE(extended.SetOrbitalElements(molniyaTLE));
+    standard.SetComputePositionOnly(false);
+    extended.SetComputePositionOnly(false);
+    EXPECT_TRUE(extended.BuildResonanceCheckpoints(30, 60));
+
+    double refJD;
+    standard.GetOrbitalElementsRefJD(refJD);
+
+    for (double offset : { 45.25, -20.5, 3.0 }) {
+        double pos[3], vel[3], posRef[3], velRef[3];
+        ASSERT_TRUE(standard.ComputeInertialPosVel(refJD + offset, posRef, velRef));
+        ASSERT_TRUE(extended.ComputeInertialPosVel(refJD + offset, pos, vel));
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_DOUBLE_EQ(pos[i], posRef[i]);
+        }
+    }
+
+    // 非共振轨道没有检查点
+    cTLE2PosVel nearEarth;
+    ASSERT_TRUE(nearEarth.SetOrbitalElements(issTLE));
+    EXPECT_FALSE(nearEarth.BuildResonanceCheckpoints(1, 1));
+
+    // 非可重入接口的积分状态可以取出并交给另一个外推器
+    stSGP4WorkArea saved = standard.GetWorkArea();
+    EXPECT_NE(saved.dfATIME, 0.0);
+    extended.SetWorkArea(saved);
+    EXPECT_DOUBLE_EQ(extended.GetWorkArea().dfXLI, saved.dfXLI);
+}
+
+/**
+ * @test 测试切比雪夫星历拟合精度
+ * @brief 任意时刻的星历值与SGP4的差值应在拟合误差量级内，且不超过容差
+ */
+TEST(SGP4Test, ChebyshevEphemerisMatchesSGP4)
+{
+    for (double* tle : { issTLE, molniyaTLE }) {
+        for (int frame : { EPHEMERIS_ECEF, EPHEMERIS_TEME }) {
+            cTLE2PosVel sat;
+            ASSERT_TRUE(sat.SetOrbitalElements(tle));
+            double refJD;
+            sat.GetOrbitalElementsRefJD(refJD);
+
+            cChebyshevEphemeris ephemeris;
+            ASSERT_TRUE(ephemeris.Build(sat, refJD, refJD + 1.0, frame));
+            EXPECT_EQ(ephemeris.GetNORADID(), static_cast<int>(tle[0]));
+            EXPECT_TRUE(ephemeris.HasVelocity());
+            EXPECT_GT(ephemeris.GetSegmentNumber(), 0);
+
+            double maxPosError, maxVelError;
+            ephemeris.GetFitError(maxPosError, maxVelError);
+            EXPECT_LE(maxPosError, 0.01);
+
+            stSGP4WorkArea work;
+            for (double t = 0.0; t <= 1.0; t += 0.00731) {
+                double pos[3], vel[3], posRef[3], velRef[3];
+                ASSERT_TRUE(ephemeris.ComputePosVel(refJD + t, pos, vel));
+                if (frame == EPHEMERIS_ECEF) {
+                    ASSERT_TRUE(sat.ComputeECEFPosVel(refJD + t, posRef, velRef, work));
+                } else {
+                    ASSERT_TRUE(sat.ComputeInertialPosVel(refJD + t, posRef, velRef, work));
+                }
+                for (int k = 0; k < 3; ++k) {
+                    EXPECT_NEAR(pos[k], posRef[k], 0.02);
+                    EXPECT_NEAR(vel[k], velRef[k], 1.0e-4);
+                }
+            }
+
+            double pos[3], vel[3];
+            EXPECT_FALSE(ephemeris.ComputePosVel(refJD - 0.01, pos, vel));
+            EXPECT_FALSE(ephemeris.ComputePos(refJD + 1.01, pos));
+        }
+    }
+}
+
+/**
+ * @test 测试切比雪夫星历的保存与加载
+ * @brief 加载后的星历应与原星历逐位一致
+ */
+TEST(SGP4Test, ChebyshevEphemerisSaveLoad)
+{
+    cTLE2PosVel sat;
+    ASSERT_TRUE(sat.SetOrbitalElements(issTLE));
+    sat.SetComputePositionOnly(true);
+    double refJD;
+    sat.GetOrbitalElementsRefJD(refJD);
+
+    cChebyshevEphemeris ephemeris;
+    ASSERT_TRUE(ephemeris.Build(sat, refJD, refJD + 0.3));
+    EXPECT_FALSE(ephemeris.HasVelocity());
+
+    std::string fileName = testing::TempDir() + "ephemeris_25544.cheb";
+    ASSERT_TRUE(ephemeris.Save(fileName.c_str()));
+
+    cChebyshevEphemeris loaded;
+    ASSERT_TRUE(loaded.Load(fileName.c_str()));
+    std::remove(fileName.c_str());
+
+    EXPECT_EQ(loaded.GetSegmentNumber(), ephemeris.GetSegmentNumber());
+    EXPECT_EQ(loaded.GetFrame(), EPHEMERIS_ECEF);
+    EXPECT_FALSE(loaded.HasVelocity());
+
+    for (double t = 0.0; t <= 0.3; t += 0.011) {
+        double pos[3], posLoaded[3], vel[3];
+        ASSERT_TRUE(ephemeris.ComputePos(refJD + t, pos));
+        ASSERT_TRUE(loaded.ComputePos(refJD + t, posLoaded));
+        EXPECT_FALSE(loaded.ComputePosVel(refJD + t, posLoaded, vel));
+        for (int k = 0; k < 3; ++k) EXPECT_EQ(pos[k], posLoaded[k]);
+    }
+
+    EXPECT_FALSE(loaded.Load("no_such_ephemeris.cheb"));
+    EXPECT_FALSE(loaded.IsBuilt());
+}
+
+/**
+ * @test 测试过顶求根
+ * @brief 升起、落下时刻应与1秒步长的逐点判断一致，且外推次数不到1分钟步长的五分之一
+ */
+TEST(SGP4Test, PassFinderMatchesDenseSampling)
+{
+    const double lat = 32.656465 * M_PI / 180.0, lon = 110.745166 * M_PI / 180.0;
+    double site[3];
+    stationECEF(lat, lon, site);
+    const double mask = 5.0 * M_PI / 180.0;
+
+    for (double* tle : { issTLE, molniyaTLE }) {
+        cTLE2PosVel sat;
+        ASSERT_TRUE(sat.SetOrbitalElements(tle));
+        double refJD;
+        sat.GetOrbitalElementsRefJD(refJD);
+
+        cPassFinder finder;
+        finder.SetStation(7, lat, lon, site);
+        finder.SetElevationMask(mask);
+        std::vector<stVisiblePass> passes;
+        ASSERT_TRUE(finder.FindPasses(sat, refJD, refJD + 2.0, passes));
+        EXPECT_LT(finder.GetEvaluationNumber(), 2 * 1440 / 5);
+
+        // 1秒步长逐点判断的升起、落下时刻
+        std::vector<double> rises, sets;
+        stSGP4WorkArea work;
+        bool above = false;
+        for (int i = 0; i <= 2 * 86400; ++i) {
+            double jd = refJD + i / 86400.0, pos[3], vel[3];
+            ASSERT_TRUE(sat.ComputeECEFPosVel(jd, pos, vel, work));
+            double dx = pos[0] - site[0], dy = pos[1] - site[1], dz = pos[2] - site[2];
+            double up = std::cos(lon) * std::cos(lat) * dx + std::sin(lon) * std::cos(lat) * dy + std::sin(lat) * dz;
+            bool nowAbove = up / std::sqrt(dx * dx + dy * dy + dz * dz) >= std::sin(mask);
+            if (nowAbove && !above && i > 0) rises.push_back(jd);
+            if (!nowAbove && above) sets.push_back(jd);
+            above = nowAbove;
+        }
+
+        ASSERT_FALSE(sets.empty());
+        ASSERT_EQ(passes.size(), sets.size() + (above ? 1 : 0));
+        for (size_t k = 0; k < sets.size(); ++k) {
+            const stVisiblePass& pass = passes[k];
+            EXPECT_EQ(pass.nSatID, static_cast<int>(tle[0]));
+            EXPECT_EQ(pass.nStationID, 7);
+            EXPECT_NEAR(pass.tSet.dfJD, sets[k], 1.0 / 86400.0);
+            EXPECT_NEAR(pass.tSet.dfEl, mask, 1.0e-5);
+            EXPECT_GT(pass.tTCA.dfJD, pass.tRise.dfJD);
+            EXPECT_LT(pass.tTCA.dfJD, pass.tSet.dfJD);
+            EXPECT_GE(pass.tTCA.dfEl, mask);
+        }
+        for (size_t k = 0; k < rises.size(); ++k) {
+            size_t index = passes.size() - rises.size() + k;
+            EXPECT_NEAR(passes[index].tRise.dfJD, rises[k], 1.0 / 86400.0);
+        }
+    }
+}
+
+/**
+ * @test 测试几何预筛选的保守性
+ * @brief 被排除的历元上卫星都低于仰角掩码，预筛选前后的过顶结果一致
+ */
+TEST(SGP4Test, VisibilityFilterIsConservative)
+{
+    const double lats[] = { 32.656465, -60.0, 75.0 };
+    const double lon = 110.745166 * M_PI / 180.0;
+    const double mask = 5.0 * M_PI / 180.0;
+    double sunSyncTLE[10] = { 1, 24, 140.5, 1.0e-4, 0.01, 98.0, 10.0, 20.0, 30.0, 14.2 };
+
+    for (double* tle : { issTLE, molniyaTLE, sunSyncTLE }) {
+        for (double latDeg : lats) {
+            const double lat = latDeg * M_PI / 180.0;
+            const double site[3] = { 6378137.0 * std::cos(lat) * std::cos(lon),
+                                     6378137.0 * std::cos(lat) * std::sin(lon),
+                                     6356752.0 * std::sin(lat) };
+
+            cTLE2PosVel sat;
+            ASSERT_TRUE(sat.SetOrbitalElements(tle));
+            double refJD;
+            sat.GetOrbitalElementsRefJD(refJD);
+
+            cVisibilityFilter filter;
+            filter.SetStation(site);
+            filter.SetElevationMask(mask);
+
+            const int epochs = 2 * 2880;
+            std::vector<double> jd(epochs);
+            for (int n = 0; n < epochs; ++n) jd[n] = refJD + n * 30.0 / 86400.0;
+            std::unique_ptr<bool[]> candidate(new bool[epochs]);
+            int candidates = filter.SelectEpochs(sat, epochs, jd.data(), candidate.get());
+            EXPECT_EQ(filter.GetSavedPropagations(), epochs - candidates);
+
+            stSGP4WorkArea work;
+            for (int n = 0; n < epochs; ++n) {
+                if (candidate[n]) continue;
+                double pos[3], vel[3];
+                ASSERT_TRUE(sat.ComputeECEFPosVel(jd[n], pos, vel, work));
+                double dx = pos[0] - site[0], dy = pos[1] - site[1], dz = pos[2] - site[2];
+                double up = std::cos(lon) * std::cos(lat) * dx + std::sin(lon) * std::cos(lat) * dy + std::sin(lat) * dz;
+                EXPECT_LT(up / std::sqrt(dx * dx + dy * dy + dz * dz), std::sin(mask));
+            }
+
+            cPassFinder finder;
+            finder.SetStation(1, lat, lon, site);
+            finder.SetElevationMask(mask);
+            std::vector<stVisiblePass> filtered, unfiltered;
+            ASSERT_TRUE(finder.FindPasses(sat, refJD, refJD + 2.0, filtered));
+            finder.SetPreFilter(false);
+            ASSERT_TRUE(finder.FindPasses(sat, refJD, refJD + 2.0, unfiltered));
+            ASSERT_EQ(filtered.size(), unfiltered.size());
+            for (size_t k = 0; k < filtered.size(); ++k) {
+                EXPECT_NEAR(filtered[k].tRise.dfJD, unfiltered[k].tRise.dfJD, 0.05 / 86400.0);
+                EXPECT_NEAR(filtered[k].tSet.dfJD, unfiltered[k].tSet.dfJD, 0.05 / 86400.0);
+            }
+        }
+    }
+
+    // 低倾角卫星不可能出现在高纬度测站上空
+    double equatorialTLE[10] = { 2, 24, 140.5, 1.0e-4, 0.001, 5.0, 10.0, 20.0, 30.0, 15.0 };
+    cTLE2PosVel sat;
+    ASSERT_TRUE(sat.SetOrbitalElements(equatorialTLE));
+    const double site[3] = { 0.0, 3194419.0, 5500477.0 };
+    cVisibilityFilter filter;
+    filter.SetStation(site);
+    filter.SetElevationMask(mask);
+    EXPECT_FALSE(filter.CanBeVisible(sat));
+    EXPECT_EQ(filter.GetRejectedSatellites(), 1);
+}
+
@@ -0,0 +1,73 @@
+/**
+ * @file test_site_fan_out.cpp
+ * @brief 多站扇出计算单元测试
+ *
+ * 测试cSiteFanOut对所有测站的方位角、仰角、距离与逐站计算的一致性。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "../TLE2PosVel.h"
+#include "../SiteFanOut.h"
+#include "test_fixtures.h"
+
+/**
+ * @test 测试多站扇出计算
+ * @brief 一个卫星位置对所有测站的方位角、仰角、距离与逐站计算一致，测站数跨越分块边界
+ */
+TEST(SiteFanOutTest, MatchesPerStation)
+{
+    std::vector<stTrackStation> stations(11);
+    for (size_t s = 0; s < stations.size(); ++s) {
+        stations[s] = makeStation((-70.0 + 13.0 * s) * M_PI / 180.0, (-170.0 + 31.0 * s) * M_PI / 180.0);
+    }
+
+    cSiteFanOut fanOut;
+    fanOut.SetStations(stations);
+    ASSERT_EQ(fanOut.GetStationNumber(), 11);
+
+    cTLE2PosVel sat;
+    ASSERT_TRUE(sat.SetOrbitalElements(issTLE));
+    double refJD;
+    sat.GetOrbitalElementsRefJD(refJD);
+
+    const int states = 5;
+    std::vector<double> pos(3 * states);
+    stSGP4WorkArea work;
+    for (int k = 0; k < states; ++k) {
+        double vel[3];
+        ASSERT_TRUE(sat.ComputeECEFPosVel(refJD + k * 0.013, &pos[3 * k], vel, work));
+    }
+
+    std::vector<double> az(states * 11), el(states * 11), range(states * 11), sinEl(states * 11);
+    fanOut.ComputeAzElRange(states, pos.data(), az.data(), el.data(), range.data());
+    fanOut.ComputeSinElevation(states, pos.data(), sinEl.data());
+
+    for (int k = 0; k < states; ++k) {
+        for (size_t s = 0; s < stations.size(); ++s) {
+            const stTrackStation& station = stations[s];
+            const double lat = station.dfLatitude, lon = station.dfLongitude;
+            double dx = pos[3 * k] - station.dfECEFX, dy = pos[3 * k + 1] - station.dfECEFY,
+                   dz = pos[3 * k + 2] - station.dfECEFZ;
+            double east = -std::sin(lon) * dx + std::cos(lon) * dy;
+            double north = -std::cos(lon) * std::sin(lat) * dx - std::sin(lon) * std::sin(lat) * dy + std::cos(lat) * dz;
+            double up = std::cos(lon) * std::cos(lat) * dx + std::sin(lon) * std::cos(lat) * dy + std::sin(lat) * dz;
+            double r = std::sqrt(dx * dx + dy * dy + dz * dz);
+            double azRef = std::atan2(east, north);
+            if (azRef < 0.0) azRef += 2.0 * M_PI;
+
+            size_t index = k * stations.size() + s;
+            EXPECT_NEAR(range[index], r, 1.0e-6);
+            EXPECT_NEAR(el[index], std::asin(up / r), 1.0e-12);
+            EXPECT_NEAR(az[index], azRef, 1.0e-12);
+            EXPECT_NEAR(sinEl[index], up / r, 1.0e-15);
+            EXPECT_GE(az[index], 0.0);
+            EXPECT_LT(az[index], 2.0 * M_PI);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+/**
+ * @file test_tle_catalog.cpp
+ * @brief 二进制TLE目录单元测试
+ *
+ * 测试cTLECatalog的写入、打开和按NORAD编号查找。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../TLE2PosVel.h"
+#include "../TLECatalog.h"
+
+/**
+ * @test 测试二进制TLE目录
+ * @brief 按NORAD编号查找应返回最新历元的根数，外推结果与文本TLE一致
+ */
+TEST(TLECatalogTest, Lookup)
+{
+    std::vector<stSatelliteIOE> TLEData;
+    int ids[] = { 25544, 8195, 99999, 25544, 43013 };
+    double epochs[] = { 2460450.5, 2460450.5, 2460451.0, 2460452.25, 2460449.0 };
+    for (int n = 0; n < 5; ++n) {
+        double meanMotion = 15.5 - 0.1 * n;
+        stSatelliteIOE ioe;
+        ioe.nSatelliteID = ids[n];
+        ioe.SetRefJD(epochs[n]);
+        ioe.pnElement1to6[0] = (int)(meanMotion * 1.0e8);
+        ioe.pnElement1to6[1] = 7000;
+        ioe.pnElement1to6[2] = 5164000;
+        ioe.pnElement1to6[3] = 20000000;
+        ioe.pnElement1to6[4] = 5000000;
+        ioe.pnElement1to6[5] = 31000000;
+        ioe.pfElement7to18[0] = 1.0e-5f;
+        ioe.pfElement7to18[1] = 0.0f;
+        ioe.pfElement7to18[2] = 1.027e-4f;
+        ioe.pfElement7to18[11] = (float)(1.0 / meanMotion);
+        TLEData.push_back(ioe);
+    }
+
+    std::string fileName = testing::TempDir() + "catalog.tlec";
+    ASSERT_TRUE(cTLECatalog::Write(TLEData, fileName.c_str()));
+
+    cTLECatalog catalog;
+    ASSERT_TRUE(catalog.Open(fileName.c_str()));
+    EXPECT_EQ(catalog.GetSatelliteNumber(), 4);
+    EXPECT_EQ(catalog.GetRecordNumber(), 5);
+
+    int count;
+    const stCatalogRecord* records = catalog.Find(25544, count);
+    ASSERT_NE(records, nullptr);
+    ASSERT_EQ(count, 2);
+    EXPECT_LT(records[0].GetRefJD(), records[1].GetRefJD());
+    EXPECT_EQ(catalog.Find(12345, count), nullptr);
+    EXPECT_EQ(count, 0);
+
+    cTLE2PosVel fromCatalog, fromIOE;
+    ASSERT_TRUE(catalog.ReadTLE(25544, fromCatalog));
+    ASSERT_TRUE(fromIOE.SetOrbitalElements(TLEData[3]));
+    double pos[3], vel[3], posRef[3], velRef[3];
+    ASSERT_TRUE(fromCatalog.ComputeECEFPosVel(2460452.5, pos, vel));
+    ASSERT_TRUE(fromIOE.ComputeECEFPosVel(2460452.5, posRef, velRef));
+    for (int k = 0; k < 3; ++k) EXPECT_EQ(pos[k], posRef[k]);
+
+    catalog.Close();
+    EXPECT_FALSE(catalog.IsOpen());
+    EXPECT_FALSE(catalog.ReadTLE(25544, fromCatalog));
+
+    // 索引项越界、为空或编号不递增的目录不能打开，索引在"TLEC"和4个int的文件头之后
+    const long headerSize = 4 + 4 * (long)sizeof(int);
+    auto patchIndex = [&](int entry, int field, int value) {
+        FILE* fp = fopen(fileName.c_str(), "r+b");
+        if (fp == nullptr) return false;
+        int old;
+        long offset = headerSize + entry * (long)sizeof(stCatalogIndex) + field * (long)sizeof(int);
+        bool ok = fseek(fp, offset, SEEK_SET) == 0 && fread(&old, sizeof(int), 1, fp) == 1 &&
+                  fseek(fp, offset, SEEK_SET) == 0 && fwrite(&value, sizeof(int), 1, fp) == 1;
+        fclose(fp);
+        EXPECT_FALSE(catalog.Open(fileName.c_str())) << entry << " " << field << " " << value;
+
+        fp = fopen(fileName.c_str(), "r+b");
+        if (fp == nullptr) return false;
+        ok = ok && fseek(fp, offset, SEEK_SET) == 0 && fwrite(&old, sizeof(int), 1, fp) == 1;
+        fclose(fp);
+        return ok;
+    };
+    ASSERT_TRUE(patchIndex(3, 2, 1000));        // nCount超出记录数
+    ASSERT_TRUE(patchIndex(3, 1, 5));           // nFirst + nCount超出记录数
+    ASSERT_TRUE(patchIndex(0, 1, -1));          // nFirst为负
+    ASSERT_TRUE(patchIndex(1, 2, 0));           // nCount为0
+    ASSERT_TRUE(patchIndex(2, 0, 8195));        // 编号不递增
+    ASSERT_TRUE(catalog.Open(fileName.c_str()));
+    catalog.Close();
+
+    FILE* fp = fopen(fileName.c_str(), "r+b");
+    ASSERT_NE(fp, nullptr);
+    fputs("XXXX", fp);
+    fclose(fp);
+    EXPECT_FALSE(catalog.Open(fileName.c_str()));
+    std::remove(fileName.c_str());
+}
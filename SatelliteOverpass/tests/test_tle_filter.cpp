@@ -0,0 +1,103 @@
+/**
+ * @file test_tle_filter.cpp
+ * @brief TLE过滤条件单元测试
+ *
+ * 测试cTLEFilter在解析时下推的编号、根数和名称过滤。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "../TLEParser.h"
+#include "../TLEFilter.h"
+#include "../DateTimeZ.h"
+
+/**
+ * @test 测试解析时的谓词下推过滤
+ * @brief 过滤解析的结果应与完整解析后再筛选一致，被拒绝的记录计数正确
+ */
+TEST(TLEFilterTest, Pushdown)
+{
+    const char* line1 = "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+    const char* line2 = "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+
+    // 改写编号、历元年积日、倾角和平运动，重新计算校验和
+    std::string text;
+    for (int n = 0; n < 200; ++n) {
+        std::string first = line1, second = line2;
+        char field[16];
+        snprintf(field, sizeof(field), "%05d", 20000 + n);
+        first.replace(2, 5, field);
+        second.replace(2, 5, field);
+        snprintf(field, sizeof(field), "%03d", 200 + n % 100);
+        first.replace(20, 3, field);
+        snprintf(field, sizeof(field), "%8.4f", 30.0 + 0.5 * n);
+        second.replace(8, 8, field);
+        snprintf(field, sizeof(field), "%11.8f", 12.0 + 0.02 * n);
+        second.replace(52, 11, field);
+        for (std::string* line : { &first, &second }) {
+            int sum = 0;
+            for (int i = 0; i < 68; ++i) {
+                char c = (*line)[i];
+                if (c >= '0' && c <= '9') sum += c - '0';
+                else if (c == '-') sum += 1;
+            }
+            (*line)[68] = (char)('0' + sum % 10);
+        }
+        if (n % 2 == 0) text += (n % 4 == 0 ? "STARLINK-" : "ONEWEB-") + std::to_string(n) + "\n";
+        text += first + "\n" + second + "\n";
+    }
+
+    cTLEParser parser;
+    std::vector<stSatelliteElements> all;
+    ASSERT_EQ(parser.Parse(text.data(), text.data() + text.size(), all), 200);
+
+    int ids[] = { 20010, 20011, 20050, 20120, 20199, 25544 };
+    double refJD;
+    g_DateTimeZ.DateTime2JD(2008, 1, 0, 0, 0, 0.0, refJD);
+    refJD += 300.0;
+
+    cTLEFilter filter;
+    filter.SetIDs(6, ids);
+    filter.SetInclination(30.0, 90.0);
+    filter.SetMeanMotion(12.0, 15.0);
+    filter.SetEpochAge(refJD, 60.0);
+    filter.SetPerigeeApogee(6378137.0 + 250000.0, 6378137.0 + 5000000.0);
+
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < all.size(); ++i) {
+        const stSatelliteElements& e = all[i];
+        double sm = e.GetSemiMajor(), ecc = e.GetEccentricity();
+        double meanMotion = e.pnElement1to6[0] * 1.0e-8;
+        if (std::find(std::begin(ids), std::end(ids), e.nSatelliteID) != std::end(ids) &&
+            e.GetInclination() >= 30.0 && e.GetInclination() <= 90.0 &&
+            meanMotion >= 12.0 && meanMotion <= 15.0 && e.GetRefJD() >= refJD - 60.0 &&
+            sm * (1.0 - ecc) > 6378137.0 + 250000.0 && sm * (1.0 + ecc) < 6378137.0 + 5000000.0) {
+            expected.push_back(i);
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+
+    cTLEParser filtered;
+    std::vector<stSatelliteIOE> records;
+    ASSERT_EQ(filtered.Parse(text.data(), text.data() + text.size(), records, filter), (int)expected.size());
+    EXPECT_EQ(filtered.GetRecordNumber(), (int)expected.size());
+    EXPECT_EQ(filtered.GetRejectedNumber(), 200 - (int)expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(records[i].nSatelliteID, all[expected[i]].nSatelliteID);
+    }
+
+    cTLEFilter names;
+    EXPECT_FALSE(names.SetNamePattern("STARLINK-("));
+    ASSERT_TRUE(names.SetNamePattern("^STARLINK-"));
+    std::vector<stSatelliteElements> starlink;
+    EXPECT_EQ(parser.Parse(text.data(), text.data() + text.size(), starlink, names), 50);
+    for (const stSatelliteElements& e : starlink) EXPECT_EQ((e.nSatelliteID - 20000) % 4, 0);
+}
@@ -0,0 +1,86 @@
+/**
+ * @file test_tle_history.cpp
+ * @brief 历史TLE单元测试
+ *
+ * 测试cTLEHistory按时刻选择根数和外推器缓存。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../TLE2PosVel.h"
+#include "../TLECatalog.h"
+#include "../TLEHistory.h"
+
+/**
+ * @test 测试历史TLE选择与外推器缓存
+ * @brief 按时刻选择最近或之前最新的根数，缓存中的外推器不重复初始化
+ */
+TEST(TLEHistoryTest, Selection)
+{
+    std::vector<stSatelliteElements> elements;
+    double epochs[] = { 2460460.0, 2460450.0, 2460455.5 };
+    for (int n = 0; n < 4; ++n) {
+        stSatelliteElements e;
+        memset(&e, 0, sizeof(e));
+        e.nSatelliteID = n < 3 ? 25544 : 8195;
+        e.cElementType = 'T';
+        e.SetRefJD(n < 3 ? epochs[n] : 2460452.0);
+        e.pnElement1to6[0] = 1550000000 + n;
+        e.pnElement1to6[1] = 7000;
+        e.pnElement1to6[2] = 5164000;
+        e.pnElement1to6[3] = 20000000;
+        e.pnElement1to6[4] = 5000000;
+        e.pnElement1to6[5] = 31000000;
+        e.pfElement7to18[2] = 1.0e-4f;
+        e.pfElement7to18[11] = 1.0f / 15.5f;
+        elements.push_back(e);
+    }
+
+    cTLEHistory history;
+    history.Add(elements);
+    EXPECT_EQ(history.GetSatelliteNumber(), 2);
+    EXPECT_EQ(history.GetElementSetNumber(), 4);
+
+    auto epochOf = [](const stSatelliteElements* e) { return e == nullptr ? 0.0 : e->GetRefJD(); };
+    EXPECT_NEAR(epochOf(history.Select(25544, 2460440.0)), 2460450.0, 1e-6);
+    EXPECT_NEAR(epochOf(history.Select(25544, 2460452.0)), 2460450.0, 1e-6);
+    EXPECT_NEAR(epochOf(history.Select(25544, 2460454.0)), 2460455.5, 1e-6);
+    EXPECT_NEAR(epochOf(history.Select(25544, 2460470.0)), 2460460.0, 1e-6);
+    EXPECT_EQ(history.Select(25544, 2460440.0, TLE_SELECT_LATEST_BEFORE), nullptr);
+    EXPECT_NEAR(epochOf(history.Select(25544, 2460459.9, TLE_SELECT_LATEST_BEFORE)), 2460455.5, 1e-6);
+    EXPECT_NEAR(epochOf(history.Select(25544, 2460460.0, TLE_SELECT_LATEST_BEFORE)), 2460460.0, 1e-6);
+    EXPECT_EQ(history.Select(12345, 2460450.0), nullptr);
+
+    // 30天的预报来回使用三组根数，每组只初始化一次
+    for (int pass = 0; pass < 2; ++pass) {
+        for (double jd = 2460445.0; jd < 2460475.0; jd += 0.25) {
+            const cTLE2PosVel* sat = history.GetPropagator(25544, jd);
+            ASSERT_NE(sat, nullptr);
+            double refJD;
+            sat->GetOrbitalElementsRefJD(refJD);
+            EXPECT_NEAR(refJD, epochOf(history.Select(25544, jd)), 1e-6);
+        }
+    }
+    EXPECT_EQ(history.GetInitialisations(), 3);
+
+    history.SetCacheSize(1);
+    history.GetPropagator(25544, 2460450.0);
+    history.GetPropagator(8195, 2460450.0);
+    history.GetPropagator(25544, 2460450.0);
+    EXPECT_EQ(history.GetInitialisations(), 6);
+
+    std::string fileName = testing::TempDir() + "history.tlec";
+    ASSERT_TRUE(cTLECatalog::Write(elements, fileName.c_str()));
+    cTLEHistory loaded;
+    ASSERT_TRUE(loaded.ReadCatalog(fileName.c_str()));
+    std::remove(fileName.c_str());
+    EXPECT_EQ(loaded.GetElementSetNumber(), 4);
+    EXPECT_NEAR(epochOf(loaded.Select(25544, 2460454.0)), 2460455.5, 1e-6);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file test_tle_parser.cpp
+ * @brief TLE目录解析单元测试
+ *
+ * 测试cTLEParser的内存映射解析与传统读取函数的一致性，以及多线程分块解析。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../TLE2PosVel.h"
+#include "../TLEParser.h"
+
+/**
+ * @test 测试内存映射TLE解析
+ * @brief 解析结果应与传统ReadAllTLE一致，校验和错误的记录被跳过，支持名称行、注释和CRLF
+ */
+TEST(TLEParserTest, MatchesLegacyReader)
+{
+    const char* line1 = "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+    const char* line2 = "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+    const char* badLine2 = "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563538";
+
+    EXPECT_TRUE(cTLEParser::CheckSum(line1));
+    EXPECT_TRUE(cTLEParser::CheckSum(line2));
+    EXPECT_FALSE(cTLEParser::CheckSum(badLine2));
+    EXPECT_EQ(cTLEParser::DecodeInteger("  -123", 6), -123);
+    EXPECT_EQ(cTLEParser::DecodeDecimal(" -.00002182", 11), -0.00002182);
+    EXPECT_EQ(cTLEParser::DecodeFixedDecimal(" 51.6416", 3, 4), 51.6416);
+    EXPECT_DOUBLE_EQ(cTLEParser::DecodeExponential("-11606-4"), -0.11606e-4);
+
+    std::string legacyFile = testing::TempDir() + "tle_legacy.txt";
+    std::string catalogFile = testing::TempDir() + "tle_catalog.txt";
+
+    FILE* fp = fopen(legacyFile.c_str(), "w");
+    ASSERT_NE(fp, nullptr);
+    fprintf(fp, "%s\n%s\n", line1, line2);
+    fclose(fp);
+
+    fp = fopen(catalogFile.c_str(), "wb");
+    ASSERT_NE(fp, nullptr);
+    fprintf(fp, "# comment\r\nISS (ZARYA)             \r\n%s\r\n%s\r\n\r\n", line1, line2);
+    fprintf(fp, "%s\n%s\n", line1, badLine2);
+    fprintf(fp, "%s\n%s", line1, line2);
+    fclose(fp);
+
+    cTLE2PosVel legacy;
+    std::vector<stSatelliteIOE> expected;
+    ASSERT_TRUE(legacy.ReadAllTLE(expected, legacyFile.c_str()));
+    ASSERT_EQ(expected.size(), 1u);
+
+    cTLEParser parser;
+    std::vector<stSatelliteIOE> records;
+    ASSERT_TRUE(parser.ReadAllTLE(records, catalogFile.c_str()));
+    std::remove(legacyFile.c_str());
+    std::remove(catalogFile.c_str());
+
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(parser.GetRecordNumber(), 2);
+    EXPECT_EQ(parser.GetChecksumErrors(), 1);
+    EXPECT_EQ(parser.GetFormatErrors(), 0);
+
+    for (const stSatelliteIOE& record : records) {
+        EXPECT_EQ(record.nSatelliteID, expected[0].nSatelliteID);
+        EXPECT_EQ(record.nIntJD, expected[0].nIntJD);
+        EXPECT_EQ(record.nFractionJD, expected[0].nFractionJD);
+        for (int k = 0; k < 6; ++k) EXPECT_EQ(record.pnElement1to6[k], expected[0].pnElement1to6[k]);
+        for (int k = 0; k < 12; ++k) EXPECT_EQ(record.pfElement7to18[k], expected[0].pfElement7to18[k]);
+    }
+
+    stTLERecord view;
+    std::string text = std::string("ISS (ZARYA)\n") + line1 + "\n" + line2 + "\n";
+    ASSERT_NE(parser.NextRecord(text.data(), text.data() + text.size(), view), nullptr);
+    EXPECT_EQ(std::string(view.pName, view.nNameLength), "ISS (ZARYA)");
+
+    EXPECT_FALSE(parser.ReadAllTLE(records, "no_such_catalog.txt"));
+}
+
+/**
+ * @test 测试多线程分块解析
+ * @brief 分块多线程解析的记录、顺序和计数应与单线程解析一致
+ */
+TEST(TLEParserTest, ChunksMatchSerial)
+{
+    const char* line1 = "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+    const char* line2 = "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+
+    // 以第1行为模板改写编号和年积日，重新计算校验和
+    std::string text;
+    for (int n = 0; n < 500; ++n) {
+        std::string first = line1, second = line2;
+        char id[6];
+        snprintf(id, sizeof(id), "%05d", 10000 + n);
+        first.replace(2, 5, id);
+        second.replace(2, 5, id);
+        first[30] = (char)('0' + n % 10);
+        for (std::string* line : { &first, &second }) {
+            int sum = 0;
+            for (int i = 0; i < 68; ++i) {
+                char c = (*line)[i];
+                if (c >= '0' && c <= '9') sum += c - '0';
+                else if (c == '-') sum += 1;
+            }
+            (*line)[68] = (char)('0' + sum % 10);
+        }
+        if (n % 7 == 0) text += "# comment\n";
+        if (n % 3 == 0) text += "SAT " + std::to_string(n) + "\r\n";
+        if (n % 11 == 0) first[40] = first[40] == '1' ? '2' : '1';
+        text += first + "\n" + second + "\n";
+    }
+
+    cTLEParser serial;
+    std::vector<stSatelliteIOE> expected;
+    serial.Parse(text.data(), text.data() + text.size(), expected, true);
+    EXPECT_GT(serial.GetChecksumErrors(), 0);
+    EXPECT_EQ(serial.GetFormatErrors(), 0);
+
+    for (size_t chunkSize : { 100, 1000, 9000 }) {
+        cTLEParser parallel;
+        parallel.SetThreadNumber(4);
+        parallel.SetChunkSize(chunkSize);
+        std::vector<stSatelliteIOE> records;
+        EXPECT_EQ(parallel.Parse(text.data(), text.data() + text.size(), records, true), (int)expected.size());
+        EXPECT_EQ(parallel.GetRecordNumber(), serial.GetRecordNumber());
+        EXPECT_EQ(parallel.GetChecksumErrors(), serial.GetChecksumErrors());
+        EXPECT_EQ(parallel.GetFormatErrors(), 0);
+
+        ASSERT_EQ(records.size(), expected.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            EXPECT_EQ(records[i].nSatelliteID, expected[i].nSatelliteID);
+            EXPECT_EQ(records[i].GetRefJD(), expected[i].GetRefJD());
+        }
+    }
+}
@@ -0,0 +1,201 @@
+/**
+ * @file test_tle_stream.cpp
+ * @brief 流式TLE读取单元测试
+ *
+ * 测试cTLEStream对压缩目录的边解压边解析。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+#include "../TLE2PosVel.h"
+#include "../TLEParser.h"
+#include "../TLEStream.h"
+#include "test_fixtures.h"
+
+/**
+ * @test 测试压缩目录的流式读取
+ * @brief gzip 压缩的目录边解压边解析，块边界切断记录时结果与内存映射读取一致
+ */
+TEST(TLEStreamTest, Compressed)
+{
+    std::string plainFile = testing::TempDir() + "tle_stream.txt";
+    std::string gzipFile = plainFile + ".gz";
+
+    FILE* fp = fopen(plainFile.c_str(), "wb");
+    ASSERT_NE(fp, nullptr);
+    for (int i = 0; i < 300; ++i) {
+        if (i % 3 == 0) fprintf(fp, "OBJECT %d\r\n", i);
+        fputs(makeTLE(20000 + i, i % 360 + 0.5).c_str(), fp);
+    }
+    fclose(fp);
+
+    std::string command = "gzip -c \"" + plainFile + "\" > \"" + gzipFile + "\"";
+    if (system(command.c_str()) != 0) GTEST_SKIP() << "gzip not available";
+
+    EXPECT_TRUE(cTLEStream::IsStreamName(gzipFile.c_str()));
+    EXPECT_TRUE(cTLEStream::IsStreamName("-"));
+    EXPECT_FALSE(cTLEStream::IsStreamName(plainFile.c_str()));
+
+    cTLEParser parser;
+    std::vector<stSatelliteElements> expected, streamed, blocks;
+    ASSERT_TRUE(parser.ReadAllTLE(expected, plainFile.c_str()));
+    ASSERT_EQ(expected.size(), 300u);
+    ASSERT_TRUE(parser.ReadAllTLE(streamed, gzipFile.c_str()));
+
+    // 块小于一条记录，每条记录都被块边界切断
+    cTLEStream stream;
+    stream.SetBlockSize(100);
+    stream.SetBlockNumber(2);
+    ASSERT_TRUE(stream.Open(gzipFile.c_str()));
+    EXPECT_EQ(parser.Parse(stream, blocks), 300);
+    EXPECT_TRUE(stream.Close());
+
+    for (const std::vector<stSatelliteElements>* records : { &streamed, &blocks }) {
+        ASSERT_EQ(records->size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ((*records)[i].nSatelliteID, expected[i].nSatelliteID);
+            EXPECT_EQ((*records)[i].GetRefJD(), expected[i].GetRefJD());
+            EXPECT_EQ((*records)[i].pnElement1to6[5], expected[i].pnElement1to6[5]);
+        }
+    }
+
+    // 原读取函数同样接受压缩文件
+    cTLE2PosVel legacy;
+    std::vector<stSatelliteIOE> legacyPlain, legacyGzip;
+    ASSERT_TRUE(legacy.ReadAllTLE(legacyPlain, plainFile.c_str()));
+    ASSERT_TRUE(legacy.ReadAllTLE(legacyGzip, gzipFile.c_str()));
+    ASSERT_EQ(legacyGzip.size(), legacyPlain.size());
+    EXPECT_EQ(legacyGzip.back().Line3, legacyPlain.back().Line3);
+
+    EXPECT_FALSE(parser.ReadAllTLE(streamed, (testing::TempDir() + "no_such_catalog.txt.gz").c_str()));
+}
+
+/**
+ * @test 测试解压失败的报告
+ * @brief 截断的gzip文件和找不到的解压程序由Close()报告，不当作完整的目录
+ */
+TEST(TLEStreamTest, DecompressorErrors)
+{
+    std::string plainFile = testing::TempDir() + "tle_stream_errors.txt";
+    std::string gzipFile = plainFile + ".gz";
+    std::string truncatedFile = testing::TempDir() + "tle_stream_truncated.txt.gz";
+
+    FILE* fp = fopen(plainFile.c_str(), "wb");
+    ASSERT_NE(fp, nullptr);
+    for (int i = 0; i < 2000; ++i) fputs(makeTLE(20000 + i % 10000, i % 360 + 0.5).c_str(), fp);
+    fclose(fp);
+
+    std::string command = "gzip -c \"" + plainFile + "\" > \"" + gzipFile + "\"";
+    if (system(command.c_str()) != 0) GTEST_SKIP() << "gzip not available";
+
+    // 只保留压缩文件的前一半
+    std::vector<char> bytes;
+    fp = fopen(gzipFile.c_str(), "rb");
+    ASSERT_NE(fp, nullptr);
+    for (int c; (c = fgetc(fp)) != EOF;) bytes.push_back((char)c);
+    fclose(fp);
+    fp = fopen(truncatedFile.c_str(), "wb");
+    ASSERT_NE(fp, nullptr);
+    fwrite(bytes.data(), 1, bytes.size() / 2, fp);
+    fclose(fp);
+
+    cTLEStream stream;
+    ASSERT_TRUE(stream.Open(truncatedFile.c_str()));
+    cTLEParser parser;
+    std::vector<stSatelliteElements> records;
+    EXPECT_LT(parser.Parse(stream, records), 2000);
+    EXPECT_FALSE(stream.Close());
+    EXPECT_EQ(stream.GetError(), TLE_STREAM_ERROR_DECOMPRESSOR);
+
+    ASSERT_TRUE(stream.Open(gzipFile.c_str()));
+    EXPECT_EQ(parser.Parse(stream, records), 2000);
+    EXPECT_TRUE(stream.Close());
+    EXPECT_EQ(stream.GetError(), TLE_STREAM_ERROR_NONE);
+
+    // 原读取函数同样检查Close()的结果
+    cTLE2PosVel legacy;
+    std::vector<stSatelliteIOE> legacyRecords;
+    EXPECT_FALSE(legacy.ReadAllTLE(legacyRecords, truncatedFile.c_str()));
+    legacyRecords.clear();
+    EXPECT_TRUE(legacy.ReadAllTLE(legacyRecords, gzipFile.c_str()));
+    EXPECT_EQ(legacyRecords.size(), 2000u);
+    EXPECT_FALSE(legacy.ReadTLE(29999, const_cast<char*>(truncatedFile.c_str())));
+
+#ifndef _WIN32
+    // PATH中没有zstd
+    std::string zstdFile = testing::TempDir() + "tle_stream_errors.txt.zst";
+    fp = fopen(zstdFile.c_str(), "wb");
+    ASSERT_NE(fp, nullptr);
+    fputs("not compressed", fp);
+    fclose(fp);
+
+    const char* path = getenv("PATH");
+    std::string savedPath = path != nullptr ? path : "";
+    setenv("PATH", "", 1);
+    bool opened = stream.Open(zstdFile.c_str());
+    int count = opened ? parser.Parse(stream, records) : -1;
+    bool closed = stream.Close();
+    setenv("PATH", savedPath.c_str(), 1);
+
+    EXPECT_TRUE(opened);
+    EXPECT_EQ(count, 0);
+    EXPECT_FALSE(closed);
+    EXPECT_EQ(stream.GetError(), TLE_STREAM_ERROR_NO_DECOMPRESSOR);
+    std::remove(zstdFile.c_str());
+#endif
+
+    std::remove(plainFile.c_str());
+    std::remove(gzipFile.c_str());
+    std::remove(truncatedFile.c_str());
+}
+
+#ifndef _WIN32
+/**
+ * @test 测试命名管道的读取
+ * @brief 不是普通文件的输入按流读取，不进行内存映射
+ */
+TEST(TLEStreamTest, NamedPipe)
+{
+    std::string pipeFile = testing::TempDir() + "tle_stream_pipe";
+    std::remove(pipeFile.c_str());
+    if (mkfifo(pipeFile.c_str(), 0600) != 0) GTEST_SKIP() << "mkfifo not available";
+
+    EXPECT_TRUE(cTLEStream::IsStreamName(pipeFile.c_str()));
+
+    // 写端在另一个线程中打开，直到读端打开为止
+    auto writeCatalog = [&pipeFile]() {
+        FILE* fp = fopen(pipeFile.c_str(), "wb");
+        if (fp == nullptr) return;
+        for (int i = 0; i < 300; ++i) fputs(makeTLE(20000 + i, i % 360 + 0.5).c_str(), fp);
+        fclose(fp);
+    };
+
+    cTLEParser parser;
+    std::vector<stSatelliteElements> records;
+    std::thread writer(writeCatalog);
+    EXPECT_TRUE(parser.ReadAllTLE(records, pipeFile.c_str()));
+    writer.join();
+    ASSERT_EQ(records.size(), 300u);
+    EXPECT_EQ(records.back().nSatelliteID, 20299);
+
+    cTLE2PosVel legacy;
+    std::vector<stSatelliteIOE> legacyRecords;
+    writer = std::thread(writeCatalog);
+    EXPECT_TRUE(legacy.ReadAllTLE(legacyRecords, pipeFile.c_str()));
+    writer.join();
+    EXPECT_EQ(legacyRecords.size(), 300u);
+
+    std::remove(pipeFile.c_str());
+}
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file test_topocentric_site.cpp
+ * @brief 测站地平坐标单元测试
+ *
+ * 测试cTopocentricSite缓存的地平坐标系与直接计算的一致性。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include "../TLE2PosVel.h"
+#include "../TopocentricSite.h"
+#include "test_fixtures.h"
+
+/**
+ * @test 测试测站地平坐标缓存
+ * @brief 方位角、仰角、距离与逐次计算三角函数的结果一致，掩码判断与反正弦比较一致
+ */
+TEST(TopocentricSiteTest, MatchesDirect)
+{
+    const double lat = -33.9 * M_PI / 180.0, lon = 151.2 * M_PI / 180.0;
+    double site[3];
+    stationECEF(lat, lon, site);
+
+    cTopocentricSite topo;
+    topo.SetStation(lat, lon, site);
+
+    cTLE2PosVel sat;
+    ASSERT_TRUE(sat.SetOrbitalElements(issTLE));
+    double refJD;
+    sat.GetOrbitalElementsRefJD(refJD);
+    stSGP4WorkArea work;
+
+    int above[3] = { 0, 0, 0 };
+    for (double maskDeg : { -2.0, 0.0, 10.0 }) {
+        const double mask = maskDeg * M_PI / 180.0;
+        topo.SetElevationMask(mask);
+        EXPECT_DOUBLE_EQ(topo.GetSinMask(), std::sin(mask));
+
+        for (int i = 0; i < 1440; ++i) {
+            double pos[3], vel[3];
+            ASSERT_TRUE(sat.ComputeECEFPosVel(refJD + i / 1440.0, pos, vel, work));
+
+            double dx = pos[0] - site[0], dy = pos[1] - site[1], dz = pos[2] - site[2];
+            double east = -std::sin(lon) * dx + std::cos(lon) * dy;
+            double north = -std::cos(lon) * std::sin(lat) * dx - std::sin(lon) * std::sin(lat) * dy + std::cos(lat) * dz;
+            double up = std::cos(lon) * std::cos(lat) * dx + std::sin(lon) * std::cos(lat) * dy + std::sin(lat) * dz;
+            double r = std::sqrt(dx * dx + dy * dy + dz * dz);
+            double azRef = std::atan2(east, north);
+            if (azRef < 0.0) azRef += 2.0 * M_PI;
+
+            double az, el, range;
+            topo.ComputeAzElRange(pos, az, el, range);
+            EXPECT_NEAR(az, azRef, 1.0e-12);
+            EXPECT_NEAR(el, std::asin(up / r), 1.0e-12);
+            EXPECT_NEAR(range, r, 1.0e-6);
+
+            double sinRange;
+            EXPECT_NEAR(topo.ComputeSinElevation(pos, sinRange), up / r, 1.0e-15);
+
+            bool isAbove = topo.IsAboveMask(pos);
+            EXPECT_EQ(isAbove, el >= mask);
+            if (isAbove) above[maskDeg < 0.0 ? 0 : maskDeg == 0.0 ? 1 : 2]++;
+        }
+    }
+    EXPECT_GT(above[0], above[1]);
+    EXPECT_GT(above[1], above[2]);
+    EXPECT_GT(above[2], 0);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file test_work_stealing_pool.cpp
+ * @brief 工作窃取线程池单元测试
+ *
+ * 测试cWorkStealingPool的任务分发、线程复用和异常传递。
+ *
+ * @author kerwin_zhang
+ * @version 2.0.0
+ * @date 2026-10-16
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../WorkStealingPool.h"
+
+/**
+ * @test 测试多次运行的任务分发
+ * @brief 每次运行的任务各执行一次，工作线程在运行之间保留，不重新创建
+ */
+TEST(WorkStealingPoolTest, ReusesWorkers)
+{
+    cWorkStealingPool pool;
+    pool.SetThreadNumber(4);
+
+    std::mutex mutex;
+    std::set<std::thread::id> threadIDs;
+
+    for (int run = 0; run < 50; ++run) {
+        const int tasks = 1 + run % 7 * 30;
+        std::vector<int> counts(tasks, 0);
+        pool.Run(tasks, [&](int task, int thread) {
+            EXPECT_GE(thread, 0);
+            EXPECT_LT(thread, 4);
+            ++counts[task];
+            std::lock_guard<std::mutex> lock(mutex);
+            threadIDs.insert(std::this_thread::get_id());
+        });
+        for (int task = 0; task < tasks; ++task) EXPECT_EQ(counts[task], 1);
+    }
+
+    // 调用线程加上3个工作线程
+    EXPECT_LE(threadIDs.size(), 4u);
+
+    // 改变线程数后重新启动工作线程
+    pool.SetThreadNumber(2);
+    std::atomic<int> done(0);
+    pool.Run(100, [&](int, int thread) {
+        EXPECT_LT(thread, 2);
+        ++done;
+    });
+    EXPECT_EQ(done, 100);
+}
+
+/**
+ * @test 测试任务异常的传递
+ * @brief 任务抛出的异常在调用线程由Run()重新抛出，线程池随后仍可使用
+ */
+TEST(WorkStealingPoolTest, RethrowsTaskException)
+{
+    cWorkStealingPool pool;
+    pool.SetThreadNumber(3);
+
+    std::atomic<int> started(0);
+    EXPECT_THROW(pool.Run(1000, [&](int task, int) {
+        ++started;
+        if (task == 500) throw std::runtime_error("task failed");
+    }), std::runtime_error);
+    EXPECT_LE(started, 1000);
+
+    std::atomic<int> done(0);
+    pool.Run(1000, [&](int, int) { ++done; });
+    EXPECT_EQ(done, 1000);
+}